@@ -1,143 +1,118 @@
 #include "raylib.h"
+#include "src/common/scene.h"
 #include "src/hangman/hangman.h"
 #include "src/tetris/tetris.h"
+#include "src/tetris/versus.h"
 #include "src/invaders/invaders.h"
 
 // Menu items
 typedef enum {
     MENU_HANGMAN,
+    MENU_EVIL_HANGMAN,
     MENU_TETRIS,
+    MENU_VERSUS,
     MENU_INVADERS,
     MENU_EXIT,
     MENU_ITEMS_COUNT
 } MenuItem;
 
-// Main game loop function
-void RunGame(void) {
-    const int screenWidth = 800;
-    const int screenHeight = 600;
+static const int screenWidth = 800;
+static const int screenHeight = 600;
+
+static const char* menuItems[MENU_ITEMS_COUNT] = {
+    "Hangman Game",
+    "Evil Hangman",
+    "Tetris",
+    "Tetris Versus",
+    "Space Invaders",
+    "Exit"
+};
+
+// Scene entered from each menu item
+static const Scene *menuScenes[MENU_ITEMS_COUNT] = {
+    &hangmanScene,
+    &evilHangmanScene,
+    &tetrisScene,
+    &versusScene,
+    &invadersScene,
+    NULL
+};
+
+static int selectedItem = 0;
+
+// Render at the display's refresh rate; the games simulate in fixed ticks
+// (see fixed_step.h), so gameplay does not depend on this
+static void SetRenderRate(void) {
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS(refreshRate > 0 ? refreshRate : 60);
+}
+
+static void MenuUpdate(void *state, SceneStack *stack) {
+    // Update
+    if (IsKeyPressed(KEY_UP)) {
+        selectedItem--;
+        if (selectedItem < 0) selectedItem = MENU_ITEMS_COUNT - 1;
+    }
+    else if (IsKeyPressed(KEY_DOWN)) {
+        selectedItem++;
+        if (selectedItem >= MENU_ITEMS_COUNT) selectedItem = 0;
+    }
     
-    // Initialize window
-    InitWindow(screenWidth, screenHeight, "Game Collection");
-    SetTargetFPS(60);
+    if (IsKeyPressed(KEY_ENTER)) {
+        if (menuScenes[selectedItem]) {
+            ScenePush(stack, menuScenes[selectedItem]);
+        } else {
+            ScenePop(stack);
+        }
+    }
+    else if (IsKeyPressed(KEY_ESCAPE)) {
+        ScenePop(stack);
+    }
+}
+
+static void MenuDraw(void *state, float alpha) {
+    ClearBackground(RAYWHITE);
     
-    int selectedItem = 0;
-    const char* menuItems[MENU_ITEMS_COUNT] = {
-        "Hangman Game",
-        "Tetris",
-        "Space Invaders",
-        "Exit"
-    };
+    // Draw menu title
+    DrawText("GAME COLLECTION", 
+            screenWidth/2 - MeasureText("GAME COLLECTION", 40)/2, 
+            100, 40, BLACK);
     
-    // Main game loop
-    while (!WindowShouldClose()) {
-        // Update
-        if (IsKeyPressed(KEY_UP)) {
-            selectedItem--;
-            if (selectedItem < 0) selectedItem = MENU_ITEMS_COUNT - 1;
-        }
-        else if (IsKeyPressed(KEY_DOWN)) {
-            selectedItem++;
-            if (selectedItem >= MENU_ITEMS_COUNT) selectedItem = 0;
-        }
-        
-        if (IsKeyPressed(KEY_ENTER)) {
-            switch (selectedItem) {
-                case MENU_HANGMAN: {
-                    // Create a new window for Hangman
-                    int gameWidth = 800;
-                    int gameHeight = 600;
-                    
-                    // Close the menu window
-                    CloseWindow();
-                    
-                    // Initialize Hangman window
-                    InitWindow(gameWidth, gameHeight, "Hangman");
-                    SetTargetFPS(60);
-                    
-                    PlayHangman();
-                    
-                    // After Hangman is done, close its window and reopen menu
-                    CloseWindow();
-                    InitWindow(screenWidth, screenHeight, "Game Collection");
-                    SetTargetFPS(60);
-                    break;
-                }
-                case MENU_TETRIS: {
-                    // Create a new window for Tetris
-                    int gameWidth = 800;
-                    int gameHeight = 700;
-                    
-                    // Close the menu window
-                    CloseWindow();
-                    
-                    // Initialize Tetris window
-                    InitWindow(gameWidth, gameHeight, "Tetris");
-                    SetTargetFPS(60);
-                    
-                    PlayTetris();
-                    
-                    // After Tetris is done, close its window and reopen menu
-                    CloseWindow();
-                    InitWindow(screenWidth, screenHeight, "Game Collection");
-                    SetTargetFPS(60);
-                    break;
-                }
-                case MENU_INVADERS: {
-                    // Create a new window for Space Invaders
-                    int gameWidth = 800;
-                    int gameHeight = 600;
-                    
-                    // Close the menu window
-                    CloseWindow();
-                    
-                    // Initialize Space Invaders window
-                    InitWindow(gameWidth, gameHeight, "Space Invaders");
-                    SetTargetFPS(60);
-                    
-                    PlayInvaders();
-                    
-                    // After Space Invaders is done, close its window and reopen menu
-                    CloseWindow();
-                    InitWindow(screenWidth, screenHeight, "Game Collection");
-                    SetTargetFPS(60);
-                    break;
-                }
-                case MENU_EXIT:
-                    return;
-            }
-        }
+    // Draw menu items
+    for (int i = 0; i < MENU_ITEMS_COUNT; i++) {
+        Color color = (i == selectedItem) ? BLUE : DARKGRAY;
+        int textWidth = MeasureText(menuItems[i], 30);
+        int yPos = 200 + i * 50;
         
-        // Draw
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        
-        // Draw menu title
-        DrawText("GAME COLLECTION", 
-                screenWidth/2 - MeasureText("GAME COLLECTION", 40)/2, 
-                100, 40, BLACK);
-        
-        // Draw menu items
-        for (int i = 0; i < MENU_ITEMS_COUNT; i++) {
-            Color color = (i == selectedItem) ? BLUE : DARKGRAY;
-            int textWidth = MeasureText(menuItems[i], 30);
-            int yPos = 200 + i * 50;
-            
-            if (i == selectedItem) {
-                DrawText(">", screenWidth/2 - textWidth/2 - 30, yPos, 30, color);
-            }
-            
-            DrawText(menuItems[i], screenWidth/2 - textWidth/2, yPos, 30, color);
+        if (i == selectedItem) {
+            DrawText(">", screenWidth/2 - textWidth/2 - 30, yPos, 30, color);
         }
         
-        // Draw instructions
-        DrawText("Use UP/DOWN arrows to navigate, ENTER to select", 
-                screenWidth/2 - MeasureText("Use UP/DOWN arrows to navigate, ENTER to select", 20)/2, 
-                500, 20, GRAY);
-        
-        EndDrawing();
+        DrawText(menuItems[i], screenWidth/2 - textWidth/2, yPos, 30, color);
     }
     
+    // Draw instructions
+    DrawText("Use UP/DOWN arrows to navigate, ENTER to select", 
+            screenWidth/2 - MeasureText("Use UP/DOWN arrows to navigate, ENTER to select", 20)/2, 
+            500, 20, GRAY);
+}
+
+static const Scene menuScene = {
+    .title = "Game Collection",
+    .width = 800,
+    .height = 600,
+    .update = MenuUpdate,
+    .draw = MenuDraw
+};
+
+// Main game loop function
+void RunGame(void) {
+    // One window and GL context for the whole session; the scenes share it
+    InitWindow(screenWidth, screenHeight, "Game Collection");
+    SetRenderRate();
+    
+    SceneRun(&menuScene);
+    
     CloseWindow();
 }
 
@@ -0,0 +1,38 @@
+#ifndef FIXED_STEP_H
+#define FIXED_STEP_H
+
+// Fixed-timestep accumulator. Rendering runs at whatever rate the display
+// allows; the simulation always advances in whole ticks of the same length,
+// so gameplay does not depend on frame rate and replays stay exact.
+
+typedef struct {
+    float step;         // seconds per tick
+    double accumulator; // unsimulated time carried between frames
+    int maxTicks;       // cap per frame so a long stall does not spiral
+} FixedStep;
+
+static inline void FixedStepInit(FixedStep *clock, int tickRate, int maxTicks) {
+    clock->step = 1.0f / tickRate;
+    clock->accumulator = 0.0;
+    clock->maxTicks = maxTicks;
+}
+
+// Add one frame's elapsed time; returns how many ticks to simulate now
+static inline int FixedStepAdvance(FixedStep *clock, float frameTime) {
+    clock->accumulator += frameTime;
+    int ticks = (int)(clock->accumulator / clock->step);
+    if (ticks > clock->maxTicks) {
+        // Drop the backlog instead of trying to catch up
+        ticks = clock->maxTicks;
+        clock->accumulator = ticks * (double)clock->step;
+    }
+    clock->accumulator -= ticks * (double)clock->step;
+    return ticks;
+}
+
+// How far the render time is between the last tick and the next, 0..1
+static inline float FixedStepAlpha(const FixedStep *clock) {
+    return (float)(clock->accumulator / clock->step);
+}
+
+#endif // FIXED_STEP_H
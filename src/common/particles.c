@@ -0,0 +1,32 @@
+#include "particles.h"
+#include "rlgl.h"
+
+// Untextured quads on the default white texture, so every particle goes
+// into the same batch; alpha fades out over the particle's life
+void DrawParticles(const ParticlePool *pool, float size) {
+    if (pool->count == 0) return;
+    
+    rlSetTexture(rlGetTextureIdDefault());
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < pool->count; i++) {
+        uint32_t color = pool->color[i];
+        float alpha = pool->life[i] * pool->fade[i];
+        float x = pool->x[i], y = pool->y[i];
+        
+        // Starts a new batch when the current one is full
+        rlCheckRenderBatchLimit(4);
+        rlColor4ub((unsigned char)color, (unsigned char)(color >> 8), (unsigned char)(color >> 16),
+                   (unsigned char)((color >> 24) * (alpha < 1.0f ? alpha : 1.0f)));
+        rlTexCoord2f(0.5f, 0.5f); rlVertex2f(x, y);
+        rlTexCoord2f(0.5f, 0.5f); rlVertex2f(x, y + size);
+        rlTexCoord2f(0.5f, 0.5f); rlVertex2f(x + size, y + size);
+        rlTexCoord2f(0.5f, 0.5f); rlVertex2f(x + size, y);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void DrawParticleCounter(const ParticlePool *pool, int x, int y) {
+    DrawText(TextFormat("PARTICLES: %d  UPDATE: %.2f ms", pool->count, pool->updateNs / 1e6), x, y, 10, GRAY);
+}
@@ -0,0 +1,18 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "raylib.h"
+#include "particles_core.h"
+
+// Pack a raylib color the way ParticlePool stores it
+static inline uint32_t ParticleColor(Color color) {
+    return (uint32_t)color.r | (uint32_t)color.g << 8 | (uint32_t)color.b << 16 | (uint32_t)color.a << 24;
+}
+
+// Function declarations
+void DrawParticles(const ParticlePool *pool, float size);  // one batched quad stream
+
+// Live particle count and last update time, drawn at (x, y)
+void DrawParticleCounter(const ParticlePool *pool, int x, int y);
+
+#endif // PARTICLES_H
@@ -0,0 +1,118 @@
+#include "particles_core.h"
+#include "simd.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+bool ParticlesInit(ParticlePool *pool, int capacity, uint64_t seed) {
+    memset(pool, 0, sizeof(*pool));
+    pool->capacity = SIMD_PAD(capacity > 0 ? capacity : PARTICLES_DEFAULT_CAPACITY);
+    
+    // One block: six float arrays, then the colors
+    size_t floatBytes = (size_t)pool->capacity * sizeof(float);
+    char *block = calloc(1, 6 * floatBytes + (size_t)pool->capacity * sizeof(uint32_t));
+    if (!block) {
+        pool->capacity = 0;
+        return false;
+    }
+    pool->x = (float *)block;
+    pool->y = (float *)(block + floatBytes);
+    pool->vx = (float *)(block + 2 * floatBytes);
+    pool->vy = (float *)(block + 3 * floatBytes);
+    pool->life = (float *)(block + 4 * floatBytes);
+    pool->fade = (float *)(block + 5 * floatBytes);
+    pool->color = (uint32_t *)(block + 6 * floatBytes);
+    pool->gravity = 300.0f;
+    pool->drag = 0.4f;
+    RngSeed(&pool->rng, seed);
+    return true;
+}
+
+void ParticlesFree(ParticlePool *pool) {
+    free(pool->x);
+    memset(pool, 0, sizeof(*pool));
+}
+
+void ParticlesClear(ParticlePool *pool) {
+    pool->count = 0;
+}
+
+int ParticlesBurst(ParticlePool *pool, float x, float y, float width, float height,
+                   int count, float speed, float lifetime, uint32_t color) {
+    int room = pool->capacity - pool->count;
+    if (count > room) {
+        pool->dropped += (uint64_t)(count - room);
+        count = room;
+    }
+    
+    GameRng *rng = &pool->rng;
+    for (int n = 0; n < count; n++) {
+        int i = pool->count++;
+        float angle = RngFloat(rng) * 6.2831853f;
+        float v = speed * (0.25f + 0.75f * RngFloat(rng));
+        float life = lifetime * (0.75f + 0.5f * RngFloat(rng));
+        pool->x[i] = x + RngFloat(rng) * width;
+        pool->y[i] = y + RngFloat(rng) * height;
+        pool->vx[i] = cosf(angle) * v;
+        pool->vy[i] = sinf(angle) * v;
+        pool->life[i] = life;
+        pool->fade[i] = 1.0f / life;
+        pool->color[i] = color;
+    }
+    pool->spawned += (uint64_t)count;
+    return count;
+}
+
+// Move the last live particle into slot i
+static void RemoveParticle(ParticlePool *pool, int i) {
+    int last = --pool->count;
+    pool->x[i] = pool->x[last];
+    pool->y[i] = pool->y[last];
+    pool->vx[i] = pool->vx[last];
+    pool->vy[i] = pool->vy[last];
+    pool->life[i] = pool->life[last];
+    pool->fade[i] = pool->fade[last];
+    pool->color[i] = pool->color[last];
+}
+
+void ParticlesUpdate(ParticlePool *pool, float dt) {
+    uint64_t start = NowNs();
+    
+    // Integrate whole lanes; the padding past count holds stale particles,
+    // which are harmless to move
+    SimdFloat step = SimdSet1(dt);
+    SimdFloat damp = SimdSet1(powf(pool->drag, dt));
+    SimdFloat fall = SimdSet1(pool->gravity * dt);
+    int end = SIMD_PAD(pool->count);
+    for (int i = 0; i < end; i += SIMD_WIDTH) {
+        SimdFloat vx = SimdMul(SimdLoad(pool->vx + i), damp);
+        SimdFloat vy = SimdAdd(SimdMul(SimdLoad(pool->vy + i), damp), fall);
+        SimdStore(pool->vx + i, vx);
+        SimdStore(pool->vy + i, vy);
+        SimdStore(pool->x + i, SimdAdd(SimdLoad(pool->x + i), SimdMul(vx, step)));
+        SimdStore(pool->y + i, SimdAdd(SimdLoad(pool->y + i), SimdMul(vy, step)));
+        SimdStore(pool->life + i, SimdSub(SimdLoad(pool->life + i), step));
+    }
+    
+    // Remove the dead, skipping lanes where every particle still lives
+    const unsigned int allAlive = (1u << SIMD_WIDTH) - 1;
+    SimdFloat zero = SimdSet1(0.0f);
+    for (int i = 0; i < pool->count;) {
+        if (i + SIMD_WIDTH <= pool->count && SimdLessMask(zero, SimdLoad(pool->life + i)) == allAlive) {
+            i += SIMD_WIDTH;
+        } else if (pool->life[i] > 0.0f) {
+            i++;
+        } else {
+            RemoveParticle(pool, i);
+        }
+    }
+    
+    pool->updateNs = NowNs() - start;
+}
@@ -0,0 +1,49 @@
+#ifndef PARTICLES_CORE_H
+#define PARTICLES_CORE_H
+
+// Raylib-free particle pool for effects. Particles are stored as parallel
+// arrays allocated once by ParticlesInit; live particles are packed at
+// [0, count) and a dead one is replaced by the last, like the invaders'
+// ProjectilePool, so spawning is count++ and never allocates. A burst that
+// does not fit is cut short rather than grown.
+//
+// ParticlesUpdate integrates position, velocity and lifetime SIMD_WIDTH
+// particles at a time and times itself, so games can show what the
+// effects cost. Particles are cosmetic: they never feed back into a
+// simulation and use their own random stream.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "rng.h"
+
+#define PARTICLES_DEFAULT_CAPACITY 131072   // room for the 100k live budget
+
+typedef struct {
+    int count;
+    int capacity;
+    float *x, *y;
+    float *vx, *vy;     // pixels per second
+    float *life;        // seconds left; dead at 0
+    float *fade;        // 1 / lifetime, so alpha is life * fade
+    uint32_t *color;    // RGBA, red in the low byte
+    float gravity;      // pixels per second squared, downwards
+    float drag;         // fraction of velocity kept per second
+    GameRng rng;
+    uint64_t spawned;   // particles spawned so far
+    uint64_t dropped;   // spawns refused because the pool was full
+    uint64_t updateNs;  // duration of the last ParticlesUpdate
+} ParticlePool;
+
+// Function declarations
+bool ParticlesInit(ParticlePool *pool, int capacity, uint64_t seed);  // capacity 0 for the default
+void ParticlesFree(ParticlePool *pool);
+void ParticlesClear(ParticlePool *pool);
+
+// Spawn up to count particles from random points in the rectangle, flying
+// out at up to speed pixels per second and living about lifetime seconds;
+// returns how many fit
+int ParticlesBurst(ParticlePool *pool, float x, float y, float width, float height,
+                   int count, float speed, float lifetime, uint32_t color);
+void ParticlesUpdate(ParticlePool *pool, float dt);
+
+#endif // PARTICLES_CORE_H
@@ -0,0 +1,119 @@
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *phaseNames[PROFILE_PHASE_COUNT] = {
+    [PROFILE_FRAME] = "frame",
+    [PROFILE_UPDATE] = "update",
+    [PROFILE_TICK] = "tick",
+    [PROFILE_DRAW] = "draw",
+    [PROFILE_PRESENT] = "present"
+};
+
+uint64_t ProfilerNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void ProfilerInit(Profiler *profiler) {
+    memset(profiler, 0, sizeof(*profiler));
+    profiler->origin = ProfilerNow();
+    profiler->label = "";
+    // Without the event ring the profiler still keeps frame statistics
+    profiler->events = malloc(PROFILER_TRACE_EVENTS * sizeof(ProfileEvent));
+}
+
+void ProfilerFree(Profiler *profiler) {
+    free(profiler->events);
+    profiler->events = NULL;
+}
+
+void ProfilerBegin(Profiler *profiler, ProfilePhase phase) {
+    profiler->open[phase] = ProfilerNow();
+}
+
+void ProfilerEnd(Profiler *profiler, ProfilePhase phase) {
+    uint64_t end = ProfilerNow();
+    uint64_t duration = end - profiler->open[phase];
+    profiler->frame[phase] += duration / 1e6f;
+    
+    if (profiler->events) {
+        ProfileEvent *event = &profiler->events[profiler->eventCount++ % PROFILER_TRACE_EVENTS];
+        event->label = profiler->label;
+        event->start = profiler->open[phase] - profiler->origin;
+        event->duration = duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration;
+        event->phase = (uint8_t)phase;
+    }
+}
+
+void ProfilerEndFrame(Profiler *profiler) {
+    int slot = profiler->frames++ % PROFILER_HISTORY;
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        profiler->history[p][slot] = profiler->frame[p];
+        profiler->frame[p] = 0.0f;
+    }
+}
+
+const char *ProfilerPhaseName(ProfilePhase phase) {
+    return phaseNames[phase];
+}
+
+static int CompareFloats(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+ProfileStats ProfilerGetStats(const Profiler *profiler, ProfilePhase phase) {
+    ProfileStats stats = { 0 };
+    int count = profiler->frames < PROFILER_HISTORY ? (int)profiler->frames : PROFILER_HISTORY;
+    if (count == 0) return stats;
+    
+    float sorted[PROFILER_HISTORY];
+    memcpy(sorted, profiler->history[phase], count * sizeof(float));
+    qsort(sorted, count, sizeof(float), CompareFloats);
+    stats.p50 = sorted[count / 2];
+    stats.p99 = sorted[(count * 99) / 100];
+    stats.max = sorted[count - 1];
+    return stats;
+}
+
+float ProfilerFrameTime(const Profiler *profiler, ProfilePhase phase, int framesAgo) {
+    if (framesAgo < 0 || framesAgo >= PROFILER_HISTORY || (uint32_t)framesAgo >= profiler->frames) return 0.0f;
+    return profiler->history[phase][(profiler->frames - 1 - framesAgo) % PROFILER_HISTORY];
+}
+
+// Labels are scene titles, but keep the JSON valid whatever they hold
+static void WriteJsonString(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        if (*c == '"' || *c == '\\') fprintf(file, "\\%c", *c);
+        else if (*c < 0x20) fprintf(file, "\\u%04x", *c);
+        else fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+bool ProfilerWriteTrace(const Profiler *profiler, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+    
+    // Oldest event first; the ring may have wrapped
+    uint32_t count = profiler->events ? profiler->eventCount : 0;
+    uint32_t first = count > PROFILER_TRACE_EVENTS ? count - PROFILER_TRACE_EVENTS : 0;
+    
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (uint32_t i = first; i < count; i++) {
+        const ProfileEvent *event = &profiler->events[i % PROFILER_TRACE_EVENTS];
+        fprintf(file, "{\"name\":\"%s\",\"cat\":", phaseNames[event->phase]);
+        WriteJsonString(file, event->label);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                event->start / 1e3, event->duration / 1e3, i + 1 < count ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    
+    bool ok = !ferror(file);
+    return (fclose(file) == 0) && ok;
+}
@@ -0,0 +1,64 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Frame profiler: high-resolution timers around the phases of each frame.
+// Every phase keeps its time for the last PROFILER_HISTORY frames in a
+// ring, for percentiles and a frame graph, and every timed span is kept
+// in a ring of trace events that can be written out as Chrome trace-event
+// JSON (load it in chrome://tracing or Perfetto). Timing does not touch
+// raylib, so headless tools can profile too.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PROFILER_HISTORY 256            // frames kept per phase
+#define PROFILER_TRACE_EVENTS 32768     // spans kept for trace export
+
+typedef enum {
+    PROFILE_FRAME = 0,  // the whole frame
+    PROFILE_UPDATE,     // input and scene logic
+    PROFILE_TICK,       // fixed simulation steps, summed over the frame
+    PROFILE_DRAW,       // building the frame
+    PROFILE_PRESENT,    // EndDrawing: swap, vsync and frame limiter waits
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+typedef struct {
+    const char *label;  // what was running, e.g. the scene title
+    uint64_t start;     // nanoseconds since ProfilerInit
+    uint32_t duration;  // nanoseconds
+    uint8_t phase;
+} ProfileEvent;
+
+typedef struct {
+    float p50, p99, max;    // milliseconds
+} ProfileStats;
+
+typedef struct {
+    uint64_t origin;                            // clock at init
+    uint64_t open[PROFILE_PHASE_COUNT];         // start of each running span
+    float frame[PROFILE_PHASE_COUNT];           // this frame so far, ms
+    float history[PROFILE_PHASE_COUNT][PROFILER_HISTORY];   // ms per frame
+    uint32_t frames;                            // frames recorded
+    const char *label;                          // label for new events
+    ProfileEvent *events;                       // ring; NULL disables tracing
+    uint32_t eventCount;                        // events recorded
+} Profiler;
+
+// Function declarations
+void ProfilerInit(Profiler *profiler);
+void ProfilerFree(Profiler *profiler);
+uint64_t ProfilerNow(void);     // monotonic nanoseconds
+
+void ProfilerBegin(Profiler *profiler, ProfilePhase phase);
+void ProfilerEnd(Profiler *profiler, ProfilePhase phase);
+void ProfilerEndFrame(Profiler *profiler);  // moves this frame into the history
+
+const char *ProfilerPhaseName(ProfilePhase phase);
+ProfileStats ProfilerGetStats(const Profiler *profiler, ProfilePhase phase);
+float ProfilerFrameTime(const Profiler *profiler, ProfilePhase phase, int framesAgo);  // ms, 0 if none
+
+// Write the recorded spans as Chrome trace-event JSON
+bool ProfilerWriteTrace(const Profiler *profiler, const char *path);
+
+#endif // PROFILER_H
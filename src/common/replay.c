@@ -0,0 +1,178 @@
+#include "replay.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+static const char replayMagic[4] = { 'G', 'R', 'P', 'L' };
+
+static void WriteU16(FILE *f, uint16_t v) {
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static void WriteU32(FILE *f, uint32_t v) {
+    for (int i = 0; i < 4; i++) fputc((v >> (8 * i)) & 0xFF, f);
+}
+
+static void WriteU64(FILE *f, uint64_t v) {
+    for (int i = 0; i < 8; i++) fputc((int)((v >> (8 * i)) & 0xFF), f);
+}
+
+static void WriteVarint(FILE *f, uint32_t v) {
+    while (v >= 0x80) {
+        fputc((int)(v & 0x7F) | 0x80, f);
+        v >>= 7;
+    }
+    fputc((int)v, f);
+}
+
+static bool ReadBytes(FILE *f, uint8_t *out, int count) {
+    return fread(out, 1, (size_t)count, f) == (size_t)count;
+}
+
+static bool ReadU64(FILE *f, uint64_t *v) {
+    uint8_t b[8];
+    if (!ReadBytes(f, b, 8)) return false;
+    *v = 0;
+    for (int i = 7; i >= 0; i--) *v = (*v << 8) | b[i];
+    return true;
+}
+
+static bool ReadVarint(FILE *f, uint32_t *v) {
+    *v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF) return false;
+        *v |= (uint32_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+bool ReplayWriterOpen(ReplayWriter *writer, const char *path, const ReplayHeader *header) {
+    memset(writer, 0, sizeof(*writer));
+    writer->file = fopen(path, "wb");
+    if (!writer->file) return false;
+    
+    fwrite(replayMagic, 1, sizeof(replayMagic), writer->file);
+    WriteU16(writer->file, REPLAY_VERSION);
+    fputc(header->game, writer->file);
+    fputc(header->variant, writer->file);
+    WriteU32(writer->file, header->tickRate);
+    WriteU64(writer->file, header->seed);
+    return true;
+}
+
+void ReplayWriterPush(ReplayWriter *writer, uint8_t input) {
+    if (!writer->file) return;
+    
+    writer->ticks++;
+    if (writer->run > 0 && input == writer->input && writer->run < UINT32_MAX) {
+        writer->run++;
+        return;
+    }
+    
+    // Input changed: emit the finished run and start a new one
+    if (writer->run > 0) {
+        WriteVarint(writer->file, writer->run);
+        fputc(writer->input, writer->file);
+    }
+    writer->input = input;
+    writer->run = 1;
+}
+
+void ReplayWriterClose(ReplayWriter *writer, int32_t finalScore) {
+    if (!writer->file) return;
+    
+    if (writer->run > 0) {
+        WriteVarint(writer->file, writer->run);
+        fputc(writer->input, writer->file);
+    }
+    WriteVarint(writer->file, 0);
+    WriteU64(writer->file, writer->ticks);
+    WriteU32(writer->file, (uint32_t)finalScore);
+    
+    fclose(writer->file);
+    writer->file = NULL;
+}
+
+bool ReplayReaderOpen(ReplayReader *reader, const char *path) {
+    memset(reader, 0, sizeof(*reader));
+    reader->file = fopen(path, "rb");
+    if (!reader->file) return false;
+    
+    uint8_t head[12];
+    if (!ReadBytes(reader->file, head, sizeof(head)) ||
+        memcmp(head, replayMagic, sizeof(replayMagic)) != 0 ||
+        (head[4] | (head[5] << 8)) != REPLAY_VERSION ||
+        !ReadU64(reader->file, &reader->header.seed)) {
+        ReplayReaderClose(reader);
+        return false;
+    }
+    
+    reader->header.game = head[6];
+    reader->header.variant = head[7];
+    reader->header.tickRate = (uint32_t)head[8] | (uint32_t)head[9] << 8 |
+                              (uint32_t)head[10] << 16 | (uint32_t)head[11] << 24;
+    return true;
+}
+
+// Fetch the input for the next tick; returns false once the stream ends
+bool ReplayReaderNext(ReplayReader *reader, uint8_t *input) {
+    if (reader->run == 0) {
+        if (reader->finished || !reader->file) return false;
+        
+        uint32_t run;
+        int c;
+        if (!ReadVarint(reader->file, &run)) {
+            reader->finished = true;
+            return false;
+        }
+        if (run == 0) {
+            // Footer
+            uint8_t score[4];
+            reader->finished = true;
+            if (ReadU64(reader->file, &reader->ticks) && ReadBytes(reader->file, score, 4)) {
+                reader->finalScore = (int32_t)((uint32_t)score[0] | (uint32_t)score[1] << 8 |
+                                               (uint32_t)score[2] << 16 | (uint32_t)score[3] << 24);
+            }
+            return false;
+        }
+        if ((c = fgetc(reader->file)) == EOF) {
+            reader->finished = true;
+            return false;
+        }
+        reader->run = run;
+        reader->input = (uint8_t)c;
+    }
+    
+    reader->run--;
+    *input = reader->input;
+    return true;
+}
+
+void ReplayReaderClose(ReplayReader *reader) {
+    if (reader->file) {
+        fclose(reader->file);
+        reader->file = NULL;
+    }
+}
+
+bool ReplayMakePath(char *buf, int size, const char *prefix, uint64_t seed) {
+    const char *dir = getenv("GAME_REPLAY_DIR");
+    if (!dir || !dir[0]) dir = "replays";
+    
+#ifdef _WIN32
+    int made = _mkdir(dir);
+#else
+    int made = mkdir(dir, 0755);
+#endif
+    if (made != 0 && errno != EEXIST) return false;
+    
+    int n = snprintf(buf, (size_t)size, "%s/%s-%llu.rpl", dir, prefix, (unsigned long long)seed);
+    return n > 0 && n < size;
+}
@@ -0,0 +1,67 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// Compact input replays: a small header with the game's seed, followed by a
+// run-length encoded stream of per-tick input bitmasks.
+//
+// File layout (all integers little-endian):
+//   header  "GRPL", u16 version, u8 game, u8 variant, u32 tick rate, u64 seed
+//   records varint run length (ticks, >= 1), u8 input bits
+//   footer  varint 0, u64 total ticks, i32 final score
+//
+// Writing and reading stream through a FILE with constant memory and no
+// per-tick allocation, so replays can be recorded live and checked in bulk.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Bumped whenever a core change alters simulation results
+#define REPLAY_VERSION 3
+
+// Simulation rate replays are recorded and played back at
+#define REPLAY_TICK_RATE 60
+
+typedef enum {
+    REPLAY_GAME_TETRIS = 1,
+    REPLAY_GAME_INVADERS = 2
+} ReplayGame;
+
+typedef struct {
+    uint8_t game;       // ReplayGame
+    uint8_t variant;    // game-specific mode, e.g. the Tetris randomizer
+    uint32_t tickRate;  // ticks per simulated second
+    uint64_t seed;
+} ReplayHeader;
+
+typedef struct {
+    FILE *file;
+    uint8_t input;      // input of the run being accumulated
+    uint32_t run;       // length of that run in ticks
+    uint64_t ticks;
+} ReplayWriter;
+
+typedef struct {
+    FILE *file;
+    ReplayHeader header;
+    uint8_t input;
+    uint32_t run;       // ticks left in the current run
+    bool finished;      // footer reached
+    uint64_t ticks;     // from the footer
+    int32_t finalScore; // from the footer
+} ReplayReader;
+
+// Function declarations
+bool ReplayWriterOpen(ReplayWriter *writer, const char *path, const ReplayHeader *header);
+void ReplayWriterPush(ReplayWriter *writer, uint8_t input);
+void ReplayWriterClose(ReplayWriter *writer, int32_t finalScore);
+
+bool ReplayReaderOpen(ReplayReader *reader, const char *path);
+bool ReplayReaderNext(ReplayReader *reader, uint8_t *input);
+void ReplayReaderClose(ReplayReader *reader);
+
+// Build "<dir>/<prefix>-<seed>.rpl" in buf, creating dir if needed.
+// dir comes from the GAME_REPLAY_DIR environment variable, default "replays".
+bool ReplayMakePath(char *buf, int size, const char *prefix, uint64_t seed);
+
+#endif // REPLAY_H
@@ -0,0 +1,60 @@
+#ifndef RNG_H
+#define RNG_H
+
+// Small seedable PRNG (xoshiro128**) stored inside each game's state.
+// Replaces the process-global srand()/rand() so games are reproducible from
+// their seed and independent games never share generator state.
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t s[4];
+} GameRng;
+
+static inline uint32_t RngRotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// Expand a 64-bit seed into the full state with splitmix64
+static inline void RngSeed(GameRng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i += 2) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        rng->s[i] = (uint32_t)z;
+        rng->s[i + 1] = (uint32_t)(z >> 32);
+    }
+}
+
+static inline uint32_t RngNext(GameRng *rng) {
+    uint32_t *s = rng->s;
+    uint32_t result = RngRotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RngRotl(s[3], 11);
+    
+    return result;
+}
+
+static inline uint64_t RngNext64(GameRng *rng) {
+    uint64_t hi = RngNext(rng);
+    return (hi << 32) | RngNext(rng);
+}
+
+// Uniform integer in [0, n) using a multiply-shift instead of a division
+static inline uint32_t RngRange(GameRng *rng, uint32_t n) {
+    return (uint32_t)(((uint64_t)RngNext(rng) * n) >> 32);
+}
+
+// Uniform float in [0, 1)
+static inline float RngFloat(GameRng *rng) {
+    return (RngNext(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+#endif // RNG_H
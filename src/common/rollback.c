@@ -0,0 +1,168 @@
+#include "rollback.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SAVED_STATES (ROLLBACK_MAX_FRAMES + 1)
+#define NO_ROLLBACK UINT32_MAX
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint8_t *Input(RollbackSession *session, int player, uint32_t frame) {
+    return &session->inputs[player][frame & (ROLLBACK_HISTORY - 1)];
+}
+
+static void *Saved(RollbackSession *session, uint32_t frame) {
+    return session->saved + (frame % SAVED_STATES) * session->stateSize;
+}
+
+// Remote input for frames not received yet: the held bits of the last one
+static uint8_t Predict(RollbackSession *session) {
+    if (session->remoteFrame == 0) return 0;
+    return *Input(session, 1 - session->localPlayer, session->remoteFrame - 1) & session->heldMask;
+}
+
+bool RollbackInit(RollbackSession *session, void *state, size_t stateSize, int localPlayer,
+                  uint8_t heldMask, RollbackStepFn step, void *user) {
+    memset(session, 0, sizeof(*session));
+    session->saved = malloc(SAVED_STATES * stateSize);
+    if (!session->saved) return false;
+    session->localPlayer = localPlayer;
+    session->heldMask = heldMask;
+    session->rollbackFrame = NO_ROLLBACK;
+    session->state = state;
+    session->stateSize = stateSize;
+    session->step = step;
+    session->user = user;
+    return true;
+}
+
+void RollbackFree(RollbackSession *session) {
+    free(session->saved);
+    session->saved = NULL;
+}
+
+// Save the state before the frame, then simulate it
+static void Simulate(RollbackSession *session, uint32_t frame) {
+    memcpy(Saved(session, frame), session->state, session->stateSize);
+    uint8_t inputs[2] = { *Input(session, 0, frame), *Input(session, 1, frame) };
+    session->step(session->state, inputs, session->user);
+}
+
+void RollbackCorrect(RollbackSession *session) {
+    if (session->rollbackFrame == NO_ROLLBACK) return;
+    uint32_t first = session->rollbackFrame;
+    session->rollbackFrame = NO_ROLLBACK;
+    
+    uint64_t start = NowNs();
+    memcpy(session->state, Saved(session, first), session->stateSize);
+    uint8_t prediction = Predict(session);
+    int remote = 1 - session->localPlayer;
+    for (uint32_t frame = first; frame < session->frame; frame++) {
+        if (frame >= session->remoteFrame) *Input(session, remote, frame) = prediction;
+        Simulate(session, frame);
+    }
+    uint64_t elapsed = NowNs() - start;
+    
+    RollbackStats *stats = &session->stats;
+    int depth = (int)(session->frame - first);
+    stats->rollbacks++;
+    stats->resimulated += (uint64_t)depth;
+    if (depth > stats->maxDepth) stats->maxDepth = depth;
+    stats->resimulateNs += elapsed;
+    if (elapsed > stats->maxResimulateNs) stats->maxResimulateNs = elapsed;
+}
+
+bool RollbackAdvance(RollbackSession *session, uint8_t localInput) {
+    RollbackCorrect(session);
+    
+    // Too far ahead of the remote input to predict, or of the peer's acks
+    // to keep our unacknowledged inputs
+    if ((int32_t)(session->frame - session->remoteFrame) >= ROLLBACK_MAX_FRAMES ||
+        session->frame - session->ackFrame >= ROLLBACK_HISTORY) {
+        session->stats.stalls++;
+        return false;
+    }
+    
+    // Ahead of the peer by a frame or more (half the difference of the two
+    // advantages): skip a tick now and then so it can catch up
+    if (session->advantage - session->remoteAdvantage >= 2 &&
+        session->frame - session->lastSyncWait >= 2 * ROLLBACK_MAX_FRAMES) {
+        session->lastSyncWait = session->frame;
+        session->stats.syncWaits++;
+        return false;
+    }
+    
+    uint32_t frame = session->frame;
+    *Input(session, session->localPlayer, frame) = localInput;
+    if (frame >= session->remoteFrame) *Input(session, 1 - session->localPlayer, frame) = Predict(session);
+    Simulate(session, frame);
+    session->frame++;
+    session->stats.frames++;
+    return true;
+}
+
+int RollbackWritePacket(RollbackSession *session, uint8_t *out, int size) {
+    uint32_t count = session->frame - session->ackFrame;
+    if (count > ROLLBACK_HISTORY) count = ROLLBACK_HISTORY;
+    if (size < ROLLBACK_PACKET_HEADER) return 0;
+    if ((int)count > size - ROLLBACK_PACKET_HEADER) count = (uint32_t)(size - ROLLBACK_PACKET_HEADER);
+    
+    int advantage = session->advantage;
+    if (advantage > 127) advantage = 127;
+    if (advantage < -128) advantage = -128;
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(session->remoteFrame >> (8 * i));
+    for (int i = 0; i < 4; i++) out[4 + i] = (uint8_t)(session->ackFrame >> (8 * i));
+    out[8] = (uint8_t)(int8_t)advantage;
+    out[9] = (uint8_t)count;
+    for (uint32_t i = 0; i < count; i++) {
+        out[ROLLBACK_PACKET_HEADER + i] = *Input(session, session->localPlayer, session->ackFrame + i);
+    }
+    session->stats.packetsSent++;
+    return ROLLBACK_PACKET_HEADER + (int)count;
+}
+
+bool RollbackReadPacket(RollbackSession *session, const uint8_t *data, int size) {
+    if (size < ROLLBACK_PACKET_HEADER || size < ROLLBACK_PACKET_HEADER + data[9]) return false;
+    uint32_t ack = 0, first = 0;
+    for (int i = 0; i < 4; i++) ack |= (uint32_t)data[i] << (8 * i);
+    for (int i = 0; i < 4; i++) first |= (uint32_t)data[4 + i] << (8 * i);
+    int count = data[9];
+    session->stats.packetsReceived++;
+    
+    // Packets may arrive out of order; only ever move forward
+    if (ack > session->ackFrame && ack <= session->frame) session->ackFrame = ack;
+    session->advantage = (int)session->frame - (int)(first + (uint32_t)count);
+    session->remoteAdvantage = (int8_t)data[8];
+    
+    // Take the inputs that continue what we have. Frames already simulated
+    // on a prediction need a rollback if the prediction was wrong.
+    int remote = 1 - session->localPlayer;
+    uint32_t limit = session->frame + ROLLBACK_HISTORY - ROLLBACK_MAX_FRAMES - 1;
+    for (int i = 0; i < count; i++) {
+        uint32_t frame = first + (uint32_t)i;
+        if (frame < session->remoteFrame) continue;
+        if (frame > session->remoteFrame || frame >= limit) break;
+        uint8_t input = data[ROLLBACK_PACKET_HEADER + i];
+        uint8_t *slot = Input(session, remote, frame);
+        if (frame < session->frame && *slot != input && frame < session->rollbackFrame) {
+            session->rollbackFrame = frame;
+        }
+        *slot = input;
+        session->remoteFrame++;
+    }
+    
+    // Frames still predicted were predicted from an older input
+    uint8_t prediction = Predict(session);
+    for (uint32_t frame = session->remoteFrame; frame < session->frame; frame++) {
+        if (*Input(session, remote, frame) != prediction) {
+            if (frame < session->rollbackFrame) session->rollbackFrame = frame;
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+// Rollback netcode for two-player lockstep games, GGPO style. Each peer
+// simulates a frame as soon as its own input is in. It predicts the
+// remote input by repeating the held bits of the last one received. When
+// the real input arrives and differs, the session restores the state
+// saved before the first mispredicted frame and re-simulates up to the
+// present with the corrected inputs. It predicts at most
+// ROLLBACK_MAX_FRAMES ahead of the remote input and stalls beyond that.
+//
+// The game state must be one flat block with no pointers, so saving and
+// restoring a frame is a single copy; the session keeps one copy per
+// frame it may still have to rewind to.
+//
+// Every packet carries all local inputs the peer has not acknowledged, so
+// a lost packet is covered by the next one, with no resends and no
+// ordering. Packet layout, integers little-endian:
+//   u32 ack       remote frames received so far
+//   u32 first     frame of the first input
+//   i8  advantage how many frames the sender thinks it is ahead
+//   u8  count     then count inputs, one byte each
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ROLLBACK_MAX_FRAMES 8   // furthest a session runs ahead of remote input
+#define ROLLBACK_HISTORY 64     // inputs kept per player; a power of two
+#define ROLLBACK_PACKET_HEADER 10
+#define ROLLBACK_PACKET_MAX (ROLLBACK_PACKET_HEADER + ROLLBACK_HISTORY)
+
+// Simulate one frame; inputs are indexed by player
+typedef void (*RollbackStepFn)(void *state, const uint8_t inputs[2], void *user);
+
+typedef struct {
+    uint64_t frames;            // frames advanced
+    uint64_t stalls;            // ticks waiting for remote input
+    uint64_t syncWaits;         // ticks skipped to let a slower peer catch up
+    uint64_t rollbacks;
+    uint64_t resimulated;       // frames simulated again
+    int maxDepth;               // most frames re-simulated at once
+    uint64_t resimulateNs;      // restore plus re-simulation, all rollbacks
+    uint64_t maxResimulateNs;
+    uint64_t packetsSent;
+    uint64_t packetsReceived;
+} RollbackStats;
+
+typedef struct {
+    int localPlayer;            // 0 or 1
+    uint8_t heldMask;           // input bits repeated when predicting
+    uint32_t frame;             // frames simulated so far
+    uint32_t remoteFrame;       // remote input known for every frame before this
+    uint32_t ackFrame;          // the peer has our input for every frame before this
+    uint32_t rollbackFrame;     // first frame simulated with a wrong prediction
+    int advantage;              // local frame minus the peer's, as last seen
+    int remoteAdvantage;        // the same, as the peer last reported it
+    uint32_t lastSyncWait;
+    uint8_t inputs[2][ROLLBACK_HISTORY];   // by player, then frame % ROLLBACK_HISTORY
+    
+    void *state;
+    size_t stateSize;
+    uint8_t *saved;             // saved[f % (ROLLBACK_MAX_FRAMES + 1)]: the state before frame f
+    RollbackStepFn step;
+    void *user;
+    RollbackStats stats;
+} RollbackSession;
+
+// Function declarations
+bool RollbackInit(RollbackSession *session, void *state, size_t stateSize, int localPlayer,
+                  uint8_t heldMask, RollbackStepFn step, void *user);
+void RollbackFree(RollbackSession *session);
+
+// Simulate the next frame with this local input; false while the session
+// has to wait for the peer, and the input should be offered again
+bool RollbackAdvance(RollbackSession *session, uint8_t localInput);
+
+// Re-simulate now if a late input showed a misprediction; Advance does
+// this first anyway
+void RollbackCorrect(RollbackSession *session);
+
+// Returns the bytes written
+int RollbackWritePacket(RollbackSession *session, uint8_t *out, int size);
+bool RollbackReadPacket(RollbackSession *session, const uint8_t *data, int size);
+
+#endif // ROLLBACK_H
@@ -0,0 +1,167 @@
+#include "scene.h"
+#include "profiler.h"
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Most ticks a scene may run in one frame before it drops the backlog
+#define SCENE_MAX_TICKS_PER_FRAME 8
+
+// Frames shown in the profiler overlay's graph
+#define SCENE_GRAPH_FRAMES 120
+
+void ScenePush(SceneStack *stack, const Scene *scene) {
+    stack->pendingPush = scene;
+}
+
+void ScenePop(SceneStack *stack) {
+    stack->pendingPops++;
+}
+
+static void EnterScene(SceneStack *stack, const Scene *scene) {
+    if (stack->depth == SCENE_STACK_MAX) return;
+    
+    void *state = NULL;
+    if (scene->init) {
+        state = scene->init();
+        if (!state) return;
+    }
+    
+    SceneEntry *entry = &stack->entries[stack->depth++];
+    entry->scene = scene;
+    entry->state = state;
+    FixedStepInit(&entry->clock, scene->tickRate > 0 ? scene->tickRate : 1, SCENE_MAX_TICKS_PER_FRAME);
+}
+
+static void LeaveScene(SceneStack *stack) {
+    SceneEntry *entry = &stack->entries[--stack->depth];
+    if (entry->scene->shutdown) entry->scene->shutdown(entry->state);
+    entry->state = NULL;
+}
+
+// Match the window to the top scene; only resizes when the size differs
+static void ApplyWindow(const Scene *scene) {
+    if (GetScreenWidth() != scene->width || GetScreenHeight() != scene->height) {
+        SetWindowSize(scene->width, scene->height);
+    }
+    SetWindowTitle(scene->title);
+}
+
+// Where F4 writes the frame trace
+static const char *TracePath(void) {
+    const char *path = getenv("GAME_TRACE_FILE");
+    return (path && path[0]) ? path : "trace.json";
+}
+
+static void SaveTrace(const Profiler *profiler) {
+    const char *path = TracePath();
+    if (ProfilerWriteTrace(profiler, path)) TraceLog(LOG_INFO, "PROFILER: Trace written to %s", path);
+    else TraceLog(LOG_WARNING, "PROFILER: Could not write trace to %s", path);
+}
+
+// F3 overlay: percentiles of every phase over the last PROFILER_HISTORY
+// frames and a graph of recent frame times against the 60 Hz budget
+static void DrawProfilerOverlay(const Profiler *profiler) {
+    const int x = 8, y = 8, width = 2 * SCENE_GRAPH_FRAMES + 16;
+    const int graphHeight = 48;
+    const float graphMs = 50.0f;
+    int height = 30 + PROFILE_PHASE_COUNT * 14 + graphHeight + 12;
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+    
+    // The default font is proportional, so columns sit at fixed offsets
+    static const char *headings[] = { "ms", "p50", "p99", "max" };
+    for (int c = 0; c < 4; c++) DrawText(headings[c], x + 8 + 60 * c, y + 8, 10, LIGHTGRAY);
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        ProfileStats stats = ProfilerGetStats(profiler, (ProfilePhase)p);
+        Color color = (p == PROFILE_FRAME && stats.p99 > 1000.0f / 60.0f) ? ORANGE : RAYWHITE;
+        int rowY = y + 24 + p * 14;
+        DrawText(ProfilerPhaseName((ProfilePhase)p), x + 8, rowY, 10, color);
+        DrawText(TextFormat("%.2f", stats.p50), x + 68, rowY, 10, color);
+        DrawText(TextFormat("%.2f", stats.p99), x + 128, rowY, 10, color);
+        DrawText(TextFormat("%.2f", stats.max), x + 188, rowY, 10, color);
+    }
+    
+    // Newest frame on the right; bars over the budget line are long frames
+    int graphBottom = y + height - 8;
+    for (int i = 0; i < SCENE_GRAPH_FRAMES; i++) {
+        float ms = ProfilerFrameTime(profiler, PROFILE_FRAME, i);
+        int bar = (int)(ms / graphMs * graphHeight);
+        if (bar > graphHeight) bar = graphHeight;
+        Color color = ms > 1000.0f / 60.0f + 1.0f ? RED : GREEN;
+        DrawRectangle(x + width - 8 - 2 * (i + 1), graphBottom - bar, 2, bar, color);
+    }
+    int budget = graphBottom - (int)(1000.0f / 60.0f / graphMs * graphHeight);
+    DrawLine(x + 8, budget, x + width - 8, budget, YELLOW);
+}
+
+void SceneRun(const Scene *root) {
+    SceneStack stack = {0};
+    Profiler profiler;
+    bool showProfiler = false;
+    
+    // Scenes decide what ESC does; the window only closes on request
+    SetExitKey(KEY_NULL);
+    
+    ProfilerInit(&profiler);
+    EnterScene(&stack, root);
+    ApplyWindow(root);
+    
+    while (stack.depth > 0 && !WindowShouldClose()) {
+        SceneEntry *top = &stack.entries[stack.depth - 1];
+        const Scene *scene = top->scene;
+        profiler.label = scene->title;
+        ProfilerBegin(&profiler, PROFILE_FRAME);
+        
+        if (IsKeyPressed(KEY_F3)) showProfiler = !showProfiler;
+        if (IsKeyPressed(KEY_F4)) SaveTrace(&profiler);
+        
+        // Update
+        ProfilerBegin(&profiler, PROFILE_UPDATE);
+        scene->update(top->state, &stack);
+        ProfilerEnd(&profiler, PROFILE_UPDATE);
+        float alpha = 0.0f;
+        if (scene->tick) {
+            int ticks = FixedStepAdvance(&top->clock, GetFrameTime());
+            for (int i = 0; i < ticks; i++) {
+                ProfilerBegin(&profiler, PROFILE_TICK);
+                scene->tick(top->state, top->clock.step);
+                ProfilerEnd(&profiler, PROFILE_TICK);
+            }
+            alpha = FixedStepAlpha(&top->clock);
+        }
+        
+        // Draw
+        ProfilerBegin(&profiler, PROFILE_DRAW);
+        BeginDrawing();
+        scene->draw(top->state, alpha);
+        ProfilerEnd(&profiler, PROFILE_DRAW);
+        if (showProfiler) DrawProfilerOverlay(&profiler);
+        ProfilerBegin(&profiler, PROFILE_PRESENT);
+        EndDrawing();
+        ProfilerEnd(&profiler, PROFILE_PRESENT);
+        
+        // Switch scenes between frames, so the next frame is the new scene
+        bool switched = stack.pendingPops > 0 || stack.pendingPush;
+        for (; stack.pendingPops > 0 && stack.depth > 0; stack.pendingPops--) {
+            LeaveScene(&stack);
+        }
+        stack.pendingPops = 0;
+        if (stack.pendingPush) {
+            EnterScene(&stack, stack.pendingPush);
+            stack.pendingPush = NULL;
+        }
+        if (switched && stack.depth > 0) {
+            ApplyWindow(stack.entries[stack.depth - 1].scene);
+        }
+        ProfilerEnd(&profiler, PROFILE_FRAME);
+        ProfilerEndFrame(&profiler);
+    }
+    
+    while (stack.depth > 0) {
+        LeaveScene(&stack);
+    }
+    
+    // Kiosks can leave a trace of every session behind
+    if (getenv("GAME_TRACE_FILE")) SaveTrace(&profiler);
+    ProfilerFree(&profiler);
+}
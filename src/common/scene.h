@@ -0,0 +1,48 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+// Scenes share one window for the life of the process. The menu and each
+// game are scenes on a stack: entering a game pushes it, leaving pops back
+// to whatever is underneath. Only the top scene updates and draws, and a
+// switch takes effect at the end of the frame, so it costs one frame rather
+// than a new window and GL context.
+
+#include "fixed_step.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SCENE_STACK_MAX 8
+
+typedef struct SceneStack SceneStack;
+
+typedef struct {
+    const char *title;
+    int width, height;      // window size the scene wants
+    int tickRate;           // fixed ticks per second; 0 for no ticks
+
+    void *(*init)(void);                            // returns the scene's state
+    void (*update)(void *state, SceneStack *stack); // once per frame: input, push/pop
+    void (*tick)(void *state, float dt);            // once per fixed tick (optional)
+    void (*draw)(void *state, float alpha);         // alpha: 0..1 between ticks
+    void (*shutdown)(void *state);                  // frees the state
+} Scene;
+
+typedef struct {
+    const Scene *scene;
+    void *state;
+    FixedStep clock;
+} SceneEntry;
+
+struct SceneStack {
+    SceneEntry entries[SCENE_STACK_MAX];
+    int depth;
+    const Scene *pendingPush;
+    int pendingPops;
+};
+
+// Function declarations
+void ScenePush(SceneStack *stack, const Scene *scene);  // applied at end of frame
+void ScenePop(SceneStack *stack);                       // applied at end of frame
+void SceneRun(const Scene *root);   // runs until the stack is empty; needs a window
+
+#endif // SCENE_H
@@ -0,0 +1,144 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// Minimal 4-wide float SIMD wrapper: SSE2 on x86, NEON on ARM (Apple
+// Silicon included) and a plain scalar fallback elsewhere. Loads and stores
+// are unaligned, so arrays only need their length padded to SIMD_WIDTH.
+
+#include <stdint.h>
+
+#define SIMD_WIDTH 4
+
+// Round a count up to a whole number of SIMD lanes
+#define SIMD_PAD(n) (((n) + SIMD_WIDTH - 1) & ~(SIMD_WIDTH - 1))
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+typedef __m128 SimdFloat;
+
+static inline SimdFloat SimdLoad(const float *p) { return _mm_loadu_ps(p); }
+static inline void SimdStore(float *p, SimdFloat v) { _mm_storeu_ps(p, v); }
+static inline SimdFloat SimdSet1(float f) { return _mm_set1_ps(f); }
+static inline SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return _mm_add_ps(a, b); }
+static inline SimdFloat SimdSub(SimdFloat a, SimdFloat b) { return _mm_sub_ps(a, b); }
+static inline SimdFloat SimdMul(SimdFloat a, SimdFloat b) { return _mm_mul_ps(a, b); }
+static inline SimdFloat SimdMin(SimdFloat a, SimdFloat b) { return _mm_min_ps(a, b); }
+static inline SimdFloat SimdMax(SimdFloat a, SimdFloat b) { return _mm_max_ps(a, b); }
+
+// Lane i is all ones when bit i of bits is set
+static inline SimdFloat SimdMaskFromBits(unsigned int bits) {
+    const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+    __m128i set = _mm_and_si128(_mm_set1_epi32((int)bits), lanes);
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(set, lanes));
+}
+
+// Per lane: mask ? a : b
+static inline SimdFloat SimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Bit i set when lane i of a is less than b
+static inline unsigned int SimdLessMask(SimdFloat a, SimdFloat b) {
+    return (unsigned int)_mm_movemask_ps(_mm_cmplt_ps(a, b));
+}
+
+static inline float SimdReduceMin(SimdFloat v) {
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+static inline float SimdReduceMax(SimdFloat v) {
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+
+typedef float32x4_t SimdFloat;
+
+static inline SimdFloat SimdLoad(const float *p) { return vld1q_f32(p); }
+static inline void SimdStore(float *p, SimdFloat v) { vst1q_f32(p, v); }
+static inline SimdFloat SimdSet1(float f) { return vdupq_n_f32(f); }
+static inline SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return vaddq_f32(a, b); }
+static inline SimdFloat SimdSub(SimdFloat a, SimdFloat b) { return vsubq_f32(a, b); }
+static inline SimdFloat SimdMul(SimdFloat a, SimdFloat b) { return vmulq_f32(a, b); }
+static inline SimdFloat SimdMin(SimdFloat a, SimdFloat b) { return vminq_f32(a, b); }
+static inline SimdFloat SimdMax(SimdFloat a, SimdFloat b) { return vmaxq_f32(a, b); }
+
+static inline SimdFloat SimdMaskFromBits(unsigned int bits) {
+    const uint32_t lanes[4] = { 1, 2, 4, 8 };
+    uint32x4_t set = vtstq_u32(vdupq_n_u32(bits), vld1q_u32(lanes));
+    return vreinterpretq_f32_u32(set);
+}
+
+static inline SimdFloat SimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) {
+    return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+}
+
+static inline unsigned int SimdLessMask(SimdFloat a, SimdFloat b) {
+    const uint32_t lanes[4] = { 1, 2, 4, 8 };
+    uint32x4_t bits = vandq_u32(vcltq_f32(a, b), vld1q_u32(lanes));
+    return vgetq_lane_u32(bits, 0) | vgetq_lane_u32(bits, 1) |
+           vgetq_lane_u32(bits, 2) | vgetq_lane_u32(bits, 3);
+}
+
+static inline float SimdReduceMin(SimdFloat v) {
+    float32x2_t m = vpmin_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmin_f32(m, m), 0);
+}
+
+static inline float SimdReduceMax(SimdFloat v) {
+    float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(m, m), 0);
+}
+
+#else
+
+typedef struct { float v[4]; } SimdFloat;
+
+static inline SimdFloat SimdLoad(const float *p) { SimdFloat r = {{ p[0], p[1], p[2], p[3] }}; return r; }
+static inline void SimdStore(float *p, SimdFloat a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+static inline SimdFloat SimdSet1(float f) { SimdFloat r = {{ f, f, f, f }}; return r; }
+static inline SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+static inline SimdFloat SimdSub(SimdFloat a, SimdFloat b) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+static inline SimdFloat SimdMul(SimdFloat a, SimdFloat b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+static inline SimdFloat SimdMin(SimdFloat a, SimdFloat b) { for (int i = 0; i < 4; i++) if (b.v[i] < a.v[i]) a.v[i] = b.v[i]; return a; }
+static inline SimdFloat SimdMax(SimdFloat a, SimdFloat b) { for (int i = 0; i < 4; i++) if (b.v[i] > a.v[i]) a.v[i] = b.v[i]; return a; }
+
+// Scalar lanes keep the mask as 0.0 / 1.0
+static inline SimdFloat SimdMaskFromBits(unsigned int bits) {
+    SimdFloat r;
+    for (int i = 0; i < 4; i++) r.v[i] = (bits >> i) & 1 ? 1.0f : 0.0f;
+    return r;
+}
+
+static inline SimdFloat SimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) {
+    for (int i = 0; i < 4; i++) if (mask.v[i] == 0.0f) a.v[i] = b.v[i];
+    return a;
+}
+
+static inline unsigned int SimdLessMask(SimdFloat a, SimdFloat b) {
+    unsigned int bits = 0;
+    for (int i = 0; i < 4; i++) if (a.v[i] < b.v[i]) bits |= 1u << i;
+    return bits;
+}
+
+static inline float SimdReduceMin(SimdFloat a) {
+    float m = a.v[0];
+    for (int i = 1; i < 4; i++) if (a.v[i] < m) m = a.v[i];
+    return m;
+}
+
+static inline float SimdReduceMax(SimdFloat a) {
+    float m = a.v[0];
+    for (int i = 1; i < 4; i++) if (a.v[i] > m) m = a.v[i];
+    return m;
+}
+
+#endif
+
+#endif // SIMD_H
@@ -0,0 +1,177 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+// Byte and bit streams for versioned game snapshots and deltas.
+//
+// Every snapshot or delta starts with a u8 kind (SnapshotKind, with
+// SNAPSHOT_DELTA set for deltas), a u8 format version and a varint mask of
+// the sections that follow. A delta carries only the sections that changed;
+// a snapshot is the delta from an empty game, so one encoder and one decoder
+// serve both. Integers are little-endian, floats are stored as their bits so
+// a restored game continues exactly as the original would have.
+//
+// A writer that runs out of room only sets overflow and a reader that runs
+// past the end only sets error, so callers check once at the end instead of
+// after every field.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SNAPSHOT_DELTA 0x80
+
+typedef enum {
+    SNAPSHOT_TETRIS = 1,
+    SNAPSHOT_INVADERS = 2
+} SnapshotKind;
+
+typedef struct {
+    uint8_t *data;
+    int size;           // bytes written
+    int capacity;
+    uint32_t bits;      // pending bits, lowest first
+    int bitCount;
+    bool overflow;
+} SnapshotWriter;
+
+typedef struct {
+    const uint8_t *data;
+    int size;
+    int pos;
+    uint32_t bits;
+    int bitCount;
+    bool error;
+} SnapshotReader;
+
+static inline void SnapshotWriterInit(SnapshotWriter *w, uint8_t *data, int capacity) {
+    *w = (SnapshotWriter){ .data = data, .capacity = capacity };
+}
+
+static inline void SnapshotReaderInit(SnapshotReader *r, const uint8_t *data, int size) {
+    *r = (SnapshotReader){ .data = data, .size = size };
+}
+
+static inline void SnapshotPutU8(SnapshotWriter *w, uint8_t v) {
+    if (w->size < w->capacity) w->data[w->size++] = v;
+    else w->overflow = true;
+}
+
+static inline void SnapshotPutU16(SnapshotWriter *w, uint16_t v) {
+    SnapshotPutU8(w, (uint8_t)v);
+    SnapshotPutU8(w, (uint8_t)(v >> 8));
+}
+
+static inline void SnapshotPutU32(SnapshotWriter *w, uint32_t v) {
+    for (int i = 0; i < 4; i++) SnapshotPutU8(w, (uint8_t)(v >> (8 * i)));
+}
+
+static inline void SnapshotPutU64(SnapshotWriter *w, uint64_t v) {
+    for (int i = 0; i < 8; i++) SnapshotPutU8(w, (uint8_t)(v >> (8 * i)));
+}
+
+static inline void SnapshotPutVarint(SnapshotWriter *w, uint64_t v) {
+    while (v >= 0x80) {
+        SnapshotPutU8(w, (uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    SnapshotPutU8(w, (uint8_t)v);
+}
+
+static inline void SnapshotPutF32(SnapshotWriter *w, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    SnapshotPutU32(w, bits);
+}
+
+// Up to 24 bits at a time; byte fields may follow only after SnapshotFlushBits
+static inline void SnapshotPutBits(SnapshotWriter *w, uint32_t v, int count) {
+    w->bits |= (v & ((1u << count) - 1)) << w->bitCount;
+    w->bitCount += count;
+    while (w->bitCount >= 8) {
+        SnapshotPutU8(w, (uint8_t)w->bits);
+        w->bits >>= 8;
+        w->bitCount -= 8;
+    }
+}
+
+// Pad the bit stream to a whole byte
+static inline void SnapshotFlushBits(SnapshotWriter *w) {
+    if (w->bitCount > 0) SnapshotPutU8(w, (uint8_t)w->bits);
+    w->bits = 0;
+    w->bitCount = 0;
+}
+
+static inline uint8_t SnapshotGetU8(SnapshotReader *r) {
+    if (r->pos < r->size) return r->data[r->pos++];
+    r->error = true;
+    return 0;
+}
+
+static inline uint16_t SnapshotGetU16(SnapshotReader *r) {
+    uint16_t v = SnapshotGetU8(r);
+    return (uint16_t)(v | (SnapshotGetU8(r) << 8));
+}
+
+static inline uint32_t SnapshotGetU32(SnapshotReader *r) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)SnapshotGetU8(r) << (8 * i);
+    return v;
+}
+
+static inline uint64_t SnapshotGetU64(SnapshotReader *r) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)SnapshotGetU8(r) << (8 * i);
+    return v;
+}
+
+static inline uint64_t SnapshotGetVarint(SnapshotReader *r) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = SnapshotGetU8(r);
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return v;
+    }
+    r->error = true;
+    return v;
+}
+
+static inline float SnapshotGetF32(SnapshotReader *r) {
+    uint32_t bits = SnapshotGetU32(r);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static inline uint32_t SnapshotGetBits(SnapshotReader *r, int count) {
+    while (r->bitCount < count) {
+        r->bits |= (uint32_t)SnapshotGetU8(r) << r->bitCount;
+        r->bitCount += 8;
+    }
+    uint32_t v = r->bits & ((1u << count) - 1);
+    r->bits >>= count;
+    r->bitCount -= count;
+    return v;
+}
+
+// Skip the padding after a bit stream
+static inline void SnapshotAlignBits(SnapshotReader *r) {
+    r->bits = 0;
+    r->bitCount = 0;
+}
+
+// Header shared by every snapshot and delta
+static inline void SnapshotPutHeader(SnapshotWriter *w, uint8_t kind, uint8_t version, uint32_t sections) {
+    SnapshotPutU8(w, kind);
+    SnapshotPutU8(w, version);
+    SnapshotPutVarint(w, sections);
+}
+
+// False on a kind or version this build does not read
+static inline bool SnapshotGetHeader(SnapshotReader *r, uint8_t kind, uint8_t version, uint32_t *sections) {
+    bool ok = SnapshotGetU8(r) == kind;
+    ok = (SnapshotGetU8(r) == version) && ok;
+    *sections = (uint32_t)SnapshotGetVarint(r);
+    return ok && !r->error;
+}
+
+#endif // SNAPSHOT_H
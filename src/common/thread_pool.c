@@ -0,0 +1,213 @@
+#include "thread_pool.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Remaining slice of one worker, padded to its own cache line
+typedef struct {
+    pthread_mutex_t lock;
+    int begin;
+    int end;
+    char pad[64];
+} WorkQueue;
+
+struct ThreadPool {
+    int workerCount;        // includes the calling thread
+    pthread_t *threads;     // workerCount - 1 background threads
+    WorkQueue *queues;      // one per worker
+    
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    uint64_t generation;    // bumped for every ParallelFor
+    int busy;               // background workers still inside the current job
+    bool shutdown;
+    
+    ThreadTaskFn fn;
+    void *arg;
+};
+
+typedef struct {
+    ThreadPool *pool;
+    int self;
+} WorkerArgs;
+
+static bool PopOwn(WorkQueue *queue, int *index) {
+    bool found = false;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->begin < queue->end) {
+        *index = queue->begin++;
+        found = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+// Move the back half of another worker's slice into our own queue
+static bool Steal(ThreadPool *pool, int self) {
+    for (int i = 1; i < pool->workerCount; i++) {
+        WorkQueue *victim = &pool->queues[(self + i) % pool->workerCount];
+        
+        pthread_mutex_lock(&victim->lock);
+        int remaining = victim->end - victim->begin;
+        int begin = victim->end - (remaining + 1) / 2;
+        int end = victim->end;
+        if (remaining > 0) victim->end = begin;
+        pthread_mutex_unlock(&victim->lock);
+        
+        if (remaining > 0) {
+            WorkQueue *own = &pool->queues[self];
+            pthread_mutex_lock(&own->lock);
+            own->begin = begin;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void RunWorker(ThreadPool *pool, int self) {
+    int index;
+    for (;;) {
+        while (PopOwn(&pool->queues[self], &index)) {
+            pool->fn(pool->arg, index, self);
+        }
+        if (!Steal(pool, self)) break;
+    }
+}
+
+static void *WorkerMain(void *data) {
+    WorkerArgs *args = data;
+    ThreadPool *pool = args->pool;
+    int self = args->self;
+    free(args);
+    
+    uint64_t seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->shutdown) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+        
+        RunWorker(pool, self);
+        
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int ThreadPoolCoreCount(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+ThreadPool *ThreadPoolCreate(int workers) {
+    if (workers <= 0) workers = ThreadPoolCoreCount();
+    
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+    pool->workerCount = workers;
+    pool->queues = calloc((size_t)workers, sizeof(WorkQueue));
+    pool->threads = calloc((size_t)workers, sizeof(pthread_t));
+    if (!pool->queues || !pool->threads) {
+        free(pool->queues);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (int i = 0; i < workers; i++) {
+        pthread_mutex_init(&pool->queues[i].lock, NULL);
+    }
+    
+    // Worker 0 is whoever calls ParallelFor
+    for (int i = 1; i < workers; i++) {
+        WorkerArgs *args = malloc(sizeof(WorkerArgs));
+        if (args) {
+            args->pool = pool;
+            args->self = i;
+        }
+        if (!args || pthread_create(&pool->threads[i], NULL, WorkerMain, args) != 0) {
+            // Run with the threads we managed to start
+            free(args);
+            pool->workerCount = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void ThreadPoolDestroy(ThreadPool *pool) {
+    if (!pool) return;
+    
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    
+    for (int i = 1; i < pool->workerCount; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; i < pool->workerCount; i++) {
+        pthread_mutex_destroy(&pool->queues[i].lock);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool->queues);
+    free(pool);
+}
+
+int ThreadPoolSize(const ThreadPool *pool) {
+    return pool ? pool->workerCount : 1;
+}
+
+void ThreadPoolParallelFor(ThreadPool *pool, int count, ThreadTaskFn fn, void *arg) {
+    if (count <= 0) return;
+    
+    // Not worth waking anyone up
+    if (!pool || pool->workerCount == 1 || count == 1) {
+        for (int i = 0; i < count; i++) fn(arg, i, 0);
+        return;
+    }
+    
+    // Even initial split; stealing evens out the rest
+    int workers = pool->workerCount;
+    for (int i = 0; i < workers; i++) {
+        WorkQueue *queue = &pool->queues[i];
+        pthread_mutex_lock(&queue->lock);
+        queue->begin = (int)((long long)count * i / workers);
+        queue->end = (int)((long long)count * (i + 1) / workers);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->busy = workers - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    
+    RunWorker(pool, 0);
+    
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
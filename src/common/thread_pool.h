@@ -0,0 +1,24 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Work-stealing thread pool for data-parallel loops.
+// ParallelFor hands every worker a contiguous slice of the index range;
+// workers that finish early steal half of the biggest remaining slice from
+// another worker. The calling thread works too, and the call returns once
+// every index has run. One ParallelFor may run on a pool at a time, and
+// tasks must not start another ParallelFor on the same pool.
+
+typedef struct ThreadPool ThreadPool;
+
+// Called once per index; worker is in [0, ThreadPoolSize) and can be used to
+// pick per-thread scratch memory
+typedef void (*ThreadTaskFn)(void *arg, int index, int worker);
+
+// Function declarations
+ThreadPool *ThreadPoolCreate(int workers); // workers <= 0 uses every online core
+void ThreadPoolDestroy(ThreadPool *pool);
+int ThreadPoolSize(const ThreadPool *pool);
+int ThreadPoolCoreCount(void);
+void ThreadPoolParallelFor(ThreadPool *pool, int count, ThreadTaskFn fn, void *arg);
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,134 @@
+#include "udp_link.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+bool UdpLinkOpen(UdpLink *link, int port, uint64_t seed) {
+    memset(link, 0, sizeof(*link));
+    link->fd = -1;
+    RngSeed(&link->rng, seed);
+    link->queue = malloc(UDP_LINK_QUEUE * sizeof(UdpPacket));
+    if (!link->queue) return false;
+    
+    link->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (link->fd < 0) return false;
+    struct sockaddr_in address = { .sin_family = AF_INET };
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t)port);
+    if (bind(link->fd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+        fcntl(link->fd, F_SETFL, fcntl(link->fd, F_GETFL) | O_NONBLOCK) < 0) {
+        UdpLinkClose(link);
+        return false;
+    }
+    return true;
+}
+
+bool UdpLinkSetPeer(UdpLink *link, const char *host, int port) {
+    struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_DGRAM };
+    struct addrinfo *result;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0) return false;
+    memcpy(&link->peer, result->ai_addr, sizeof(link->peer));
+    link->peer.sin_port = htons((uint16_t)port);
+    freeaddrinfo(result);
+    link->hasPeer = true;
+    return true;
+}
+
+bool UdpLinkLocalAddress(const UdpLink *link, struct sockaddr_in *out) {
+    if (link->fd < 0 || !link->hasPeer) return false;
+    struct sockaddr_in bound;
+    socklen_t length = sizeof(bound);
+    if (getsockname(link->fd, (struct sockaddr *)&bound, &length) < 0) return false;
+    
+    // Connecting a UDP socket sends nothing; it only picks the route
+    int probe = socket(AF_INET, SOCK_DGRAM, 0);
+    if (probe < 0) return false;
+    length = sizeof(*out);
+    bool ok = connect(probe, (const struct sockaddr *)&link->peer, sizeof(link->peer)) == 0 &&
+              getsockname(probe, (struct sockaddr *)out, &length) == 0;
+    close(probe);
+    out->sin_port = bound.sin_port;
+    return ok;
+}
+
+static void SendNow(UdpLink *link, const void *data, int size) {
+    sendto(link->fd, data, (size_t)size, 0, (struct sockaddr *)&link->peer, sizeof(link->peer));
+    link->sent++;
+}
+
+// Send the held packets that are due, keeping the rest in order
+static void Flush(UdpLink *link) {
+    if (link->queued == 0) return;
+    uint64_t now = NowNs();
+    int kept = 0;
+    for (int i = 0; i < link->queued; i++) {
+        UdpPacket *packet = &link->queue[i];
+        if (packet->due <= now) {
+            SendNow(link, packet->data, packet->size);
+        } else {
+            if (kept != i) link->queue[kept] = *packet;
+            kept++;
+        }
+    }
+    link->queued = kept;
+}
+
+void UdpLinkSend(UdpLink *link, const void *data, int size) {
+    Flush(link);
+    if (!link->hasPeer || size > UDP_LINK_MAX_PACKET) return;
+    
+    if (link->loss > 0.0f && (RngNext(&link->rng) >> 8) * (1.0f / 16777216.0f) < link->loss) {
+        link->dropped++;
+        return;
+    }
+    if (link->latencyMs <= 0 && link->jitterMs <= 0) {
+        SendNow(link, data, size);
+        return;
+    }
+    if (link->queued == UDP_LINK_QUEUE) {
+        link->dropped++;
+        return;
+    }
+    
+    int delayMs = link->latencyMs;
+    if (link->jitterMs > 0) delayMs += (int)RngRange(&link->rng, (uint32_t)link->jitterMs + 1);
+    UdpPacket *packet = &link->queue[link->queued++];
+    packet->due = NowNs() + (uint64_t)delayMs * 1000000ull;
+    packet->size = size;
+    memcpy(packet->data, data, (size_t)size);
+}
+
+int UdpLinkReceive(UdpLink *link, void *out, int size) {
+    Flush(link);
+    for (;;) {
+        struct sockaddr_in from;
+        socklen_t length = sizeof(from);
+        ssize_t got = recvfrom(link->fd, out, (size_t)size, 0, (struct sockaddr *)&from, &length);
+        if (got <= 0) return 0;
+        
+        // Anything not from the peer is ignored
+        if (!link->hasPeer || from.sin_addr.s_addr != link->peer.sin_addr.s_addr ||
+            from.sin_port != link->peer.sin_port) continue;
+        link->received++;
+        return (int)got;
+    }
+}
+
+void UdpLinkClose(UdpLink *link) {
+    if (link->fd >= 0) close(link->fd);
+    link->fd = -1;
+    free(link->queue);
+    link->queue = NULL;
+    link->queued = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef UDP_LINK_H
+#define UDP_LINK_H
+
+// Non-blocking UDP datagrams to and from one peer. This is enough for
+// rollback netcode, which sends a small packet every frame and needs no
+// reliability from the transport. For testing on loopback, outgoing
+// packets can be dropped at random or held back for a latency plus random
+// jitter. Held packets sit in a queue until they are due; every send and
+// receive flushes the ones that are.
+
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "rng.h"
+
+#define UDP_LINK_MAX_PACKET 512
+#define UDP_LINK_QUEUE 256
+
+typedef struct {
+    uint64_t due;               // CLOCK_MONOTONIC nanoseconds
+    int size;
+    uint8_t data[UDP_LINK_MAX_PACKET];
+} UdpPacket;
+
+typedef struct {
+    int fd;
+    struct sockaddr_in peer;
+    bool hasPeer;
+    
+    // Artificial conditions, applied to outgoing packets
+    int latencyMs;
+    int jitterMs;               // extra delay up to this; reorders packets
+    float loss;                 // 0..1
+    GameRng rng;
+    UdpPacket *queue;
+    int queued;
+    
+    uint64_t sent;
+    uint64_t dropped;           // by the loss setting or a full queue
+    uint64_t received;
+} UdpLink;
+
+// Function declarations
+bool UdpLinkOpen(UdpLink *link, int port, uint64_t seed);  // binds every interface; port 0 picks one
+bool UdpLinkSetPeer(UdpLink *link, const char *host, int port);
+
+// The address the peer sees this link at, as far as this machine knows:
+// the bound port on the interface that routes to the peer. Behind NAT the
+// peer sees a different one.
+bool UdpLinkLocalAddress(const UdpLink *link, struct sockaddr_in *out);
+void UdpLinkSend(UdpLink *link, const void *data, int size);
+int UdpLinkReceive(UdpLink *link, void *out, int size);     // one datagram from the peer; 0 if none
+void UdpLinkClose(UdpLink *link);
+
+#endif // UDP_LINK_H
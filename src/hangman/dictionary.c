@@ -0,0 +1,392 @@
+#include "dictionary.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define BUCKETS_PER_CLASS (HANGMAN_MAX_WORD + 1)
+#define DISCARD_BUCKET (2 * BUCKETS_PER_CLASS)
+
+// Constant length, so the per-letter compares below unroll
+static const char rareLetters[] = HANGMAN_RARE_LETTERS;
+#define RARE_COUNT ((int)sizeof(rareLetters) - 1)
+
+// Scan block size: one bit per byte in a uint64_t
+#define BLOCK 64
+
+// Bitmasks for one 64-byte block: line separators ('\n' or '\r'), bytes
+// that cannot appear in a word, and rare letters. Bytes 0x80 and up are
+// parts of UTF-8 letters and count as word bytes.
+typedef struct {
+    uint64_t separator;
+    uint64_t invalid;
+    uint64_t rare;
+} BlockMasks;
+
+#if defined(__SSE2__)
+static BlockMasks ClassifyBlock(const uint8_t *p) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriage = _mm_set1_epi8('\r');
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i letterA = _mm_set1_epi8('a');
+    const __m128i span = _mm_set1_epi8(25);
+    __m128i rareLower[RARE_COUNT];
+    for (int r = 0; r < RARE_COUNT; r++) rareLower[r] = _mm_set1_epi8((char)(rareLetters[r] | 0x20));
+    
+    BlockMasks m = {0};
+    for (int i = 0; i < BLOCK; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i sep = _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, carriage));
+        
+        // Folded to lower case, a letter is 'a'..'z', i.e. (c - 'a') <= 25 unsigned
+        __m128i lower = _mm_or_si128(v, caseBit);
+        __m128i index = _mm_sub_epi8(lower, letterA);
+        __m128i letter = _mm_cmpeq_epi8(_mm_min_epu8(index, span), index);
+        letter = _mm_or_si128(letter, _mm_cmplt_epi8(v, _mm_setzero_si128()));
+        
+        __m128i rare = _mm_setzero_si128();
+        for (int r = 0; r < RARE_COUNT; r++) {
+            rare = _mm_or_si128(rare, _mm_cmpeq_epi8(lower, rareLower[r]));
+        }
+        
+        m.separator |= (uint64_t)(uint16_t)_mm_movemask_epi8(sep) << i;
+        m.invalid |= (uint64_t)(uint16_t)~_mm_movemask_epi8(_mm_or_si128(letter, sep)) << i;
+        m.rare |= (uint64_t)(uint16_t)_mm_movemask_epi8(rare) << i;
+    }
+    return m;
+}
+#else
+static BlockMasks ClassifyBlock(const uint8_t *p) {
+    BlockMasks m = {0};
+    for (int i = 0; i < BLOCK; i++) {
+        uint8_t c = p[i];
+        uint8_t lower = c | 0x20;
+        uint64_t bit = 1ull << i;
+        if (c == '\n' || c == '\r') m.separator |= bit;
+        else if (c >= 0x80) continue;
+        else if (lower < 'a' || lower > 'z') m.invalid |= bit;
+        else if (memchr(rareLetters, c & ~0x20, RARE_COUNT)) m.rare |= bit;
+    }
+    return m;
+}
+#endif
+
+// Chunks smaller than this are not worth handing to another thread
+#define MIN_CHUNK_BYTES (1 << 20)
+
+// Indexing is split into line-aligned chunks so both passes can run on a
+// thread pool. Chunk k's words go to their own slots starting at first[k]
+// and are compacted afterwards, so the result does not depend on chunking.
+typedef struct {
+    HangmanDictionary *dict;
+    int chunks;
+    size_t *begin;          // [chunks + 1] byte offsets, each at a line start
+    uint32_t *first;        // first array slot for each chunk's words
+    uint32_t *count;        // words kept per chunk
+    uint32_t (*counts)[2 * BUCKETS_PER_CLASS + 1];  // per chunk bucket sizes
+} IndexJob;
+
+// Pass 1 for one chunk. The data is classified 64 bytes at a time into
+// bitmasks, so the work per word is a few bit operations no matter how long
+// it is.
+static void ScanChunk(void *arg, int chunk, int worker) {
+    IndexJob *job = arg;
+    HangmanDictionary *dict = job->dict;
+    const uint8_t *base = (const uint8_t *)dict->data + job->begin[chunk];
+    size_t size = job->begin[chunk + 1] - job->begin[chunk];
+    uint32_t *offsets = dict->offsets + job->first[chunk];
+    uint8_t *buckets = dict->buckets + job->first[chunk];
+    uint32_t *counts = job->counts[chunk];
+    uint32_t count = 0;
+    
+    size_t wordStart = 0;
+    bool wordInvalid = false, wordRare = false;   // from earlier blocks
+    for (size_t block = 0; block < size; block += BLOCK) {
+        // The last partial block is padded with separators
+        uint8_t tail[BLOCK];
+        const uint8_t *p = base + block;
+        if (size - block < BLOCK) {
+            memset(tail, '\n', BLOCK);
+            memcpy(tail, p, size - block);
+            p = tail;
+        }
+        BlockMasks m = ClassifyBlock(p);
+        
+        int from = 0;
+        for (uint64_t sep = m.separator; sep; sep &= sep - 1) {
+            int pos = __builtin_ctzll(sep);
+            uint64_t range = ((1ull << pos) - 1) & ~((1ull << from) - 1);
+            size_t length = block + pos - wordStart;
+            bool invalid = wordInvalid || (m.invalid & range);
+            bool rare = wordRare || (m.rare & range);
+            
+            // Branch-free: every line is written, but only kept words
+            // advance count; the rest land in the discard bucket
+            bool keep = (length - 1 < HANGMAN_MAX_WORD) && !invalid;
+            int bucket = keep ? (rare ? BUCKETS_PER_CLASS : 0) + (int)length : DISCARD_BUCKET;
+            offsets[count] = (uint32_t)(job->begin[chunk] + wordStart);
+            buckets[count] = (uint8_t)bucket;
+            counts[bucket]++;
+            count += keep;
+            
+            wordStart = block + pos + 1;
+            wordInvalid = wordRare = false;
+            from = pos + 1;
+        }
+        
+        // The rest of the block belongs to a word that continues
+        if (from < BLOCK) {
+            uint64_t range = ~0ull << from;
+            wordInvalid |= (m.invalid & range) != 0;
+            wordRare |= (m.rare & range) != 0;
+        }
+    }
+    
+    // A padded block ends the last word itself; data that stops on a block
+    // boundary without a newline leaves it open
+    if (wordStart < size) {
+        size_t length = size - wordStart;
+        bool keep = (length - 1 < HANGMAN_MAX_WORD) && !wordInvalid;
+        int bucket = keep ? (wordRare ? BUCKETS_PER_CLASS : 0) + (int)length : DISCARD_BUCKET;
+        offsets[count] = (uint32_t)(job->begin[chunk] + wordStart);
+        buckets[count] = (uint8_t)bucket;
+        counts[bucket]++;
+        count += keep;
+    }
+    job->count[chunk] = count;
+}
+
+// Pass 2 for one chunk: counting-sort its words into their buckets. Each
+// chunk starts at its own cursor per bucket, so chunks never collide.
+static void ScatterChunk(void *arg, int chunk, int worker) {
+    IndexJob *job = arg;
+    HangmanDictionary *dict = job->dict;
+    uint32_t *cursor = job->counts[chunk];
+    uint32_t end = job->first[chunk] + job->count[chunk];
+    for (uint32_t i = job->first[chunk]; i < end; i++) {
+        dict->order[cursor[dict->buckets[i]]++] = i;
+    }
+}
+
+// Index the words in dict->data, one word per line
+static bool BuildIndex(HangmanDictionary *dict, ThreadPool *pool) {
+    IndexJob job = { .dict = dict };
+    job.chunks = pool ? ThreadPoolSize(pool) * 4 : 1;
+    if ((size_t)job.chunks > dict->size / MIN_CHUNK_BYTES) job.chunks = (int)(dict->size / MIN_CHUNK_BYTES);
+    if (job.chunks < 1) job.chunks = 1;
+    
+    // Every kept word is at least two bytes with its newline, which bounds
+    // each chunk's slots without a counting pass. Discarded lines are
+    // written one past the last kept word, so the last chunk, whose final
+    // word may have no newline, needs one slot more.
+    size_t capacity = dict->size / 2 + job.chunks + 1;
+    if (capacity > UINT32_MAX) return false;
+    job.begin = malloc((job.chunks + 1) * sizeof(size_t));
+    job.first = malloc(job.chunks * sizeof(uint32_t));
+    job.count = malloc(job.chunks * sizeof(uint32_t));
+    job.counts = calloc(job.chunks, sizeof(*job.counts));
+    dict->offsets = malloc(capacity * sizeof(uint32_t));
+    dict->buckets = malloc(capacity);
+    bool ok = job.begin && job.first && job.count && job.counts && dict->offsets && dict->buckets;
+    
+    if (ok) {
+        // Chunk boundaries, each moved forward to the start of a line
+        job.begin[0] = 0;
+        for (int k = 1; k < job.chunks; k++) {
+            size_t at = dict->size / job.chunks * k;
+            if (at < job.begin[k - 1]) at = job.begin[k - 1];
+            const char *newline = memchr(dict->data + at, '\n', dict->size - at);
+            job.begin[k] = newline ? (size_t)(newline - dict->data) + 1 : dict->size;
+        }
+        job.begin[job.chunks] = dict->size;
+        for (int k = 0; k < job.chunks; k++) {
+            job.first[k] = (uint32_t)(job.begin[k] / 2 + k);
+        }
+        
+        // Pass 1: words in file order, counting each (class, length) bucket
+        ThreadPoolParallelFor(pool, job.chunks, ScanChunk, &job);
+        
+        // Close the gaps between chunks; words keep their file order
+        uint32_t count = 0;
+        for (int k = 0; k < job.chunks; k++) {
+            memmove(dict->offsets + count, dict->offsets + job.first[k], job.count[k] * sizeof(uint32_t));
+            memmove(dict->buckets + count, dict->buckets + job.first[k], job.count[k]);
+            job.first[k] = count;
+            count += job.count[k];
+        }
+        dict->count = count;
+        
+        // Give back what the bound over-reserved
+        if (count > 0) {
+            uint32_t *offsets = realloc(dict->offsets, count * sizeof(uint32_t));
+            uint8_t *buckets = realloc(dict->buckets, count);
+            if (offsets) dict->offsets = offsets;
+            if (buckets) dict->buckets = buckets;
+        }
+        
+        // Bucket starts, then each chunk's own cursor inside every bucket
+        uint32_t start = 0;
+        for (int b = 0; b < 2 * BUCKETS_PER_CLASS; b++) {
+            dict->bucketStart[b] = start;
+            for (int k = 0; k < job.chunks; k++) {
+                uint32_t size = job.counts[k][b];
+                job.counts[k][b] = start;
+                start += size;
+            }
+        }
+        dict->bucketStart[2 * BUCKETS_PER_CLASS] = start;
+        
+        // Pass 2: counting sort of word indices into their buckets
+        dict->order = malloc((count ? count : 1) * sizeof(uint32_t));
+        ok = dict->order != NULL;
+        if (ok) ThreadPoolParallelFor(pool, job.chunks, ScatterChunk, &job);
+    }
+    
+    free(job.begin);
+    free(job.first);
+    free(job.count);
+    free(job.counts);
+    return ok;
+}
+
+bool HangmanDictionaryLoadMemory(HangmanDictionary *dict, const char *data, size_t size, ThreadPool *pool) {
+    memset(dict, 0, sizeof(*dict));
+    dict->data = data;
+    dict->size = size;
+    if (!BuildIndex(dict, pool)) {
+        HangmanDictionaryFree(dict);
+        return false;
+    }
+    return true;
+}
+
+bool HangmanDictionaryLoad(HangmanDictionary *dict, const char *path, ThreadPool *pool) {
+    memset(dict, 0, sizeof(*dict));
+
+#ifdef _WIN32
+    // No mmap: read the whole file into one buffer
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *buffer = (size > 0) ? malloc((size_t)size) : NULL;
+    if (!buffer || fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+        free(buffer);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+    dict->data = buffer;
+    dict->size = (size_t)size;
+    dict->owned = true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    // Fault the whole file in up front rather than one page at a time
+#ifdef MAP_POPULATE
+    int flags = MAP_PRIVATE | MAP_POPULATE;
+#else
+    int flags = MAP_PRIVATE;
+#endif
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+    madvise(map, (size_t)st.st_size, MADV_WILLNEED);
+    dict->data = map;
+    dict->size = (size_t)st.st_size;
+    dict->mapped = true;
+#endif
+
+    if (!BuildIndex(dict, pool)) {
+        HangmanDictionaryFree(dict);
+        return false;
+    }
+    return true;
+}
+
+void HangmanDictionaryFree(HangmanDictionary *dict) {
+#ifndef _WIN32
+    if (dict->mapped) munmap((void *)dict->data, dict->size);
+#endif
+    if (dict->owned) free((void *)dict->data);
+    free(dict->offsets);
+    free(dict->buckets);
+    free(dict->order);
+    memset(dict, 0, sizeof(*dict));
+}
+
+int64_t HangmanDictionaryPick(const HangmanDictionary *dict, GameRng *rng,
+                              int minLength, int maxLength, HangmanRareFilter rare) {
+    if (minLength < 1) minLength = 1;
+    if (maxLength > HANGMAN_MAX_WORD) maxLength = HANGMAN_MAX_WORD;
+    if (minLength > maxLength) return -1;
+    
+    // One contiguous run of the order array per rare class
+    uint32_t runStart[2], runSize[2];
+    for (int c = 0; c < 2; c++) {
+        bool wanted = rare == HANGMAN_RARE_ANY || (int)rare == c;
+        runStart[c] = dict->bucketStart[c * BUCKETS_PER_CLASS + minLength];
+        runSize[c] = wanted ? dict->bucketStart[c * BUCKETS_PER_CLASS + maxLength + 1] - runStart[c] : 0;
+    }
+    
+    uint32_t total = runSize[0] + runSize[1];
+    if (total == 0) return -1;
+    uint32_t r = RngRange(rng, total);
+    uint32_t slot = (r < runSize[0]) ? runStart[0] + r : runStart[1] + (r - runSize[0]);
+    return dict->order[slot];
+}
+
+uint32_t HangmanDictionaryBucket(const HangmanDictionary *dict, int length, int rare,
+                                 const uint32_t **indices) {
+    if (length < 1 || length > HANGMAN_MAX_WORD || dict->count == 0) {
+        *indices = NULL;
+        return 0;
+    }
+    int b = (rare ? BUCKETS_PER_CLASS : 0) + length;
+    *indices = dict->order + dict->bucketStart[b];
+    return dict->bucketStart[b + 1] - dict->bucketStart[b];
+}
+
+int HangmanDictionaryLength(const HangmanDictionary *dict, uint32_t index) {
+    return dict->buckets[index] % BUCKETS_PER_CLASS;
+}
+
+uint32_t HangmanDictionaryLetters(const HangmanDictionary *dict, uint32_t index) {
+    const char *word = dict->data + dict->offsets[index];
+    int length = HangmanDictionaryLength(dict, index);
+    uint32_t mask = 0;
+    for (int i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)word[i];
+        if (c < 0x80) mask |= 1u << ((c | 0x20) - 'a');
+    }
+    return mask;
+}
+
+int HangmanDictionaryWord(const HangmanDictionary *dict, uint32_t index, char *out, int size) {
+    const char *word = dict->data + dict->offsets[index];
+    int length = HangmanDictionaryLength(dict, index);
+    if (length >= size) length = size - 1;
+    for (int i = 0; i < length; i++) {
+        char c = word[i];
+        out[i] = (c >= 'a' && c <= 'z') ? (char)(c - 32) : c;
+    }
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,62 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+// Hangman word list. A dictionary file (one word per line) is memory-mapped
+// and indexed in place: the words stay in the mapping and the index is a
+// few flat arrays, with no allocation per word. Words are grouped by
+// rare-letter class and then by length, so every (class, length range)
+// is one contiguous run and a random word of a given difficulty is an O(1)
+// pick. A word's letter-presence mask is cheap to recompute from the
+// mapping, so only the bucket is stored per word. Words are UTF-8; lengths
+// are in bytes, and only ASCII letters are case-folded or counted as rare.
+
+#include "rng.h"
+#include "thread_pool.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HANGMAN_MAX_WORD 48             // longer lines are skipped
+#define HANGMAN_RARE_LETTERS "JKQVXZ"   // words using any of these are "rare"
+
+typedef enum {
+    HANGMAN_RARE_ANY = -1,
+    HANGMAN_RARE_NONE = 0,
+    HANGMAN_RARE_SOME = 1
+} HangmanRareFilter;
+
+typedef struct {
+    const char *data;
+    size_t size;
+    bool mapped;            // data is a file mapping
+    bool owned;             // data was read into a heap buffer
+    uint32_t count;         // words indexed
+    uint32_t *offsets;      // start of each word in data, in file order
+    uint8_t *buckets;       // (rare class, length) bucket of each word
+    uint32_t *order;        // word indices grouped by bucket
+    uint32_t bucketStart[2 * (HANGMAN_MAX_WORD + 1) + 1];
+} HangmanDictionary;
+
+// Function declarations
+// Indexing runs on pool when given; the result is the same either way
+bool HangmanDictionaryLoad(HangmanDictionary *dict, const char *path, ThreadPool *pool);
+bool HangmanDictionaryLoadMemory(HangmanDictionary *dict, const char *data, size_t size,
+                                 ThreadPool *pool); // data must outlive dict
+void HangmanDictionaryFree(HangmanDictionary *dict);
+
+// Random word index with length in [minLength, maxLength]; -1 if none match
+int64_t HangmanDictionaryPick(const HangmanDictionary *dict, GameRng *rng,
+                              int minLength, int maxLength, HangmanRareFilter rare);
+
+// Word indices with one length and rare class, as a run of dict->order;
+// returns the run's size
+uint32_t HangmanDictionaryBucket(const HangmanDictionary *dict, int length, int rare,
+                                 const uint32_t **indices);
+
+int HangmanDictionaryLength(const HangmanDictionary *dict, uint32_t index);
+uint32_t HangmanDictionaryLetters(const HangmanDictionary *dict, uint32_t index); // ASCII only, bit 0 = 'A'
+
+// Copy word index upper-cased into out; returns its length
+int HangmanDictionaryWord(const HangmanDictionary *dict, uint32_t index, char *out, int size);
+
+#endif // DICTIONARY_H
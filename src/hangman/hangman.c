@@ -1,133 +1,140 @@
 #include "hangman.h"
-#include <string.h>
 #include <stdlib.h>
 #include <time.h>
-#include <ctype.h>
-
-// Game variables
-static const char* words[] = {
-    "RAYLIB", "PROGRAMMING", "HANGMAN", "COMPUTER", "KEYBOARD",
-    "DEVELOPER", "SOFTWARE", "VARIABLE", "FUNCTION", "POINTER"
-};
-static const int wordsCount = 10;
 
 // Screen width for drawing
 static const int screenWidth = 800;
 
-void PlayHangman(void) {
-    // Game variables
-    char secretWord[50] = {0};
-    char guessedWord[50] = {0};
-    char usedLetters[26] = {0};
-    int usedCount = 0;
-    int mistakes = 0;
-    const int maxMistakes = 6;
-    HangmanGameState gameState = GAME_PLAYING;
+// Game plus its display text, rebuilt only when a guess lands
+typedef struct {
+    HangmanGame game;
+    bool evil;                      // candidates answer each guess
+    HangmanCandidates candidates;
+    ThreadPool *pool;
+    int textUsedCount;
+    char guessedWord[HANGMAN_TEXT_SIZE];
+    char secretWord[HANGMAN_TEXT_SIZE];
+    char usedLetters[HANGMAN_USED_SIZE];
+} HangmanScene;
+
+static void UpdateHangmanText(HangmanScene *scene) {
+    const HangmanGame *game = &scene->game;
+    HangmanWordText(game, false, scene->guessedWord, sizeof(scene->guessedWord));
+    HangmanWordText(game, true, scene->secretWord, sizeof(scene->secretWord));
+    HangmanUsedText(game, scene->usedLetters, sizeof(scene->usedLetters));
+    scene->textUsedCount = game->usedCount;
+}
+
+static void *HangmanSceneInit(void) {
+    HangmanScene *scene = calloc(1, sizeof(HangmanScene));
+    if (!scene) return NULL;
+    InitHangmanGame(&scene->game, (uint64_t)time(NULL));
+    UpdateHangmanText(scene);
+    return scene;
+}
+
+static void *EvilHangmanSceneInit(void) {
+    HangmanScene *scene = calloc(1, sizeof(HangmanScene));
+    if (!scene) return NULL;
     
-    // Select a random word
-    srand((unsigned int)time(NULL));
-    strcpy(secretWord, words[rand() % wordsCount]);
+    // Large dictionaries are partitioned on every core
+    scene->pool = ThreadPoolCreate(0);
+    scene->evil = HangmanEvilInit(&scene->game, &scene->candidates, HangmanGetDictionary(),
+                                  (uint64_t)time(NULL), scene->pool);
+    UpdateHangmanText(scene);
+    return scene;
+}
+
+static void HangmanSceneUpdate(void *state, SceneStack *stack) {
+    HangmanScene *scene = state;
+    HangmanGame *game = &scene->game;
     
-    // Initialize guessed word with underscores
-    int len = (int)strlen(secretWord);
-    for (int i = 0; i < len; i++)
-        guessedWord[i] = (secretWord[i] == ' ') ? ' ' : '_';
-    guessedWord[len] = '\0';
+    // Check for exit
+    if (IsKeyPressed(KEY_ESCAPE)) {
+        ScenePop(stack);
+        return;
+    }
     
-    // Game loop
-    while (!WindowShouldClose()) {
-        // Check for exit
-        if (IsKeyPressed(KEY_ESCAPE)) {
-            break;
-        }
-        
-        // Update
-        if (gameState == GAME_PLAYING) {
-            // Check for letter input
-            int key = GetKeyPressed();
-            if (key == KEY_ESCAPE) {
-                break;
-            }
-            
-            if (key >= 'A' && key <= 'Z') key += 32; // Convert to lowercase
-            
-            if (key >= 'a' && key <= 'z') {
-                // Check if letter was already used
-                int alreadyUsed = 0;
-                for (int i = 0; i < usedCount; i++) {
-                    if (usedLetters[i] == key) {
-                        alreadyUsed = 1;
-                        break;
-                    }
-                }
-                
-                if (!alreadyUsed) {
-                    usedLetters[usedCount++] = key;
-                    
-                    // Check if letter is in the word
-                    int found = 0;
-                    for (int i = 0; i < len; i++) {
-                        if (tolower(secretWord[i]) == key) {
-                            guessedWord[i] = secretWord[i];
-                            found = 1;
-                        }
-                    }
-                    
-                    if (!found) mistakes++;
-                    
-                    // Check win condition
-                    if (strcmp(secretWord, guessedWord) == 0) {
-                        gameState = GAME_WON;
-                    }
-                    // Check lose condition
-                    else if (mistakes >= maxMistakes) {
-                        gameState = GAME_LOST;
-                    }
-                }
-            }
-        }
-        else if (IsKeyPressed(KEY_ENTER)) {
-            break;
-        }
-        
-        // Draw
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        
-        // Draw hangman
-        DrawRectangle(screenWidth/2 - 100, 100, 200, 20, BROWN);
-        DrawRectangle(screenWidth/2, 120, 20, 200, BROWN);
-        DrawRectangle(screenWidth/2 - 100, 120, 20, 30, BROWN);
-        
-        if (mistakes > 0) DrawCircle(screenWidth/2 - 90, 175, 25, GRAY); // Head
-        if (mistakes > 1) DrawLine(screenWidth/2 - 90, 200, screenWidth/2 - 90, 250, GRAY); // Body
-        if (mistakes > 2) DrawLine(screenWidth/2 - 90, 210, screenWidth/2 - 120, 240, GRAY); // Left arm
-        if (mistakes > 3) DrawLine(screenWidth/2 - 90, 210, screenWidth/2 - 60, 240, GRAY); // Right arm
-        if (mistakes > 4) DrawLine(screenWidth/2 - 90, 250, screenWidth/2 - 120, 290, GRAY); // Left leg
-        if (mistakes > 5) DrawLine(screenWidth/2 - 90, 250, screenWidth/2 - 60, 290, GRAY); // Right leg
-        
-        // Draw word to guess
-        int wordWidth = MeasureText(guessedWord, 40);
-        DrawText(guessedWord, screenWidth/2 - wordWidth/2, 350, 40, BLACK);
-        
-        // Draw used letters
-        if (usedCount > 0) {
-            char usedText[50] = "Used letters: ";
-            strcat(usedText, usedLetters);
-            DrawText(usedText, 20, 450, 20, GRAY);
+    // Update
+    if (game->state == GAME_PLAYING) {
+        // Check for letter input; characters follow the keyboard layout
+        int codepoint;
+        while ((codepoint = GetCharPressed()) > 0) {
+            if (scene->evil) HangmanEvilGuess(game, &scene->candidates, codepoint);
+            else HangmanGuess(game, codepoint);
         }
-        
-        // Draw game over or win message
-        if (gameState == GAME_LOST) {
-            DrawText("GAME OVER!", screenWidth/2 - 100, 400, 30, RED);
-            DrawText(TextFormat("The word was: %s", secretWord), screenWidth/2 - 150, 430, 20, DARKGRAY);
-            DrawText("Press ENTER to return to menu", screenWidth/2 - 180, 460, 20, DARKGRAY);
-        }
-        else if (gameState == GAME_WON) {
-            DrawText("YOU WIN!", screenWidth/2 - 80, 400, 30, GREEN);
-            DrawText("Press ENTER to return to menu", screenWidth/2 - 180, 430, 20, DARKGRAY);
-        }
-        
-        EndDrawing();
+        if (game->usedCount != scene->textUsedCount) UpdateHangmanText(scene);
+    }
+    else if (IsKeyPressed(KEY_ENTER)) {
+        ScenePop(stack);
+    }
+}
+
+static void HangmanSceneDraw(void *state, float alpha) {
+    const HangmanScene *scene = state;
+    const HangmanGame *game = &scene->game;
+    ClearBackground(RAYWHITE);
+    
+    // Draw hangman
+    DrawRectangle(screenWidth/2 - 100, 100, 200, 20, BROWN);
+    DrawRectangle(screenWidth/2, 120, 20, 200, BROWN);
+    DrawRectangle(screenWidth/2 - 100, 120, 20, 30, BROWN);
+    
+    if (game->mistakes > 0) DrawCircle(screenWidth/2 - 90, 175, 25, GRAY); // Head
+    if (game->mistakes > 1) DrawLine(screenWidth/2 - 90, 200, screenWidth/2 - 90, 250, GRAY); // Body
+    if (game->mistakes > 2) DrawLine(screenWidth/2 - 90, 210, screenWidth/2 - 120, 240, GRAY); // Left arm
+    if (game->mistakes > 3) DrawLine(screenWidth/2 - 90, 210, screenWidth/2 - 60, 240, GRAY); // Right arm
+    if (game->mistakes > 4) DrawLine(screenWidth/2 - 90, 250, screenWidth/2 - 120, 290, GRAY); // Left leg
+    if (game->mistakes > 5) DrawLine(screenWidth/2 - 90, 250, screenWidth/2 - 60, 290, GRAY); // Right leg
+    
+    // Draw word to guess
+    int wordWidth = MeasureText(scene->guessedWord, 40);
+    DrawText(scene->guessedWord, screenWidth/2 - wordWidth/2, 350, 40, BLACK);
+    
+    // Draw used letters
+    if (game->usedCount > 0) {
+        DrawText(TextFormat("Used letters: %s", scene->usedLetters), 20, 450, 20, GRAY);
+    }
+    
+    // Draw game over or win message
+    if (game->state == GAME_LOST) {
+        DrawText("GAME OVER!", screenWidth/2 - 100, 400, 30, RED);
+        DrawText(TextFormat("The word was: %s", scene->secretWord), screenWidth/2 - 150, 430, 20, DARKGRAY);
+        DrawText("Press ENTER to return to menu", screenWidth/2 - 180, 460, 20, DARKGRAY);
+    }
+    else if (game->state == GAME_WON) {
+        DrawText("YOU WIN!", screenWidth/2 - 80, 400, 30, GREEN);
+        DrawText("Press ENTER to return to menu", screenWidth/2 - 180, 430, 20, DARKGRAY);
     }
 }
+
+static void HangmanSceneShutdown(void *state) {
+    HangmanScene *scene = state;
+    if (scene->evil) HangmanCandidatesFree(&scene->candidates);
+    ThreadPoolDestroy(scene->pool);
+    free(scene);
+}
+
+const Scene hangmanScene = {
+    .title = "Hangman",
+    .width = 800,
+    .height = 600,
+    .init = HangmanSceneInit,
+    .update = HangmanSceneUpdate,
+    .draw = HangmanSceneDraw,
+    .shutdown = HangmanSceneShutdown
+};
+
+const Scene evilHangmanScene = {
+    .title = "Evil Hangman",
+    .width = 800,
+    .height = 600,
+    .init = EvilHangmanSceneInit,
+    .update = HangmanSceneUpdate,
+    .draw = HangmanSceneDraw,
+    .shutdown = HangmanSceneShutdown
+};
+
+void PlayHangman(void) {
+    SceneRun(&hangmanScene);
+}
@@ -2,13 +2,14 @@
 #define HANGMAN_H
 
 #include "raylib.h"
+#include "hangman_core.h"
+#include "hangman_solver.h"
+#include "scene.h"
 
-typedef enum {
-    GAME_PLAYING,
-    GAME_WON,
-    GAME_LOST
-} HangmanGameState;
-
+// Function declarations
 void PlayHangman(void);
 
+extern const Scene hangmanScene;
+extern const Scene evilHangmanScene;   // the word dodges your guesses
+
 #endif // HANGMAN_H
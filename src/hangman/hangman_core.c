@@ -0,0 +1,292 @@
+#include "hangman_core.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Built-in word list, used when no dictionary file is configured
+static const char builtinWords[] =
+    "RAYLIB\nPROGRAMMING\nHANGMAN\nCOMPUTER\nKEYBOARD\n"
+    "DEVELOPER\nSOFTWARE\nVARIABLE\nFUNCTION\nPOINTER\n";
+
+// Loaded on first use and kept for the rest of the process
+static HangmanDictionary dictionary;
+static bool dictionaryLoaded = false;
+
+// Length range and rare-letter filter for each difficulty
+static const struct {
+    int minLength, maxLength;
+    HangmanRareFilter rare;
+} difficulties[] = {
+    [HANGMAN_DIFFICULTY_ANY] = { 1, HANGMAN_MAX_WORD, HANGMAN_RARE_ANY },
+    [HANGMAN_DIFFICULTY_EASY] = { 4, 6, HANGMAN_RARE_NONE },
+    [HANGMAN_DIFFICULTY_NORMAL] = { 5, 9, HANGMAN_RARE_ANY },
+    [HANGMAN_DIFFICULTY_HARD] = { 8, HANGMAN_MAX_WORD, HANGMAN_RARE_SOME },
+    [HANGMAN_DIFFICULTY_EVIL] = { 5, 9, HANGMAN_RARE_ANY }
+};
+
+// Decode one UTF-8 sequence and advance past it; a malformed byte decodes
+// as U+FFFD on its own
+static uint32_t DecodeUtf8(const char **text) {
+    const uint8_t *s = (const uint8_t *)*text;
+    uint32_t c = s[0];
+    int extra;
+    if (c < 0x80) {
+        *text += 1;
+        return c;
+    }
+    else if (c >= 0xC2 && c < 0xE0) { extra = 1; c &= 0x1F; }
+    else if (c >= 0xE0 && c < 0xF0) { extra = 2; c &= 0x0F; }
+    else if (c >= 0xF0 && c < 0xF5) { extra = 3; c &= 0x07; }
+    else {
+        *text += 1;
+        return 0xFFFD;
+    }
+    
+    for (int i = 1; i <= extra; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            *text += 1;
+            return 0xFFFD;
+        }
+        c = (c << 6) | (s[i] & 0x3F);
+    }
+    *text += extra + 1;
+    return c;
+}
+
+// Encode one codepoint; returns its length in bytes
+static int EncodeUtf8(uint32_t c, char *out) {
+    if (c < 0x80) {
+        out[0] = (char)c;
+        return 1;
+    }
+    if (c < 0x800) {
+        out[0] = (char)(0xC0 | (c >> 6));
+        out[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    }
+    if (c < 0x10000) {
+        out[0] = (char)(0xE0 | (c >> 12));
+        out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (c >> 18));
+    out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (c & 0x3F));
+    return 4;
+}
+
+// Simple lower-casing for ASCII, Latin-1, Latin Extended-A, Greek and
+// Cyrillic; other scripts are returned unchanged
+uint32_t HangmanFoldCase(uint32_t c) {
+    if (c >= 'A' && c <= 'Z') return c + 32;
+    if (c < 0xC0) return c;
+    if (c <= 0xDE) return (c == 0xD7) ? c : c + 32;
+    if (c >= 0x100 && c <= 0x137) return c | 1;
+    if (c >= 0x139 && c <= 0x148) return (c & 1) ? c + 1 : c;
+    if (c >= 0x14A && c <= 0x177) return c | 1;
+    if (c >= 0x179 && c <= 0x17E) return (c & 1) ? c + 1 : c;
+    if (c >= 0x391 && c <= 0x3A9 && c != 0x3A2) return c + 32;
+    if (c >= 0x400 && c <= 0x40F) return c + 80;
+    if (c >= 0x410 && c <= 0x42F) return c + 32;
+    return c;
+}
+
+// The inverse of HangmanFoldCase, for showing dictionary words upper-cased
+static uint32_t UpperCase(uint32_t c) {
+    if (c >= 'a' && c <= 'z') return c - 32;
+    if (c < 0xE0) return c;
+    if (c <= 0xFE) return (c == 0xF7) ? c : c - 32;
+    if (c >= 0x101 && c <= 0x137) return c & ~1u;
+    if (c >= 0x13A && c <= 0x148) return (c & 1) ? c : c - 1;
+    if (c >= 0x14B && c <= 0x177) return c & ~1u;
+    if (c >= 0x17A && c <= 0x17E) return (c & 1) ? c : c - 1;
+    if (c >= 0x3B1 && c <= 0x3C9 && c != 0x3C2) return c - 32;
+    if (c >= 0x430 && c <= 0x44F) return c - 32;
+    if (c >= 0x450 && c <= 0x45F) return c - 80;
+    return c;
+}
+
+// ASCII letters, plus everything past Latin-1 that is not punctuation or a
+// symbol. Other characters in a phrase are shown from the start.
+bool HangmanIsLetter(uint32_t c) {
+    if (c < 0x80) return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+    if (c < 0xC0 || c == 0xD7 || c == 0xF7) return false;
+    if (c >= 0x2000 && c <= 0x2BFF) return false;   // punctuation, symbols, arrows
+    if (c >= 0x3000 && c <= 0x303F) return false;   // CJK punctuation
+    if (c >= 0xD800 && c <= 0xDFFF) return false;   // surrogates
+    if (c >= 0xFFF0 && c <= 0xFFFF) return false;   // specials, including U+FFFD
+    return true;
+}
+
+// Slot of a case-folded letter in the secret, or -1
+static int FindSlot(const HangmanGame *game, uint32_t letter) {
+    if (letter < 0x80) return game->asciiSlot[letter - 'a'];
+    for (int slot = 0; slot < game->letterCount; slot++) {
+        if (game->letters[slot] == letter) return slot;
+    }
+    return -1;
+}
+
+// The word list from $HANGMAN_DICTIONARY, or the built-in words
+const HangmanDictionary *HangmanGetDictionary(void) {
+    if (!dictionaryLoaded) {
+        const char *path = getenv("HANGMAN_DICTIONARY");
+        bool loaded = false;
+        if (path && path[0]) {
+            ThreadPool *pool = ThreadPoolCreate(0);
+            loaded = HangmanDictionaryLoad(&dictionary, path, pool);
+            ThreadPoolDestroy(pool);
+            if (loaded && dictionary.count == 0) HangmanDictionaryFree(&dictionary);
+            loaded = loaded && dictionary.count > 0;
+        }
+        if (!loaded) {
+            HangmanDictionaryLoadMemory(&dictionary, builtinWords, sizeof(builtinWords) - 1, NULL);
+        }
+        dictionaryLoaded = true;
+    }
+    return &dictionary;
+}
+
+void InitHangmanGame(HangmanGame *game, uint64_t seed) {
+    InitHangmanGameEx(game, seed, HangmanGetDictionary(), HANGMAN_DIFFICULTY_ANY);
+}
+
+void InitHangmanGameEx(HangmanGame *game, uint64_t seed, const HangmanDictionary *dict,
+                       HangmanDifficulty difficulty) {
+    memset(game, 0, sizeof(*game));
+    
+    // Select a random word, from the whole list if none fits the difficulty
+    RngSeed(&game->rng, seed);
+    int64_t index = HangmanDictionaryPick(dict, &game->rng, difficulties[difficulty].minLength,
+                                          difficulties[difficulty].maxLength, difficulties[difficulty].rare);
+    if (index < 0) {
+        index = HangmanDictionaryPick(dict, &game->rng, 1, HANGMAN_MAX_WORD, HANGMAN_RARE_ANY);
+    }
+    
+    char word[HANGMAN_MAX_WORD + 1];
+    bool ok = false;
+    if (index >= 0) {
+        HangmanDictionaryWord(dict, (uint32_t)index, word, sizeof(word));
+        ok = HangmanSetSecret(game, word);
+    }
+    if (!ok) HangmanSetSecret(game, "HANGMAN");
+    
+    // Dictionary words are shown upper-cased, whatever the file has
+    for (int i = 0; i < game->length; i++) {
+        game->word[i] = UpperCase(game->word[i]);
+    }
+}
+
+bool HangmanSetSecret(HangmanGame *game, const char *utf8) {
+    // Start over, keeping only the random state
+    GameRng rng = game->rng;
+    memset(game, 0, sizeof(*game));
+    game->rng = rng;
+    memset(game->asciiSlot, -1, sizeof(game->asciiSlot));
+    game->state = GAME_LOST;    // until the secret is accepted
+    
+    const char *p = utf8;
+    while (*p) {
+        if (game->length == HANGMAN_MAX_LENGTH) return false;
+        int i = game->length++;
+        uint32_t c = DecodeUtf8(&p);
+        game->word[i] = c;
+        uint64_t bit = 1ull << (i % 64);
+        
+        // Spaces and punctuation are visible from the start
+        if (!HangmanIsLetter(c)) {
+            game->revealed[i / 64] |= bit;
+            continue;
+        }
+        
+        uint32_t letter = HangmanFoldCase(c);
+        int slot = FindSlot(game, letter);
+        if (slot < 0) {
+            if (game->letterCount == HANGMAN_MAX_LETTERS) return false;
+            slot = game->letterCount++;
+            game->letters[slot] = letter;
+            if (letter < 0x80) game->asciiSlot[letter - 'a'] = (int8_t)slot;
+        }
+        game->positions[slot][i / 64] |= bit;
+    }
+    if (game->letterCount == 0) return false;
+    
+    game->required = (game->letterCount == 64) ? ~0ull : (1ull << game->letterCount) - 1;
+    game->state = GAME_PLAYING;
+    return true;
+}
+
+void HangmanGuess(HangmanGame *game, int codepoint) {
+    if (game->state != GAME_PLAYING || codepoint <= 0) return;
+    
+    uint32_t letter = HangmanFoldCase((uint32_t)codepoint);
+    if (!HangmanIsLetter(letter)) return;
+    
+    // Check if letter was already used
+    int slot;
+    if (letter < 0x80) {
+        // ASCII: one bit test for repeats and one table load for the slot
+        uint32_t bit = 1u << (letter - 'a');
+        if (game->asciiGuessed & bit) return;
+        game->asciiGuessed |= bit;
+        slot = game->asciiSlot[letter - 'a'];
+    }
+    else {
+        slot = FindSlot(game, letter);
+        if (slot >= 0 && (game->guessed >> slot & 1)) return;
+        if (slot < 0) {
+            for (int i = 0; i < game->usedCount; i++) {
+                if (game->used[i] == letter) return;
+            }
+        }
+    }
+    game->used[game->usedCount++] = letter;
+    
+    // Reveal every position of the letter at once
+    if (slot >= 0) {
+        game->guessed |= 1ull << slot;
+        for (int w = 0; w < HANGMAN_POSITION_WORDS; w++) {
+            game->revealed[w] |= game->positions[slot][w];
+        }
+    }
+    else {
+        game->mistakes++;
+    }
+    
+    // Check win condition
+    if (game->guessed == game->required) {
+        game->state = GAME_WON;
+    }
+    // Check lose condition
+    else if (game->mistakes >= HANGMAN_MAX_MISTAKES) {
+        game->state = GAME_LOST;
+    }
+}
+
+int HangmanWordText(const HangmanGame *game, bool revealAll, char *out, int size) {
+    int bytes = 0;
+    for (int i = 0; i < game->length; i++) {
+        bool shown = revealAll || (game->revealed[i / 64] >> (i % 64) & 1);
+        char buffer[4] = "_";
+        int n = shown ? EncodeUtf8(game->word[i], buffer) : 1;
+        if (bytes + n >= size) break;
+        memcpy(out + bytes, buffer, n);
+        bytes += n;
+    }
+    if (size > 0) out[bytes] = '\0';
+    return bytes;
+}
+
+int HangmanUsedText(const HangmanGame *game, char *out, int size) {
+    int bytes = 0;
+    for (int i = 0; i < game->usedCount; i++) {
+        char buffer[4];
+        int n = EncodeUtf8(game->used[i], buffer);
+        if (bytes + n >= size) break;
+        memcpy(out + bytes, buffer, n);
+        bytes += n;
+    }
+    if (size > 0) out[bytes] = '\0';
+    return bytes;
+}
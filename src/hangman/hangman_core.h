@@ -0,0 +1,83 @@
+#ifndef HANGMAN_CORE_H
+#define HANGMAN_CORE_H
+
+// Raylib-free Hangman rules. The secret is kept as codepoints, and each
+// distinct letter in it gets a slot with a precomputed position bitset, so
+// a guess is a slot lookup plus a bit test, and the win test is a single
+// compare of the guessed-slot mask against the required one. Words and
+// phrases are UTF-8; letters are compared case-folded. Display text is
+// built on request, so a game held by a server carries no strings.
+
+#include "rng.h"
+#include "dictionary.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HANGMAN_MAX_MISTAKES 6
+#define HANGMAN_MAX_LENGTH 256      // codepoints in a word or phrase
+#define HANGMAN_MAX_LETTERS 64      // distinct letters in a word or phrase
+#define HANGMAN_POSITION_WORDS (HANGMAN_MAX_LENGTH / 64)
+
+// Every letter of the secret plus the misses that end the game
+#define HANGMAN_MAX_USED (HANGMAN_MAX_LETTERS + HANGMAN_MAX_MISTAKES)
+
+// UTF-8 text buffers big enough for any game, at most 4 bytes per codepoint
+#define HANGMAN_TEXT_SIZE (HANGMAN_MAX_LENGTH * 4 + 1)
+#define HANGMAN_USED_SIZE (HANGMAN_MAX_USED * 4 + 1)
+
+typedef enum {
+    GAME_PLAYING,
+    GAME_WON,
+    GAME_LOST
+} HangmanGameState;
+
+typedef enum {
+    HANGMAN_DIFFICULTY_ANY,     // any word in the list
+    HANGMAN_DIFFICULTY_EASY,    // short, no rare letters
+    HANGMAN_DIFFICULTY_NORMAL,
+    HANGMAN_DIFFICULTY_HARD,    // long, with rare letters
+    HANGMAN_DIFFICULTY_EVIL     // length for evil mode (see hangman_solver.h)
+} HangmanDifficulty;
+
+typedef struct {
+    // Secret, precomputed once per game
+    uint32_t word[HANGMAN_MAX_LENGTH];      // codepoints as given
+    int length;
+    uint32_t letters[HANGMAN_MAX_LETTERS];  // distinct letters, case-folded
+    int letterCount;
+    int8_t asciiSlot[26];                   // slot of 'a'..'z', or -1
+    uint64_t positions[HANGMAN_MAX_LETTERS][HANGMAN_POSITION_WORDS];
+    uint64_t required;                      // one bit per letter slot
+
+    // Guesses
+    uint64_t guessed;                       // letter slots found so far
+    uint32_t asciiGuessed;                  // every 'a'..'z' tried, bit 0 = 'a'
+    uint64_t revealed[HANGMAN_POSITION_WORDS];
+    uint32_t used[HANGMAN_MAX_USED];        // letters tried, case-folded, in order
+    int usedCount;
+    int mistakes;
+    HangmanGameState state;
+    GameRng rng;
+} HangmanGame;
+
+// Function declarations
+const HangmanDictionary *HangmanGetDictionary(void);
+void InitHangmanGame(HangmanGame *game, uint64_t seed);
+void InitHangmanGameEx(HangmanGame *game, uint64_t seed, const HangmanDictionary *dict,
+                       HangmanDifficulty difficulty);
+
+// Start a game with a given word or phrase; false if it is too long, has
+// too many distinct letters, or has no letters at all
+bool HangmanSetSecret(HangmanGame *game, const char *utf8);
+
+// Guess one letter (any case); anything else, or a repeat, is ignored
+void HangmanGuess(HangmanGame *game, int codepoint);
+
+// UTF-8 text for display; both return the bytes written
+int HangmanWordText(const HangmanGame *game, bool revealAll, char *out, int size); // '_' hides letters
+int HangmanUsedText(const HangmanGame *game, char *out, int size);
+
+uint32_t HangmanFoldCase(uint32_t codepoint);
+bool HangmanIsLetter(uint32_t codepoint);
+
+#endif // HANGMAN_CORE_H
@@ -0,0 +1,469 @@
+#include "hangman_solver.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Patterns of words up to this long index a flat count array; longer
+// ones go through a hash table
+#define DIRECT_PATTERN_BITS 16
+
+// Pattern -> family size, for the words that contain the guessed letter
+// (misses are counted from the bitsets). Direct tables have a counter per
+// possible pattern; otherwise it is open-addressed and 0 marks a free slot.
+struct HangmanPatternTable {
+    bool direct;
+    uint32_t *counts;
+    uint64_t *keys;             // hashed only
+    uint32_t *used;             // hashed only: occupied slots, for clearing
+    uint32_t usedCount;
+    uint32_t mask;
+};
+
+typedef struct {
+    HangmanCandidates *set;
+    uint8_t letter;
+    uint64_t pattern;           // narrowing only
+} SolverJob;
+
+// Words this short pack into 8 bytes and are compared as one uint64_t
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SWAR_LENGTH 8
+#else
+#define SWAR_LENGTH 0
+#endif
+
+// Where letter appears in a packed word, bit i = position i. Padding bytes
+// are zero and never match.
+static inline uint64_t WordPattern(const uint8_t *word, int stride, uint8_t letter) {
+    if (stride == 8) {
+        // High bit of every byte equal to letter, gathered into the low 8 bits
+        const uint64_t low7 = 0x7F7F7F7F7F7F7F7Full;
+        uint64_t x;
+        memcpy(&x, word, 8);
+        x ^= 0x0101010101010101ull * letter;
+        uint64_t zero = ~(((x & low7) + low7) | x | low7);
+        return ((zero >> 7) * 0x0102040810204080ull) >> 56;
+    }
+    
+    uint64_t pattern = 0;
+#if defined(__SSE2__)
+    const __m128i wanted = _mm_set1_epi8((char)letter);
+    for (int i = 0; i < stride; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(word + i));
+        pattern |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, wanted)) << i;
+    }
+#else
+    for (int i = 0; i < stride; i++) pattern |= (uint64_t)(word[i] == letter) << i;
+#endif
+    return pattern;
+}
+
+static inline uint32_t HashPattern(uint64_t pattern) {
+    return (uint32_t)((pattern * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static bool InitTable(HangmanPatternTable *table, int length, uint32_t count) {
+    if (length <= DIRECT_PATTERN_BITS) {
+        table->direct = true;
+        table->mask = (1u << length) - 1;
+        table->counts = calloc(table->mask + 1, sizeof(uint32_t));
+        return table->counts != NULL;
+    }
+    
+    // Distinct patterns are bounded by the candidates; twice that many
+    // slots keeps probes short
+    uint32_t slots = 16;
+    while (slots < 2 * count) slots <<= 1;
+    table->keys = malloc(slots * sizeof(uint64_t));
+    table->counts = calloc(slots, sizeof(uint32_t));
+    table->used = malloc(slots * sizeof(uint32_t));
+    table->mask = slots - 1;
+    return table->keys && table->counts && table->used;
+}
+
+static void FreeTable(HangmanPatternTable *table) {
+    free(table->keys);
+    free(table->counts);
+    free(table->used);
+}
+
+static void ClearTable(HangmanPatternTable *table) {
+    if (table->direct) {
+        memset(table->counts, 0, (table->mask + 1) * sizeof(uint32_t));
+        return;
+    }
+    for (uint32_t i = 0; i < table->usedCount; i++) table->counts[table->used[i]] = 0;
+    table->usedCount = 0;
+}
+
+static inline void CountPattern(HangmanPatternTable *table, uint64_t pattern, uint32_t n) {
+    uint32_t slot = HashPattern(pattern) & table->mask;
+    while (table->counts[slot] && table->keys[slot] != pattern) slot = (slot + 1) & table->mask;
+    if (!table->counts[slot]) {
+        table->keys[slot] = pattern;
+        table->used[table->usedCount++] = slot;
+    }
+    table->counts[slot] += n;
+}
+
+// Bitset words per parallel task
+#define CHUNK_WORDS (HANGMAN_SOLVER_CHUNK / 64)
+
+static inline uint32_t ChunkCount(const HangmanCandidates *set) {
+    return (set->bitWords + CHUNK_WORDS - 1) / CHUNK_WORDS;
+}
+
+static inline const uint64_t *LetterBits(const HangmanCandidates *set, int l) {
+    return set->contains + (size_t)l * set->bitWords;
+}
+
+static inline const uint8_t *SlotWord(const HangmanCandidates *set, uint32_t slot) {
+    return set->words + (size_t)slot * set->stride;
+}
+
+// Count the patterns of the surviving words that contain the letter
+static void PartitionChunk(void *arg, int chunk, int worker) {
+    const SolverJob *job = arg;
+    const HangmanCandidates *set = job->set;
+    HangmanPatternTable *table = &set->tables[worker];
+    const uint64_t *has = LetterBits(set, job->letter - 'a');
+    uint32_t begin = (uint32_t)chunk * CHUNK_WORDS;
+    uint32_t end = begin + CHUNK_WORDS;
+    if (end > set->bitWords) end = set->bitWords;
+    
+    for (uint32_t w = begin; w < end; w++) {
+        uint64_t bits = set->alive[w] & has[w];
+        if (!bits) continue;
+        
+        if (table->direct) {
+            // Branch-free over the whole word of slots: the rest count as
+            // pattern 0, which is never read
+            uint32_t slots = set->size - w * 64 < 64 ? set->size - w * 64 : 64;
+            const uint8_t *word = SlotWord(set, w * 64);
+            for (uint32_t b = 0; b < slots; b++, word += set->stride) {
+                uint64_t take = 0 - ((bits >> b) & 1);
+                table->counts[WordPattern(word, set->stride, job->letter) & take]++;
+            }
+            continue;
+        }
+        while (bits) {
+            uint32_t slot = w * 64 + (uint32_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+            CountPattern(table, WordPattern(SlotWord(set, slot), set->stride, job->letter), 1);
+        }
+    }
+}
+
+// Drop the surviving words that contain the letter in the wrong places
+static void NarrowChunk(void *arg, int chunk, int worker) {
+    (void)worker;
+    const SolverJob *job = arg;
+    HangmanCandidates *set = job->set;
+    const uint64_t *has = LetterBits(set, job->letter - 'a');
+    const int stride = set->stride;
+    const uint8_t letter = job->letter;
+    const uint64_t pattern = job->pattern;
+    uint32_t begin = (uint32_t)chunk * CHUNK_WORDS;
+    uint32_t end = begin + CHUNK_WORDS;
+    if (end > set->bitWords) end = set->bitWords;
+    
+    uint32_t kept = 0;
+    for (uint32_t w = begin; w < end; w++) {
+        uint64_t bits = set->alive[w] & has[w];
+        uint64_t keep = 0;
+        if (bits) {
+            // Branch-free over the whole word of slots, then masked
+            uint32_t slots = set->size - w * 64 < 64 ? set->size - w * 64 : 64;
+            const uint8_t *word = SlotWord(set, w * 64);
+            for (uint32_t b = 0; b < slots; b++, word += stride) {
+                uint64_t match = WordPattern(word, stride, letter) == pattern;
+                keep |= match << b;
+            }
+            keep &= bits;
+        }
+        set->alive[w] = keep;
+        kept += (uint32_t)__builtin_popcountll(keep);
+    }
+    set->kept[chunk] = kept;
+}
+
+// Survivor and per-letter bitsets for slots 0..size-1, all alive
+static void RebuildBits(HangmanCandidates *set) {
+    set->bitWords = (set->size + 63) / 64;
+    memset(set->alive, 0, set->bitWords * sizeof(uint64_t));
+    memset(set->contains, 0, 26 * (size_t)set->bitWords * sizeof(uint64_t));
+    for (uint32_t slot = 0; slot < set->size; slot++) {
+        uint64_t bit = 1ull << (slot % 64);
+        set->alive[slot / 64] |= bit;
+        for (uint32_t m = set->letters[slot]; m; m &= m - 1) {
+            set->contains[(size_t)__builtin_ctz(m) * set->bitWords + slot / 64] |= bit;
+        }
+    }
+}
+
+// Move the survivors to the front, in order, and rebuild the bitsets
+static void Compact(HangmanCandidates *set) {
+    uint32_t n = 0;
+    for (uint32_t w = 0; w < set->bitWords; w++) {
+        for (uint64_t bits = set->alive[w]; bits; bits &= bits - 1) {
+            uint32_t slot = w * 64 + (uint32_t)__builtin_ctzll(bits);
+            if (slot != n) {
+                memcpy(set->words + (size_t)n * set->stride, SlotWord(set, slot), set->stride);
+                set->ids[n] = set->ids[slot];
+                set->letters[n] = set->letters[slot];
+            }
+            n++;
+        }
+    }
+    set->size = n;
+    RebuildBits(set);
+}
+
+static uint8_t FoldLetter(int letter) {
+    return (letter >= 'A' && letter <= 'Z') ? (uint8_t)(letter + 32) : (uint8_t)letter;
+}
+
+bool HangmanCandidatesInit(HangmanCandidates *set, const HangmanDictionary *dict, int length,
+                           ThreadPool *pool) {
+    memset(set, 0, sizeof(*set));
+    if (length < 1 || length > HANGMAN_MAX_WORD) return false;
+    set->length = length;
+    set->stride = length <= SWAR_LENGTH ? 8 : (length + 15) & ~15;
+    set->pool = pool;
+    
+    const uint32_t *runs[2];
+    uint32_t sizes[2];
+    for (int rare = 0; rare < 2; rare++) {
+        sizes[rare] = HangmanDictionaryBucket(dict, length, rare, &runs[rare]);
+    }
+    uint32_t total = sizes[0] + sizes[1];
+    if (total == 0) return false;
+    
+    int workers = ThreadPoolSize(pool);
+    uint32_t bitWords = (total + 63) / 64;
+    set->words = calloc(total, set->stride);
+    set->ids = malloc(total * sizeof(uint32_t));
+    set->letters = malloc(total * sizeof(uint32_t));
+    set->alive = malloc(bitWords * sizeof(uint64_t));
+    set->contains = malloc(26 * (size_t)bitWords * sizeof(uint64_t));
+    set->kept = malloc((bitWords / CHUNK_WORDS + 1) * sizeof(uint32_t));
+    set->tables = calloc(workers, sizeof(HangmanPatternTable));
+    if (!set->words || !set->ids || !set->letters || !set->alive || !set->contains ||
+        !set->kept || !set->tables) {
+        HangmanCandidatesFree(set);
+        return false;
+    }
+    
+    // Pack lower-cased; words with non-ASCII bytes sit out
+    uint32_t count = 0;
+    for (int rare = 0; rare < 2; rare++) {
+        for (uint32_t r = 0; r < sizes[rare]; r++) {
+            uint32_t index = runs[rare][r];
+            const uint8_t *word = (const uint8_t *)dict->data + dict->offsets[index];
+            uint8_t *packed = set->words + (size_t)count * set->stride;
+            uint32_t letters = 0;
+            int i = 0;
+            while (i < length && word[i] < 0x80) {
+                packed[i] = word[i] | 0x20;
+                letters |= 1u << (packed[i] - 'a');
+                i++;
+            }
+            if (i < length) {
+                memset(packed, 0, set->stride);
+                continue;
+            }
+            set->ids[count] = index;
+            set->letters[count++] = letters;
+        }
+    }
+    set->count = set->size = count;
+    RebuildBits(set);
+    
+    bool ok = count > 0;
+    for (int w = 0; w < workers && ok; w++) ok = InitTable(&set->tables[w], length, count);
+    
+    if (!ok) HangmanCandidatesFree(set);
+    return ok;
+}
+
+void HangmanCandidatesFree(HangmanCandidates *set) {
+    if (set->tables) {
+        for (int w = 0; w < ThreadPoolSize(set->pool); w++) FreeTable(&set->tables[w]);
+    }
+    free(set->tables);
+    free(set->words);
+    free(set->ids);
+    free(set->letters);
+    free(set->alive);
+    free(set->contains);
+    free(set->kept);
+    memset(set, 0, sizeof(*set));
+}
+
+// Largest family; ties go to fewer revealed positions, then the lower
+// pattern, so the answer does not depend on the thread count
+static inline void ConsiderFamily(uint64_t pattern, uint32_t n, uint64_t *worst, uint32_t *worstSize) {
+    if (n < *worstSize) return;
+    if (n == *worstSize) {
+        int bits = __builtin_popcountll(pattern), worstBits = __builtin_popcountll(*worst);
+        if (bits > worstBits || (bits == worstBits && pattern > *worst)) return;
+    }
+    *worst = pattern;
+    *worstSize = n;
+}
+
+// Survivors whose word contains the letter
+static uint32_t CountHits(const HangmanCandidates *set, int l) {
+    const uint64_t *has = LetterBits(set, l);
+    uint32_t hits = 0;
+    for (uint32_t w = 0; w < set->bitWords; w++) {
+        hits += (uint32_t)__builtin_popcountll(set->alive[w] & has[w]);
+    }
+    return hits;
+}
+
+uint64_t HangmanCandidatesWorst(HangmanCandidates *set, int letter, uint32_t *size) {
+    SolverJob job = { set, FoldLetter(letter), 0 };
+    if (job.letter < 'a' || job.letter > 'z') {
+        if (size) *size = set->count;
+        return 0;
+    }
+    
+    // No hit family can outgrow misses that are at least half the set, and
+    // a tie goes to the miss, so only read words when hits are the majority
+    uint32_t hits = CountHits(set, job.letter - 'a');
+    uint32_t misses = set->count - hits;
+    if (misses >= hits) {
+        if (size) *size = misses;
+        return 0;
+    }
+    ThreadPoolParallelFor(set->pool, (int)ChunkCount(set), PartitionChunk, &job);
+    
+    // Fold every worker's counts into the first table
+    HangmanPatternTable *total = &set->tables[0];
+    for (int w = 1; w < ThreadPoolSize(set->pool); w++) {
+        HangmanPatternTable *table = &set->tables[w];
+        if (total->direct) {
+            for (uint32_t p = 1; p <= total->mask; p++) total->counts[p] += table->counts[p];
+        }
+        else {
+            for (uint32_t i = 0; i < table->usedCount; i++) {
+                uint32_t slot = table->used[i];
+                CountPattern(total, table->keys[slot], table->counts[slot]);
+            }
+        }
+        ClearTable(table);
+    }
+    
+    uint64_t worst = 0;
+    uint32_t worstSize = misses;
+    if (total->direct) {
+        for (uint32_t p = 1; p <= total->mask; p++) {
+            ConsiderFamily(p, total->counts[p], &worst, &worstSize);
+        }
+    }
+    else {
+        for (uint32_t i = 0; i < total->usedCount; i++) {
+            uint32_t slot = total->used[i];
+            ConsiderFamily(total->keys[slot], total->counts[slot], &worst, &worstSize);
+        }
+    }
+    ClearTable(total);
+    
+    if (size) *size = worstSize;
+    return worst;
+}
+
+void HangmanCandidatesNarrow(HangmanCandidates *set, int letter, uint64_t pattern) {
+    SolverJob job = { set, FoldLetter(letter), pattern };
+    if (job.letter < 'a' || job.letter > 'z') return;
+    int l = job.letter - 'a';
+    
+    if (pattern == 0) {
+        // A miss keeps the words without the letter: bitset work only
+        const uint64_t *has = LetterBits(set, l);
+        uint32_t count = 0;
+        for (uint32_t w = 0; w < set->bitWords; w++) {
+            set->alive[w] &= ~has[w];
+            count += (uint32_t)__builtin_popcountll(set->alive[w]);
+        }
+        set->count = count;
+    }
+    else {
+        uint32_t chunks = ChunkCount(set);
+        ThreadPoolParallelFor(set->pool, (int)chunks, NarrowChunk, &job);
+        uint32_t count = 0;
+        for (uint32_t c = 0; c < chunks; c++) count += set->kept[c];
+        set->count = count;
+    }
+    set->guessed |= 1u << l;
+    set->revealed |= pattern;
+    
+    if (set->count * 4 <= set->size) Compact(set);
+}
+
+uint64_t HangmanCandidatesGuess(HangmanCandidates *set, int letter) {
+    uint64_t pattern = HangmanCandidatesWorst(set, letter, NULL);
+    HangmanCandidatesNarrow(set, letter, pattern);
+    return pattern;
+}
+
+int HangmanCandidatesBestGuess(HangmanCandidates *set) {
+    // Minimax against the adversary: the smallest worst family, and a hit
+    // over a miss of the same size
+    int best = -1;
+    uint32_t bestSize = UINT32_MAX;
+    bool bestMiss = true;
+    for (int l = 0; l < 26; l++) {
+        if (set->guessed & (1u << l)) continue;
+        uint32_t size;
+        bool miss = HangmanCandidatesWorst(set, 'a' + l, &size) == 0;
+        if (size < bestSize || (size == bestSize && bestMiss && !miss)) {
+            best = 'a' + l;
+            bestSize = size;
+            bestMiss = miss;
+        }
+    }
+    return best;
+}
+
+// Make the first candidate the secret and replay the guesses so far. Every
+// survivor agrees with them, so revealed letters and mistakes stay the same.
+static void ReseatSecret(HangmanGame *game, const HangmanCandidates *set) {
+    uint32_t w = 0;
+    while (w < set->bitWords && !set->alive[w]) w++;
+    if (w == set->bitWords) return;
+    const uint8_t *packed = SlotWord(set, w * 64 + (uint32_t)__builtin_ctzll(set->alive[w]));
+    
+    char word[HANGMAN_MAX_WORD + 1];
+    for (int i = 0; i < set->length; i++) word[i] = (char)(packed[i] - 32);
+    word[set->length] = '\0';
+    
+    uint32_t used[HANGMAN_MAX_USED];
+    int usedCount = game->usedCount;
+    memcpy(used, game->used, usedCount * sizeof(uint32_t));
+    HangmanSetSecret(game, word);
+    for (int i = 0; i < usedCount; i++) HangmanGuess(game, (int)used[i]);
+}
+
+bool HangmanEvilInit(HangmanGame *game, HangmanCandidates *set, const HangmanDictionary *dict,
+                     uint64_t seed, ThreadPool *pool) {
+    InitHangmanGameEx(game, seed, dict, HANGMAN_DIFFICULTY_EVIL);
+    if (!HangmanCandidatesInit(set, dict, game->length, pool)) return false;
+    ReseatSecret(game, set);
+    return true;
+}
+
+void HangmanEvilGuess(HangmanGame *game, HangmanCandidates *set, int codepoint) {
+    if (game->state == GAME_PLAYING && codepoint > 0) {
+        uint32_t letter = HangmanFoldCase((uint32_t)codepoint);
+        if (letter >= 'a' && letter <= 'z' && !(set->guessed & (1u << (letter - 'a')))) {
+            HangmanCandidatesGuess(set, (int)letter);
+            ReseatSecret(game, set);
+        }
+    }
+    HangmanGuess(game, codepoint);
+}
@@ -0,0 +1,67 @@
+#ifndef HANGMAN_SOLVER_H
+#define HANGMAN_SOLVER_H
+
+// Evil Hangman and a guessing bot, over every dictionary word of one length.
+// Candidates are packed lower-case and zero padded to 8 bytes (compared
+// as one uint64_t) or a multiple of 16 (SIMD compares and a movemask), so
+// where a letter falls in a word, its pattern, costs a handful of
+// instructions. Survivors are a bitset over the packed slots,
+// with one more bitset per letter for the slots whose word contains it.
+// A guess therefore counts its misses with popcounts, and only reads the
+// words that contain the letter, and only when the hits could outnumber
+// the misses. The slots are compacted once fewer than a quarter survive,
+// so later guesses only touch what is left. Pattern counting and
+// narrowing split the bitsets into chunks on a ThreadPool. Only ASCII
+// words take part.
+
+#include "hangman_core.h"
+#include "thread_pool.h"
+
+#define HANGMAN_SOLVER_CHUNK 16384      // candidates per parallel task
+
+typedef struct HangmanPatternTable HangmanPatternTable;
+
+typedef struct {
+    int length;                 // letters per word
+    int stride;                 // bytes per packed word
+    uint32_t count;             // surviving candidates
+    uint32_t size;              // packed slots, surviving or not
+    uint8_t *words;             // size * stride bytes
+    uint32_t *ids;              // dictionary index of each slot
+    uint32_t *letters;          // letters in each slot's word, bit 0 = 'a'
+    uint32_t bitWords;          // uint64_t words per bitset
+    uint64_t *alive;            // slots still in the running
+    uint64_t *contains;         // 26 bitsets, slots whose word has the letter
+    uint32_t guessed;           // letters tried, bit 0 = 'a'
+    uint64_t revealed;          // positions shown so far
+    ThreadPool *pool;           // NULL runs on the calling thread
+    HangmanPatternTable *tables;    // pattern counts, one per worker
+    uint32_t *kept;             // survivors per chunk while narrowing
+} HangmanCandidates;
+
+// Function declarations
+bool HangmanCandidatesInit(HangmanCandidates *set, const HangmanDictionary *dict, int length,
+                           ThreadPool *pool);
+void HangmanCandidatesFree(HangmanCandidates *set);
+
+// Largest family for letter; ties go to the pattern revealing least.
+// Returns its pattern (bit i = position i, 0 = a miss) and its size.
+uint64_t HangmanCandidatesWorst(HangmanCandidates *set, int letter, uint32_t *size);
+
+// Keep the candidates whose pattern for letter matches
+void HangmanCandidatesNarrow(HangmanCandidates *set, int letter, uint64_t pattern);
+
+// Adversary's answer: narrow to the worst family and return its pattern
+uint64_t HangmanCandidatesGuess(HangmanCandidates *set, int letter);
+
+// Bot: the untried letter whose worst family is smallest, or -1
+int HangmanCandidatesBestGuess(HangmanCandidates *set);
+
+// Evil Hangman on a HangmanGame: the secret is always one of the surviving
+// candidates, and moves to another after each guess. Init returns false,
+// leaving an ordinary game, when no ASCII word has the picked length.
+bool HangmanEvilInit(HangmanGame *game, HangmanCandidates *set, const HangmanDictionary *dict,
+                     uint64_t seed, ThreadPool *pool);
+void HangmanEvilGuess(HangmanGame *game, HangmanCandidates *set, int codepoint);
+
+#endif // HANGMAN_SOLVER_H
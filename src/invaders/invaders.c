@@ -1,316 +1,275 @@
 #include "invaders.h"
+#include "particles.h"
+#include "replay.h"
+#include "scene.h"
+#include "rlgl.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include <math.h>
 
-// Screen dimensions
-#define SCREEN_WIDTH 800
-#define SCREEN_HEIGHT 600
+// Draw title screen
+void DrawTitleScreen(void) {
+    DrawText("SPACE INVADERS", INVADERS_SCREEN_WIDTH/2 - MeasureText("SPACE INVADERS", 50)/2, 150, 50, WHITE);
+    DrawText("Press ENTER to Start", INVADERS_SCREEN_WIDTH/2 - MeasureText("Press ENTER to Start", 30)/2, 300, 30, WHITE);
+    DrawText("ARROW KEYS to Move, SPACE to Shoot", INVADERS_SCREEN_WIDTH/2 - MeasureText("ARROW KEYS to Move, SPACE to Shoot", 20)/2, 350, 20, WHITE);
+}
 
-// Game constants
-#define PLAYER_WIDTH 60
-#define PLAYER_HEIGHT 20
-#define BULLET_WIDTH 4
-#define BULLET_HEIGHT 15
-#define INVADER_ROWS 5
-#define INVADER_COLS 11
-#define INVADER_WIDTH 40
-#define INVADER_HEIGHT 30
-#define INVADER_PADDING 10
+// Draw game over screen
+void DrawGameOverScreen(int score) {
+    char scoreText[50];
+    sprintf(scoreText, "GAME OVER - SCORE: %d", score);
+    DrawText(scoreText, INVADERS_SCREEN_WIDTH/2 - MeasureText(scoreText, 40)/2, 200, 40, WHITE);
+    DrawText("Press ENTER to Play Again", INVADERS_SCREEN_WIDTH/2 - MeasureText("Press ENTER to Play Again", 30)/2, 300, 30, WHITE);
+    DrawText("Press ESC to Return to Menu", INVADERS_SCREEN_WIDTH/2 - MeasureText("Press ESC to Return to Menu", 20)/2, 350, 20, WHITE);
+}
 
-// Initialize game
-void InitGame(Game *game) {
-    // Initialize player
-    game->player = (Player){
-        .position = (Vector2){SCREEN_WIDTH/2 - PLAYER_WIDTH/2, SCREEN_HEIGHT - 50},
-        .width = PLAYER_WIDTH,
-        .height = PLAYER_HEIGHT,
-        .speed = 5,
-        .alive = true
-    };
-    
-    // Initialize bullets
-    for (int i = 0; i < 10; i++) {
-        game->bullets[i] = (Bullet){
-            .position = (Vector2){0, 0},
-            .speed = 7,
-            .active = false,
-            .width = BULLET_WIDTH,
-            .height = BULLET_HEIGHT
-        };
-    }
-    
-    // Initialize invaders
-    for (int row = 0; row < 5; row++) {
-        for (int col = 0; col < 11; col++) {
-            int index = row * 11 + col;
-            game->invaders[index].position = (Vector2){
-                100 + col * (INVADER_WIDTH + INVADER_PADDING),
-                50 + row * (INVADER_HEIGHT + INVADER_PADDING)
-            };
-            game->invaders[index].alive = true;
-            
-            // Different colors and points for different rows
-            if (row == 0) {
-                game->invaders[index].color = RED;
-                game->invaders[index].points = 30;
-            } else if (row < 3) {
-                game->invaders[index].color = PINK;
-                game->invaders[index].points = 20;
-            } else {
-                game->invaders[index].color = GREEN;
-                game->invaders[index].points = 10;
-            }
-        }
-    }
-    
-    // Initialize game state
-    game->score = 0;
-    game->lives = 3;
-    game->state = INVADERS_TITLE;
-    game->invaderDirection = 1;
-    game->invaderMoveTimer = 0.0f;
-    game->invaderMoveInterval = 0.5f;
-    game->bulletCooldown = 0.0f;
+// Row color, derived from the points the row is worth
+static Color InvaderColor(int points) {
+    if (points >= 30) return RED;
+    if (points >= 20) return PINK;
+    return GREEN;
 }
 
-// Reset game
-void ResetGame(Game *game) {
-    InitGame(game);
+// Atlas tiles; the sprites are flat colored, so each tile is a small
+// solid square sampled at its center
+enum {
+    SPRITE_INVADER_30,
+    SPRITE_INVADER_20,
+    SPRITE_INVADER_10,
+    SPRITE_PLAYER,
+    SPRITE_BULLET,
+    SPRITE_SHOT,
+    SPRITE_COUNT
+};
+#define SPRITE_TILE 4
+
+static int InvaderSprite(int points) {
+    if (points >= 30) return SPRITE_INVADER_30;
+    if (points >= 20) return SPRITE_INVADER_20;
+    return SPRITE_INVADER_10;
 }
 
-// Fire a bullet
-void FireBullet(Game *game) {
-    if (game->bulletCooldown <= 0) {
-        for (int i = 0; i < 10; i++) {
-            if (!game->bullets[i].active) {
-                game->bullets[i].position = (Vector2){
-                    game->player.position.x + game->player.width/2 - BULLET_WIDTH/2,
-                    game->player.position.y - BULLET_HEIGHT
-                };
-                game->bullets[i].active = true;
-                game->bulletCooldown = 0.3f; // Cooldown in seconds
-                break;
-            }
-        }
+void InitInvadersRenderCache(InvadersRenderCache *cache) {
+    const Color colors[SPRITE_COUNT] = { RED, PINK, GREEN, WHITE, GREEN, YELLOW };
+    
+    *cache = (InvadersRenderCache){ .score = -1, .lives = -1 };
+    Image atlas = GenImageColor(SPRITE_TILE * SPRITE_COUNT, SPRITE_TILE, BLANK);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        ImageDrawRectangle(&atlas, i * SPRITE_TILE, 0, SPRITE_TILE, SPRITE_TILE, colors[i]);
     }
+    cache->atlas = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
 }
 
-// Update bullets
-void UpdateBullets(Game *game) {
-    for (int i = 0; i < 10; i++) {
-        if (game->bullets[i].active) {
-            game->bullets[i].position.y -= game->bullets[i].speed;
-            
-            // Deactivate bullet if it goes off screen
-            if (game->bullets[i].position.y < 0) {
-                game->bullets[i].active = false;
-            }
-        }
-    }
+void UnloadInvadersRenderCache(InvadersRenderCache *cache) {
+    if (cache->atlas.id != 0) UnloadTexture(cache->atlas);
+    cache->atlas.id = 0;
+}
+
+// Append one textured quad to the current RL_QUADS batch
+static void PushSprite(int sprite, float x, float y, float width, float height) {
+    float u = (sprite * SPRITE_TILE + SPRITE_TILE * 0.5f) / (SPRITE_TILE * SPRITE_COUNT);
     
-    // Update bullet cooldown
-    if (game->bulletCooldown > 0) {
-        game->bulletCooldown -= GetFrameTime();
-    }
+    // Starts a new batch when the current one is full
+    rlCheckRenderBatchLimit(4);
+    rlTexCoord2f(u, 0.5f); rlVertex2f(x, y);
+    rlTexCoord2f(u, 0.5f); rlVertex2f(x, y + height);
+    rlTexCoord2f(u, 0.5f); rlVertex2f(x + width, y + height);
+    rlTexCoord2f(u, 0.5f); rlVertex2f(x + width, y);
 }
 
-// Update invaders
-void UpdateInvaders(Game *game) {
-    game->invaderMoveTimer += GetFrameTime();
+// Draw the game; alpha blends moving objects between the last two ticks.
+// With a cache the whole scene is one quad stream on one atlas texture.
+void DrawGame(const Game *game, InvadersRenderCache *cache, float alpha) {
+    const InvaderSwarm *swarm = &game->swarm;
+    float playerX = game->player.prevX + (game->player.x - game->player.prevX) * alpha;
     
-    if (game->invaderMoveTimer >= game->invaderMoveInterval) {
-        game->invaderMoveTimer = 0.0f;
+    if (cache && cache->atlas.id != 0) {
+        rlSetTexture(cache->atlas.id);
+        rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
         
-        bool moveDown = false;
-        float minX = SCREEN_WIDTH;
-        float maxX = 0;
-        float maxY = 0;
+        // Draw player
+        PushSprite(SPRITE_PLAYER, playerX, game->player.y,
+                   (float)game->player.width, (float)game->player.height);
         
-        // Find the boundaries of the invaders
-        for (int i = 0; i < 55; i++) {
-            if (game->invaders[i].alive) {
-                if (game->invaders[i].position.x < minX) minX = game->invaders[i].position.x;
-                if (game->invaders[i].position.x > maxX) maxX = game->invaders[i].position.x + INVADER_WIDTH;
-                if (game->invaders[i].position.y > maxY) maxY = game->invaders[i].position.y;
-                
-                // Check if any invader has reached the sides
-                if ((game->invaders[i].position.x <= 10 && game->invaderDirection < 0) ||
-                    (game->invaders[i].position.x + INVADER_WIDTH >= SCREEN_WIDTH - 10 && game->invaderDirection > 0)) {
-                    moveDown = true;
-                }
+        // Draw the live shots of both sides
+        const ProjectilePool *pool = &game->projectiles;
+        for (int i = 0; i < pool->count; i++) {
+            float y = pool->prevY[i] + (pool->y[i] - pool->prevY[i]) * alpha;
+            if (pool->owner[i] == PROJECTILE_PLAYER) {
+                PushSprite(SPRITE_BULLET, pool->x[i], y, BULLET_WIDTH, BULLET_HEIGHT);
+            } else {
+                PushSprite(SPRITE_SHOT, pool->x[i], y, INVADER_SHOT_WIDTH, INVADER_SHOT_HEIGHT);
             }
         }
         
-        // Move invaders down and reverse direction if needed
-        if (moveDown) {
-            game->invaderDirection *= -1;
-            for (int i = 0; i < 55; i++) {
-                if (game->invaders[i].alive) {
-                    game->invaders[i].position.y += 10;
+        // Draw invaders straight from the SoA arrays, one row at a time
+        for (int row = 0; row < swarm->rows; row++) {
+            int sprite = InvaderSprite(InvaderPoints(swarm, row * swarm->cols));
+            int end = (row + 1) * swarm->cols;
+            for (int i = row * swarm->cols; i < end; i++) {
+                if (swarm->alive[i >> 6] & (1ull << (i & 63))) {
+                    PushSprite(sprite, swarm->x[i], swarm->y[i], INVADER_WIDTH, INVADER_HEIGHT);
                 }
             }
-        } else {
-            // Move invaders horizontally
-            for (int i = 0; i < 55; i++) {
-                if (game->invaders[i].alive) {
-                    game->invaders[i].position.x += 10 * game->invaderDirection;
-                }
+        }
+        
+        rlEnd();
+        rlSetTexture(0);
+    } else {
+        // Draw player
+        DrawRectangleRec((Rectangle){playerX, game->player.y, 
+                                   (float)game->player.width, (float)game->player.height}, WHITE);
+        
+        // Draw the live shots of both sides
+        const ProjectilePool *pool = &game->projectiles;
+        for (int i = 0; i < pool->count; i++) {
+            float y = pool->prevY[i] + (pool->y[i] - pool->prevY[i]) * alpha;
+            if (pool->owner[i] == PROJECTILE_PLAYER) {
+                DrawRectangleRec((Rectangle){pool->x[i], y, BULLET_WIDTH, BULLET_HEIGHT}, GREEN);
+            } else {
+                DrawRectangleRec((Rectangle){pool->x[i], y, INVADER_SHOT_WIDTH, INVADER_SHOT_HEIGHT}, YELLOW);
             }
         }
         
-        // Check if invaders reached the bottom
-        if (maxY + INVADER_HEIGHT >= game->player.position.y) {
-            game->state = INVADERS_GAME_OVER;
+        // Draw invaders
+        for (int i = 0; i < swarm->count; i++) {
+            if (swarm->alive[i >> 6] & (1ull << (i & 63))) {
+                DrawRectangleRec((Rectangle){swarm->x[i], swarm->y[i],
+                                           INVADER_WIDTH, INVADER_HEIGHT}, InvaderColor(InvaderPoints(swarm, i)));
+            }
         }
     }
-}
-
-// Check collisions
-void CheckCollisions(Game *game) {
-    // Check bullet-invader collisions
-    for (int b = 0; b < 10; b++) {
-        if (game->bullets[b].active) {
-            for (int i = 0; i < 55; i++) {
-                if (game->invaders[i].alive &&
-                    game->bullets[b].position.x < game->invaders[i].position.x + INVADER_WIDTH &&
-                    game->bullets[b].position.x + BULLET_WIDTH > game->invaders[i].position.x &&
-                    game->bullets[b].position.y < game->invaders[i].position.y + INVADER_HEIGHT &&
-                    game->bullets[b].position.y + BULLET_HEIGHT > game->invaders[i].position.y) {
-                    
-                    // Hit an invader
-                    game->invaders[i].alive = false;
-                    game->bullets[b].active = false;
-                    game->score += game->invaders[i].points;
-                    
-                    // Check if all invaders are dead
-                    bool allDead = true;
-                    for (int j = 0; j < 55; j++) {
-                        if (game->invaders[j].alive) {
-                            allDead = false;
-                            break;
-                        }
-                    }
-                    
-                    if (allDead) {
-                        // Level complete, reset with faster invaders
-                        ResetGame(game);
-                        game->invaderMoveInterval = fmax(0.2f, game->invaderMoveInterval - 0.05f);
-                    }
-                    
-                    break;
-                }
-            }
+    
+    // Draw score and lives; the strings are rebuilt only when they change
+    if (cache) {
+        if (cache->score != game->score) {
+            cache->score = game->score;
+            snprintf(cache->scoreText, sizeof(cache->scoreText), "SCORE: %d", game->score);
         }
+        if (cache->lives != game->lives) {
+            cache->lives = game->lives;
+            snprintf(cache->livesText, sizeof(cache->livesText), "LIVES: %d", game->lives);
+        }
+        DrawText(cache->scoreText, 20, 20, 20, WHITE);
+        DrawText(cache->livesText, INVADERS_SCREEN_WIDTH - 120, 20, 20, WHITE);
+    } else {
+        DrawText(TextFormat("SCORE: %d", game->score), 20, 20, 20, WHITE);
+        DrawText(TextFormat("LIVES: %d", game->lives), INVADERS_SCREEN_WIDTH - 120, 20, 20, WHITE);
     }
 }
 
-// Draw title screen
-void DrawTitleScreen(void) {
-    DrawText("SPACE INVADERS", SCREEN_WIDTH/2 - MeasureText("SPACE INVADERS", 50)/2, 150, 50, WHITE);
-    DrawText("Press ENTER to Start", SCREEN_WIDTH/2 - MeasureText("Press ENTER to Start", 30)/2, 300, 30, WHITE);
-    DrawText("ARROW KEYS to Move, SPACE to Shoot", SCREEN_WIDTH/2 - MeasureText("ARROW KEYS to Move, SPACE to Shoot", 20)/2, 350, 20, WHITE);
+// Translate this frame's keyboard state into core input bits
+unsigned int ReadInvadersInput(void) {
+    unsigned int input = 0;
+    if (IsKeyPressed(KEY_ENTER)) input |= INVADERS_INPUT_START;
+    if (IsKeyDown(KEY_LEFT)) input |= INVADERS_INPUT_LEFT;
+    if (IsKeyDown(KEY_RIGHT)) input |= INVADERS_INPUT_RIGHT;
+    if (IsKeyDown(KEY_SPACE)) input |= INVADERS_INPUT_FIRE;
+    return input;
 }
 
-// Draw game over screen
-void DrawGameOverScreen(int score) {
-    char scoreText[50];
-    sprintf(scoreText, "GAME OVER - SCORE: %d", score);
-    DrawText(scoreText, SCREEN_WIDTH/2 - MeasureText(scoreText, 40)/2, 200, 40, WHITE);
-    DrawText("Press ENTER to Play Again", SCREEN_WIDTH/2 - MeasureText("Press ENTER to Play Again", 30)/2, 300, 30, WHITE);
-    DrawText("Press ESC to Return to Menu", SCREEN_WIDTH/2 - MeasureText("Press ESC to Return to Menu", 20)/2, 350, 20, WHITE);
-}
+// Scene state: the game plus its recording
+typedef struct {
+    Game game;
+    ReplayWriter replay;
+    InvadersRenderCache cache;
+    ParticlePool particles;
+    unsigned int keys;      // keyboard bits read this frame
+    unsigned int pressed;   // key presses not yet consumed by a tick
+} InvadersScene;
 
-// Draw game
-void DrawGame(Game *game) {
-    // Draw player
-    DrawRectangleRec((Rectangle){game->player.position.x, game->player.position.y, 
-                               (float)game->player.width, (float)game->player.height}, WHITE);
+static void *InvadersSceneInit(void) {
+    InvadersScene *scene = calloc(1, sizeof(InvadersScene));
+    if (!scene) return NULL;
     
-    // Draw bullets
-    for (int i = 0; i < 10; i++) {
-        if (game->bullets[i].active) {
-            DrawRectangleRec((Rectangle){game->bullets[i].position.x, game->bullets[i].position.y,
-                                       (float)game->bullets[i].width, (float)game->bullets[i].height}, GREEN);
-        }
-    }
+    uint64_t seed = (uint64_t)time(NULL);
+    InitGame(&scene->game, seed);
     
-    // Draw invaders
-    for (int i = 0; i < 55; i++) {
-        if (game->invaders[i].alive) {
-            DrawRectangleRec((Rectangle){game->invaders[i].position.x, game->invaders[i].position.y,
-                                       INVADER_WIDTH, INVADER_HEIGHT}, game->invaders[i].color);
-        }
+    // Record the session so it can be re-simulated headless
+    ReplayHeader header = { REPLAY_GAME_INVADERS, 0, REPLAY_TICK_RATE, seed };
+    char replayPath[256];
+    if (ReplayMakePath(replayPath, sizeof(replayPath), "invaders", seed)) {
+        ReplayWriterOpen(&scene->replay, replayPath, &header);
     }
     
-    // Draw score and lives
-    char scoreText[20];
-    sprintf(scoreText, "SCORE: %d", game->score);
-    DrawText(scoreText, 20, 20, 20, WHITE);
-    
-    char livesText[20];
-    sprintf(livesText, "LIVES: %d", game->lives);
-    DrawText(livesText, SCREEN_WIDTH - 120, 20, 20, WHITE);
+    InitInvadersRenderCache(&scene->cache);
+    ParticlesInit(&scene->particles, 0, seed);
+    return scene;
 }
 
-// Update game
-void UpdateGame(Game *game) {
-    if (IsKeyPressed(KEY_ENTER)) {
-        if (game->state == INVADERS_TITLE) {
-            game->state = INVADERS_PLAYING;
-        } else if (game->state == INVADERS_GAME_OVER) {
-            ResetGame(game);
-            game->state = INVADERS_PLAYING;
-        }
+static void InvadersSceneUpdate(void *state, SceneStack *stack) {
+    InvadersScene *scene = state;
+    
+    // Check for ESC to return to menu
+    if (IsKeyPressed(KEY_ESCAPE)) {
+        ScenePop(stack);
+        return;
     }
     
-    if (game->state != INVADERS_PLAYING) return;
+    // Key presses are latched until a tick consumes them; held keys
+    // apply to every tick of the frame
+    scene->keys = ReadInvadersInput();
+    scene->pressed |= scene->keys & INVADERS_INPUT_START;
+}
+
+static void InvadersSceneTick(void *state, float dt) {
+    InvadersScene *scene = state;
+    unsigned int input = (scene->keys & ~INVADERS_INPUT_START) | scene->pressed;
+    scene->pressed = 0;
+    StepInvadersGame(&scene->game, input, dt);
+    ReplayWriterPush(&scene->replay, (uint8_t)input);
     
-    // Player movement
-    if (IsKeyDown(KEY_LEFT) && game->player.position.x > 0) {
-        game->player.position.x -= game->player.speed;
-    }
-    if (IsKeyDown(KEY_RIGHT) && game->player.position.x < SCREEN_WIDTH - game->player.width) {
-        game->player.position.x += game->player.speed;
+    // An explosion where each invader was shot
+    const Game *game = &scene->game;
+    int kills = game->killCount < INVADERS_MAX_KILLS ? game->killCount : INVADERS_MAX_KILLS;
+    for (int k = 0; k < kills; k++) {
+        const InvaderKill *kill = &game->kills[k];
+        ParticlesBurst(&scene->particles, kill->x, kill->y, INVADER_WIDTH, INVADER_HEIGHT, 400, 220.0f, 0.8f,
+                       ParticleColor(InvaderColor(kill->points)));
     }
+    ParticlesUpdate(&scene->particles, dt);
+}
+
+static void InvadersSceneDraw(void *state, float alpha) {
+    InvadersScene *scene = state;
+    ClearBackground(BLACK);
     
-    // Shooting
-    if (IsKeyDown(KEY_SPACE)) {
-        FireBullet(game);
+    if (scene->game.state == INVADERS_TITLE) {
+        DrawTitleScreen();
+    } else if (scene->game.state == INVADERS_GAME_OVER) {
+        DrawGameOverScreen(scene->game.score);
+    } else {
+        DrawGame(&scene->game, &scene->cache, alpha);
     }
-    
-    UpdateBullets(game);
-    UpdateInvaders(game);
-    CheckCollisions(game);
+    DrawParticles(&scene->particles, 2.0f);
+    DrawParticleCounter(&scene->particles, 20, 45);
+}
+
+static void InvadersSceneShutdown(void *state) {
+    InvadersScene *scene = state;
+    ReplayWriterClose(&scene->replay, scene->game.score);
+    FreeGame(&scene->game);
+    UnloadInvadersRenderCache(&scene->cache);
+    ParticlesFree(&scene->particles);
+    free(scene);
 }
 
+const Scene invadersScene = {
+    .title = "Space Invaders",
+    .width = INVADERS_SCREEN_WIDTH,
+    .height = INVADERS_SCREEN_HEIGHT,
+    .tickRate = REPLAY_TICK_RATE,
+    .init = InvadersSceneInit,
+    .update = InvadersSceneUpdate,
+    .tick = InvadersSceneTick,
+    .draw = InvadersSceneDraw,
+    .shutdown = InvadersSceneShutdown
+};
+
 // Main game function
 void PlayInvaders(void) {
-    Game game;
-    InitGame(&game);
-    
-    while (!WindowShouldClose()) {
-        // Update
-        UpdateGame(&game);
-        
-        // Draw
-        BeginDrawing();
-        ClearBackground(BLACK);
-        
-        if (game.state == INVADERS_TITLE) {
-            DrawTitleScreen();
-        } else if (game.state == INVADERS_GAME_OVER) {
-            DrawGameOverScreen(game.score);
-        } else {
-            DrawGame(&game);
-        }
-        
-        EndDrawing();
-        
-        // Check for ESC to return to menu
-        if (IsKeyPressed(KEY_ESCAPE) && game.state == INVADERS_GAME_OVER) {
-            break;
-        }
-    }
+    SceneRun(&invadersScene);
 }
@@ -2,65 +2,28 @@
 #define INVADERS_H
 
 #include "raylib.h"
+#include "invaders_core.h"
+#include "scene.h"
 
-// Game states
-typedef enum {
-    INVADERS_TITLE,
-    INVADERS_PLAYING,
-    INVADERS_GAME_OVER
-} InvadersGameState;
-
-// Player structure
-typedef struct {
-    Vector2 position;
-    int width;
-    int height;
-    int speed;
-    bool alive;
-} Player;
-
-// Bullet structure
-typedef struct {
-    Vector2 position;
-    int speed;
-    bool active;
-    int width;
-    int height;
-} Bullet;
-
-// Invader structure
-typedef struct {
-    Vector2 position;
-    bool alive;
-    Color color;
-    int points;
-} Invader;
-
-// Game structure
+// Renderer state: every sprite lives in one small atlas texture so the
+// player, bullets and swarm go out as a single batched quad stream, and the
+// HUD strings are rebuilt only when their values change
 typedef struct {
-    Player player;
-    Bullet bullets[10];
-    Invader invaders[55]; // 11 columns x 5 rows
-    int score;
-    int lives;
-    InvadersGameState state;
-    int invaderDirection;
-    float invaderMoveTimer;
-    float invaderMoveInterval;
-    float bulletCooldown;
-} Game;
+    Texture2D atlas;
+    int score, lives;
+    char scoreText[32];
+    char livesText[32];
+} InvadersRenderCache;
 
 // Function declarations
-void InitGame(Game *game);
-void UpdateGame(Game *game);
-void DrawGame(Game *game);
-void ResetGame(Game *game);
-void FireBullet(Game *game);
-void UpdateBullets(Game *game);
-void UpdateInvaders(Game *game);
-void CheckCollisions(Game *game);
+unsigned int ReadInvadersInput(void);
+void InitInvadersRenderCache(InvadersRenderCache *cache);     // needs a window
+void UnloadInvadersRenderCache(InvadersRenderCache *cache);
+void DrawGame(const Game *game, InvadersRenderCache *cache, float alpha); // cache may be NULL
 void DrawTitleScreen(void);
 void DrawGameOverScreen(int score);
 void PlayInvaders(void);
 
+extern const Scene invadersScene;
+
 #endif // INVADERS_H
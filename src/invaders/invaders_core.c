@@ -0,0 +1,465 @@
+#include "invaders_core.h"
+#include "simd.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Points for an invader, by formation row
+int InvaderPoints(const InvaderSwarm *swarm, int index) {
+    int row = index / swarm->cols;
+    if (row == 0) return 30;
+    if (row < 3) return 20;
+    return 10;
+}
+
+static bool InvaderAlive(const InvaderSwarm *swarm, int index) {
+    return (swarm->alive[index >> 6] >> (index & 63)) & 1;
+}
+
+// Rebuild every column's lowest live row and the live column set from the
+// alive bits
+void InvadersSwarmSyncColumns(InvaderSwarm *swarm) {
+    swarm->liveColumnCount = 0;
+    for (int col = 0; col < swarm->cols; col++) {
+        int row = swarm->rows - 1;
+        while (row >= 0 && !InvaderAlive(swarm, row * swarm->cols + col)) row--;
+        swarm->lowest[col] = row;
+        
+        uint64_t bit = 1ull << (col & 63);
+        if (row >= 0) {
+            swarm->liveColumns[col >> 6] |= bit;
+            swarm->liveColumnCount++;
+        } else {
+            swarm->liveColumns[col >> 6] &= ~bit;
+        }
+    }
+}
+
+// Put every invader back in formation. Large formations are squeezed into
+// the same area, so invaders may overlap.
+static void ResetSwarm(InvaderSwarm *swarm) {
+    swarm->aliveCount = 0;
+    swarm->liveColumnCount = 0;
+    if (swarm->count == 0) return;
+    
+    float pitchX = INVADER_WIDTH + INVADER_PADDING;
+    float pitchY = INVADER_HEIGHT + INVADER_PADDING;
+    if (pitchX * swarm->cols > INVADERS_SCREEN_WIDTH - 200) pitchX = (INVADERS_SCREEN_WIDTH - 200) / (float)swarm->cols;
+    if (pitchY * swarm->rows > INVADERS_SCREEN_HEIGHT / 2 - 50) pitchY = (INVADERS_SCREEN_HEIGHT / 2 - 50) / (float)swarm->rows;
+    
+    swarm->originX = 100;
+    swarm->originY = 50;
+    swarm->pitchX = pitchX;
+    swarm->pitchY = pitchY;
+    for (int row = 0; row < swarm->rows; row++) {
+        for (int col = 0; col < swarm->cols; col++) {
+            int index = row * swarm->cols + col;
+            swarm->x[index] = swarm->originX + col * pitchX;
+            swarm->y[index] = swarm->originY + row * pitchY;
+        }
+    }
+    swarm->aliveCount = swarm->count;
+    
+    int words = (swarm->capacity + 63) / 64;
+    for (int w = 0; w < words; w++) {
+        int first = w * 64;
+        int live = swarm->count - first;
+        swarm->alive[w] = (live >= 64) ? ~0ull : (live > 0 ? (1ull << live) - 1 : 0);
+    }
+    InvadersSwarmSyncColumns(swarm);
+}
+
+// Reset everything but the swarm's storage
+static void ResetState(Game *game, uint64_t seed) {
+    // Initialize player
+    game->player = (Player){
+        .x = INVADERS_SCREEN_WIDTH/2 - PLAYER_WIDTH/2,
+        .y = INVADERS_SCREEN_HEIGHT - 50,
+        .prevX = INVADERS_SCREEN_WIDTH/2 - PLAYER_WIDTH/2,
+        .width = PLAYER_WIDTH,
+        .height = PLAYER_HEIGHT,
+        .speed = 300,
+        .alive = true
+    };
+    
+    // No shots in flight
+    game->projectiles.count = 0;
+    
+    // Initialize invaders
+    ResetSwarm(&game->swarm);
+    
+    // Initialize game state
+    game->score = 0;
+    game->lives = 3;
+    game->killCount = 0;
+    game->state = INVADERS_TITLE;
+    game->invaderDirection = 1;
+    game->invaderMoveTimer = 0.0f;
+    game->invaderMoveInterval = 0.5f;
+    game->invaderFireInterval = 1.0f;
+    game->invaderFireTimer = game->invaderFireInterval;
+    game->bulletCooldown = 0.0f;
+    RngSeed(&game->rng, seed);
+}
+
+// Initialize game with a custom formation; allocates the swarm and the
+// projectile pool
+bool InitGameEx(Game *game, uint64_t seed, InvadersConfig config) {
+    InvaderSwarm *swarm = &game->swarm;
+    swarm->rows = config.rows > 0 ? config.rows : 1;
+    swarm->cols = config.cols > 0 ? config.cols : 1;
+    swarm->count = swarm->rows * swarm->cols;
+    swarm->capacity = SIMD_PAD(swarm->count);
+    
+    // One block: x, y, the alive words, the live column words, then the
+    // lowest row of each column
+    int words = (swarm->capacity + 63) / 64;
+    int columnWords = (swarm->cols + 63) / 64;
+    size_t floatBytes = (size_t)swarm->capacity * sizeof(float);
+    size_t wordBytes = (size_t)(words + columnWords) * sizeof(uint64_t);
+    char *block = calloc(1, 2 * floatBytes + wordBytes + (size_t)swarm->cols * sizeof(int));
+    if (!block) {
+        swarm->rows = swarm->cols = 0;
+        swarm->count = swarm->capacity = 0;
+    }
+    swarm->x = (float *)block;
+    swarm->y = (float *)(block ? block + floatBytes : NULL);
+    swarm->alive = (uint64_t *)(block ? block + 2 * floatBytes : NULL);
+    swarm->liveColumns = block ? swarm->alive + words : NULL;
+    swarm->lowest = (int *)(block ? block + 2 * floatBytes + wordBytes : NULL);
+    
+    // Same for the projectiles: four float arrays, then the owners
+    ProjectilePool *pool = &game->projectiles;
+    pool->count = 0;
+    pool->capacity = SIMD_PAD(config.projectiles > 0 ? config.projectiles : INVADERS_DEFAULT_PROJECTILES);
+    size_t poolFloatBytes = (size_t)pool->capacity * sizeof(float);
+    char *shots = calloc(1, 4 * poolFloatBytes + (size_t)pool->capacity);
+    if (!shots) pool->capacity = 0;
+    pool->x = (float *)shots;
+    pool->y = (float *)(shots ? shots + poolFloatBytes : NULL);
+    pool->prevY = (float *)(shots ? shots + 2 * poolFloatBytes : NULL);
+    pool->vy = (float *)(shots ? shots + 3 * poolFloatBytes : NULL);
+    pool->owner = (uint8_t *)(shots ? shots + 4 * poolFloatBytes : NULL);
+    
+    ResetState(game, seed);
+    return block != NULL && shots != NULL;
+}
+
+// Initialize game with the classic 5 x 11 formation
+void InitGame(Game *game, uint64_t seed) {
+    InitGameEx(game, seed, (InvadersConfig){ INVADER_ROWS, INVADER_COLS, 0 });
+}
+
+void FreeGame(Game *game) {
+    free(game->swarm.x);
+    game->swarm.x = game->swarm.y = NULL;
+    game->swarm.alive = game->swarm.liveColumns = NULL;
+    game->swarm.lowest = NULL;
+    game->swarm.count = game->swarm.capacity = 0;
+    
+    free(game->projectiles.x);
+    game->projectiles = (ProjectilePool){ 0 };
+}
+
+// Reset game, continuing the random stream of the previous one
+void ResetGame(Game *game) {
+    ResetState(game, RngNext64(&game->rng));
+}
+
+// Take the first free slot: the one just past the live projectiles
+int SpawnProjectile(ProjectilePool *pool, ProjectileOwner owner, float x, float y) {
+    if (pool->count == pool->capacity) return -1;
+    
+    int slot = pool->count++;
+    pool->x[slot] = x;
+    pool->y[slot] = y;
+    pool->prevY[slot] = y;
+    pool->vy[slot] = (owner == PROJECTILE_PLAYER) ? -BULLET_SPEED : INVADER_SHOT_SPEED;
+    pool->owner[slot] = (uint8_t)owner;
+    return slot;
+}
+
+// Move the last live projectile into the hole, keeping the live ones packed
+void RemoveProjectile(ProjectilePool *pool, int index) {
+    int last = --pool->count;
+    pool->x[index] = pool->x[last];
+    pool->y[index] = pool->y[last];
+    pool->prevY[index] = pool->prevY[last];
+    pool->vy[index] = pool->vy[last];
+    pool->owner[index] = pool->owner[last];
+}
+
+// Fire a bullet
+void FireBullet(Game *game) {
+    if (game->bulletCooldown <= 0) {
+        float x = game->player.x + game->player.width/2 - BULLET_WIDTH/2;
+        if (SpawnProjectile(&game->projectiles, PROJECTILE_PLAYER, x, game->player.y - BULLET_HEIGHT) >= 0) {
+            game->bulletCooldown = 0.3f; // Cooldown in seconds
+        }
+    }
+}
+
+// Shoot from the lowest live invader of a random column. The column is
+// the k-th live one in column order, so the choice depends only on the
+// alive bits and the random stream, never on the order invaders died in.
+void FireInvaderShot(Game *game) {
+    InvaderSwarm *swarm = &game->swarm;
+    if (swarm->liveColumnCount == 0) return;
+    
+    uint32_t k = RngRange(&game->rng, (uint32_t)swarm->liveColumnCount);
+    int col = 0;
+    for (int w = 0; ; w++) {
+        uint64_t bits = swarm->liveColumns[w];
+        uint32_t live = (uint32_t)__builtin_popcountll(bits);
+        if (k >= live) {
+            k -= live;
+            continue;
+        }
+        while (k--) bits &= bits - 1;
+        col = w * 64 + __builtin_ctzll(bits);
+        break;
+    }
+    
+    int i = swarm->lowest[col] * swarm->cols + col;
+    SpawnProjectile(&game->projectiles, PROJECTILE_INVADER,
+                    swarm->x[i] + INVADER_WIDTH/2 - INVADER_SHOT_WIDTH/2, swarm->y[i] + INVADER_HEIGHT);
+}
+
+// Update bullets
+void UpdateBullets(Game *game, float dt) {
+    ProjectilePool *pool = &game->projectiles;
+    
+    // Every live shot moves at once, four per step; the padding past
+    // count is scratch
+    SimdFloat step = SimdSet1(dt);
+    for (int i = 0; i < pool->count; i += SIMD_WIDTH) {
+        SimdFloat y = SimdLoad(&pool->y[i]);
+        SimdStore(&pool->prevY[i], y);
+        SimdStore(&pool->y[i], SimdAdd(y, SimdMul(SimdLoad(&pool->vy[i]), step)));
+    }
+    
+    // Remove shots that left the screen
+    for (int i = 0; i < pool->count;) {
+        if (pool->y[i] < 0 || pool->y[i] > INVADERS_SCREEN_HEIGHT) {
+            RemoveProjectile(pool, i);
+        } else {
+            i++;
+        }
+    }
+    
+    // Update bullet cooldown
+    if (game->bulletCooldown > 0) {
+        game->bulletCooldown -= dt;
+    }
+}
+
+// Update invaders
+void UpdateInvaders(Game *game, float dt) {
+    // Shoot back
+    game->invaderFireTimer -= dt;
+    if (game->invaderFireTimer <= 0.0f) {
+        game->invaderFireTimer += game->invaderFireInterval;
+        FireInvaderShot(game);
+    }
+    
+    game->invaderMoveTimer += dt;
+    
+    if (game->invaderMoveTimer >= game->invaderMoveInterval) {
+        game->invaderMoveTimer = 0.0f;
+        
+        InvaderSwarm *swarm = &game->swarm;
+        
+        // Find the boundaries of the live invaders: one masked min/max
+        // reduction, four invaders per step
+        const SimdFloat inf = SimdSet1(INFINITY);
+        const SimdFloat negInf = SimdSet1(-INFINITY);
+        SimdFloat minX = inf, maxX = negInf, maxY = negInf;
+        for (int i = 0; i < swarm->capacity; i += SIMD_WIDTH) {
+            unsigned int bits = (unsigned int)(swarm->alive[i >> 6] >> (i & 63)) & 0xF;
+            if (!bits) continue;
+            
+            SimdFloat mask = SimdMaskFromBits(bits);
+            SimdFloat x = SimdLoad(&swarm->x[i]);
+            SimdFloat y = SimdLoad(&swarm->y[i]);
+            minX = SimdMin(minX, SimdSelect(mask, x, inf));
+            maxX = SimdMax(maxX, SimdSelect(mask, x, negInf));
+            maxY = SimdMax(maxY, SimdSelect(mask, y, negInf));
+        }
+        float left = SimdReduceMin(minX);
+        float right = SimdReduceMax(maxX) + INVADER_WIDTH;
+        float bottom = SimdReduceMax(maxY);
+        
+        // Check if any invader has reached the sides
+        bool moveDown = (left <= 10 && game->invaderDirection < 0) ||
+                        (right >= INVADERS_SCREEN_WIDTH - 10 && game->invaderDirection > 0);
+        
+        // The whole swarm moves in lockstep, so dead invaders move too;
+        // that keeps this a single vector add over each array
+        float *moved = moveDown ? swarm->y : swarm->x;
+        SimdFloat step = SimdSet1(moveDown ? 10.0f : 10.0f * game->invaderDirection);
+        for (int i = 0; i < swarm->capacity; i += SIMD_WIDTH) {
+            SimdStore(&moved[i], SimdAdd(SimdLoad(&moved[i]), step));
+        }
+        if (moveDown) {
+            swarm->originY += 10;
+            game->invaderDirection *= -1;
+        } else {
+            swarm->originX += 10 * game->invaderDirection;
+        }
+        
+        // Check if invaders reached the bottom
+        if (bottom + INVADER_HEIGHT >= game->player.y) {
+            game->state = INVADERS_GAME_OVER;
+        }
+    }
+}
+
+// Range of formation cells within [lo, hi) that can overlap a span of
+// length size starting at pos, padded by one cell for rounding
+static void CandidateCells(float pos, float size, float origin, float pitch, float extent,
+                           int cells, int *lo, int *hi) {
+    float local = pos - origin;
+    int first = (int)floorf((local - extent) / pitch);
+    int last = (int)floorf((local + size) / pitch) + 1;
+    *lo = first < 0 ? 0 : first;
+    *hi = last >= cells ? cells : last + 1;
+}
+
+// Kill an invader; when it was its column's shooter, the next live invader
+// up the column takes over
+static void KillInvader(InvaderSwarm *swarm, int index) {
+    swarm->alive[index >> 6] &= ~(1ull << (index & 63));
+    swarm->aliveCount--;
+    
+    int row = index / swarm->cols, col = index % swarm->cols;
+    if (swarm->lowest[col] != row) return;
+    while (--row >= 0 && !InvaderAlive(swarm, row * swarm->cols + col)) {}
+    swarm->lowest[col] = row;
+    if (row < 0) {
+        swarm->liveColumns[col >> 6] &= ~(1ull << (col & 63));
+        swarm->liveColumnCount--;
+    }
+}
+
+// Hit test one player shot against the invaders; true if it hit one
+static bool BulletHitsInvader(Game *game, float x, float y) {
+    InvaderSwarm *swarm = &game->swarm;
+    if (swarm->aliveCount == 0) return false;
+    
+    // Only the few formation cells under the bullet can be hit
+    int colLo, colHi, rowLo, rowHi;
+    CandidateCells(x, BULLET_WIDTH, swarm->originX, swarm->pitchX, INVADER_WIDTH,
+                   swarm->cols, &colLo, &colHi);
+    CandidateCells(y, BULLET_HEIGHT, swarm->originY, swarm->pitchY, INVADER_HEIGHT,
+                   swarm->rows, &rowLo, &rowHi);
+    
+    // Earlier rows first, so the first invader in index order is hit
+    for (int row = rowLo; row < rowHi; row++) {
+        for (int col = colLo; col < colHi; col++) {
+            int i = row * swarm->cols + col;
+            if (InvaderAlive(swarm, i) &&
+                x < swarm->x[i] + INVADER_WIDTH &&
+                x + BULLET_WIDTH > swarm->x[i] &&
+                y < swarm->y[i] + INVADER_HEIGHT &&
+                y + BULLET_HEIGHT > swarm->y[i]) {
+                
+                // Hit an invader
+                KillInvader(swarm, i);
+                game->score += InvaderPoints(swarm, i);
+                if (game->killCount < INVADERS_MAX_KILLS) {
+                    game->kills[game->killCount] = (InvaderKill){ swarm->x[i], swarm->y[i], InvaderPoints(swarm, i) };
+                }
+                game->killCount++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool ShotHitsPlayer(const Player *player, float x, float y) {
+    return player->alive &&
+           x < player->x + player->width && x + INVADER_SHOT_WIDTH > player->x &&
+           y < player->y + player->height && y + INVADER_SHOT_HEIGHT > player->y;
+}
+
+// Wave cleared: the formation comes back, moving faster and shooting more
+// often; score, lives and the random stream carry on
+static void NextWave(Game *game) {
+    ResetSwarm(&game->swarm);
+    game->projectiles.count = 0;
+    game->invaderDirection = 1;
+    game->invaderMoveTimer = 0.0f;
+    game->invaderMoveInterval = fmaxf(0.2f, game->invaderMoveInterval - 0.05f);
+    game->invaderFireInterval = fmaxf(0.1f, game->invaderFireInterval * 0.75f);
+    game->invaderFireTimer = game->invaderFireInterval;
+}
+
+// Check collisions
+void CheckCollisions(Game *game) {
+    ProjectilePool *pool = &game->projectiles;
+    
+    for (int i = 0; i < pool->count;) {
+        bool hit;
+        if (pool->owner[i] == PROJECTILE_PLAYER) {
+            hit = BulletHitsInvader(game, pool->x[i], pool->y[i]);
+        } else {
+            hit = ShotHitsPlayer(&game->player, pool->x[i], pool->y[i]);
+            if (hit && --game->lives <= 0) {
+                game->lives = 0;
+                game->player.alive = false;
+                game->state = INVADERS_GAME_OVER;
+            }
+        }
+        
+        if (!hit) {
+            i++;
+            continue;
+        }
+        RemoveProjectile(pool, i);
+        if (game->state != INVADERS_PLAYING) return;
+        if (game->swarm.aliveCount == 0) {
+            NextWave(game);
+            return;
+        }
+    }
+}
+
+// Start/restart, player movement and firing for one step
+bool StepInvadersInput(Game *game, unsigned int input, float dt) {
+    game->killCount = 0;
+    
+    if (input & INVADERS_INPUT_START) {
+        if (game->state == INVADERS_TITLE) {
+            game->state = INVADERS_PLAYING;
+        } else if (game->state == INVADERS_GAME_OVER) {
+            ResetGame(game);
+            game->state = INVADERS_PLAYING;
+        }
+    }
+    
+    if (game->state != INVADERS_PLAYING) return false;
+    
+    // Player movement
+    game->player.prevX = game->player.x;
+    if ((input & INVADERS_INPUT_LEFT) && game->player.x > 0) {
+        game->player.x -= game->player.speed * dt;
+    }
+    if ((input & INVADERS_INPUT_RIGHT) && game->player.x < INVADERS_SCREEN_WIDTH - game->player.width) {
+        game->player.x += game->player.speed * dt;
+    }
+    
+    // Shooting
+    if (input & INVADERS_INPUT_FIRE) {
+        FireBullet(game);
+    }
+    return true;
+}
+
+// Advance the game by one step
+void StepInvadersGame(Game *game, unsigned int input, float dt) {
+    if (!StepInvadersInput(game, input, dt)) return;
+    
+    UpdateBullets(game, dt);
+    UpdateInvaders(game, dt);
+    CheckCollisions(game);
+}
@@ -0,0 +1,161 @@
+#ifndef INVADERS_CORE_H
+#define INVADERS_CORE_H
+
+// Raylib-free Space Invaders rules, driven by an input bitmask and an
+// explicit dt so they can run (and be replayed) without a window.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "rng.h"
+
+// Playfield dimensions
+#define INVADERS_SCREEN_WIDTH 800
+#define INVADERS_SCREEN_HEIGHT 600
+
+// Game constants
+#define PLAYER_WIDTH 60
+#define PLAYER_HEIGHT 20
+#define BULLET_WIDTH 4
+#define BULLET_HEIGHT 15
+#define BULLET_SPEED 420            // player shots, pixels per second upwards
+#define INVADER_SHOT_WIDTH 4
+#define INVADER_SHOT_HEIGHT 12
+#define INVADER_SHOT_SPEED 240      // invader shots, pixels per second downwards
+#define INVADER_ROWS 5
+#define INVADER_COLS 11
+#define INVADER_WIDTH 40
+#define INVADER_HEIGHT 30
+#define INVADER_PADDING 10
+#define INVADERS_DEFAULT_PROJECTILES 256
+#define INVADERS_MAX_KILLS 16       // kills per step kept for effects
+
+// Game states
+typedef enum {
+    INVADERS_TITLE,
+    INVADERS_PLAYING,
+    INVADERS_GAME_OVER
+} InvadersGameState;
+
+// Input bits for a single simulation step.
+// Left, right and fire are level-triggered (set while held); start is
+// edge-triggered (set only on the tick the key went down).
+typedef enum {
+    INVADERS_INPUT_LEFT  = 1 << 0,
+    INVADERS_INPUT_RIGHT = 1 << 1,
+    INVADERS_INPUT_FIRE  = 1 << 2,
+    INVADERS_INPUT_START = 1 << 3
+} InvadersInput;
+
+// Player structure
+typedef struct {
+    float x, y;
+    float prevX;        // position before the last step, for interpolation
+    int width;
+    int height;
+    float speed;        // pixels per second
+    bool alive;
+} Player;
+
+typedef enum {
+    PROJECTILE_PLAYER = 0,  // moves up and hits invaders
+    PROJECTILE_INVADER      // moves down and hits the player
+} ProjectileOwner;
+
+// Shots of both sides stored as parallel arrays. Live projectiles are
+// packed at [0, count) and removing one moves the last into its place, so
+// the free slots are always the tail [count, capacity): taking one is
+// count++, and every pass touches live projectiles only, however large
+// the pool. Arrays are padded to a whole number of SIMD lanes.
+typedef struct {
+    int count;
+    int capacity;
+    float *x, *y;
+    float *prevY;       // position before the last step, for interpolation
+    float *vy;          // pixels per second, set by the owner
+    uint8_t *owner;     // ProjectileOwner
+} ProjectilePool;
+
+// Formation size; any rows x cols works, large swarms just overlap
+typedef struct {
+    int rows;
+    int cols;
+    int projectiles;    // pool capacity; 0 for INVADERS_DEFAULT_PROJECTILES
+} InvadersConfig;
+
+// Invader swarm stored as parallel arrays. Invader i sits in formation row
+// i / cols. Arrays are padded to a whole number of SIMD lanes; padding
+// entries are never alive.
+//
+// The swarm moves in lockstep, so the formation grid itself is the
+// collision broadphase: invader (row, col) is always near
+// origin + (col * pitchX, row * pitchY), and a move only shifts the origin.
+//
+// Only the lowest live invader of a column shoots. Each column's lowest
+// live row and the set of columns with any invader left are kept as
+// invaders die, so picking a shooter never walks the formation.
+typedef struct {
+    int rows, cols;
+    int count;          // rows * cols
+    int capacity;       // count padded to SIMD_WIDTH
+    int aliveCount;
+    float *x;
+    float *y;
+    uint64_t *alive;    // bit i is set while invader i is alive
+    uint64_t *liveColumns;  // bit c is set while column c has a live invader
+    int *lowest;        // per column: row of its lowest live invader, -1 if none
+    int liveColumnCount;
+    float originX, originY;
+    float pitchX, pitchY;
+} InvaderSwarm;
+
+// An invader shot down: where it was when hit and what it was worth
+typedef struct {
+    float x, y;
+    int points;
+} InvaderKill;
+
+// Game structure
+typedef struct {
+    Player player;
+    ProjectilePool projectiles;
+    InvaderSwarm swarm;
+    int score;
+    int lives;
+    InvadersGameState state;
+    int invaderDirection;
+    float invaderMoveTimer;
+    float invaderMoveInterval;
+    float invaderFireTimer;     // seconds until the next invader shot
+    float invaderFireInterval;  // seconds between invader shots; shorter every wave
+    float bulletCooldown;
+    GameRng rng;
+    
+    // Invaders shot during the last step, for effects only; the count
+    // goes on past INVADERS_MAX_KILLS but only the first are kept
+    InvaderKill kills[INVADERS_MAX_KILLS];
+    int killCount;
+} Game;
+
+// Function declarations
+void InitGame(Game *game, uint64_t seed);
+bool InitGameEx(Game *game, uint64_t seed, InvadersConfig config);
+void FreeGame(Game *game);
+void ResetGame(Game *game);
+int InvaderPoints(const InvaderSwarm *swarm, int index);
+void InvadersSwarmSyncColumns(InvaderSwarm *swarm);    // after writing alive bits directly
+int SpawnProjectile(ProjectilePool *pool, ProjectileOwner owner, float x, float y);   // slot, or -1 when full
+void RemoveProjectile(ProjectilePool *pool, int index);
+void FireBullet(Game *game);
+void FireInvaderShot(Game *game);
+void UpdateBullets(Game *game, float dt);
+void UpdateInvaders(Game *game, float dt);
+void CheckCollisions(Game *game);
+
+// Advance the game by one step of dt seconds using an InvadersInput bitmask
+void StepInvadersGame(Game *game, unsigned int input, float dt);
+
+// The input half of a step; StepInvadersGame then runs UpdateBullets,
+// UpdateInvaders and CheckCollisions, in that order, when this returns true
+bool StepInvadersInput(Game *game, unsigned int input, float dt);
+
+#endif // INVADERS_CORE_H
@@ -0,0 +1,344 @@
+#include "invaders_snapshot.h"
+#include "simd.h"
+
+typedef enum {
+    SECTION_LAYOUT  = 1 << 0,
+    SECTION_PLAYER  = 1 << 1,
+    SECTION_SHOTS   = 1 << 2,
+    SECTION_SWARM   = 1 << 3,
+    SECTION_TIMERS  = 1 << 4,
+    SECTION_ALIVE   = 1 << 5,
+    SECTION_SCORE   = 1 << 6,
+    SECTION_RNG     = 1 << 7,
+    SECTION_ALL     = (1 << 8) - 1
+} InvadersSection;
+
+// Largest formation and projectile pool a snapshot may ask for
+#define MAX_FORMATION (1 << 16)
+#define MAX_PROJECTILES (1 << 16)
+
+static bool SameFloat(float a, float b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static int AliveWords(const InvaderSwarm *swarm) {
+    return (swarm->capacity + 63) / 64;
+}
+
+// True when every invader sits exactly where the formation grid puts it
+static bool OnGrid(const InvaderSwarm *swarm) {
+    for (int i = 0; i < swarm->count; i++) {
+        int row = i / swarm->cols, col = i % swarm->cols;
+        if (!SameFloat(swarm->x[i], swarm->originX + col * swarm->pitchX) ||
+            !SameFloat(swarm->y[i], swarm->originY + row * swarm->pitchY)) return false;
+    }
+    return true;
+}
+
+static bool SameShots(const ProjectilePool *a, const ProjectilePool *b) {
+    size_t floats = (size_t)a->count * sizeof(float);
+    return a->count == b->count && memcmp(a->owner, b->owner, a->count) == 0 &&
+           memcmp(a->x, b->x, floats) == 0 && memcmp(a->y, b->y, floats) == 0 &&
+           memcmp(a->prevY, b->prevY, floats) == 0;
+}
+
+// Sizes and speeds, which only InitGame sets
+static void CopyConstants(Game *to, const Game *from) {
+    to->player.y = from->player.y;
+    to->player.width = from->player.width;
+    to->player.height = from->player.height;
+    to->player.speed = from->player.speed;
+}
+
+// Sections of game that differ from base. Without a base, or when the
+// formation or pool changed size, alive bits are sent against an empty
+// swarm and every shot is sent.
+static uint32_t ChangedSections(const Game *base, const Game *game, bool *fresh) {
+    const InvaderSwarm *swarm = &game->swarm;
+    *fresh = !base || base->swarm.rows != swarm->rows || base->swarm.cols != swarm->cols ||
+             base->projectiles.capacity != game->projectiles.capacity;
+    if (!base) return SECTION_ALL;
+    
+    const InvaderSwarm *before = &base->swarm;
+    uint32_t sections = 0;
+    size_t positions = (size_t)swarm->count * sizeof(float);
+    if (*fresh || memcmp(before->x, swarm->x, positions) != 0 ||
+        memcmp(before->y, swarm->y, positions) != 0) sections |= SECTION_LAYOUT;
+    if (!SameFloat(base->player.x, game->player.x) || !SameFloat(base->player.prevX, game->player.prevX) ||
+        base->player.alive != game->player.alive) sections |= SECTION_PLAYER;
+    if (*fresh || !SameShots(&base->projectiles, &game->projectiles)) sections |= SECTION_SHOTS;
+    if (!SameFloat(before->originX, swarm->originX) || !SameFloat(before->originY, swarm->originY) ||
+        base->invaderDirection != game->invaderDirection ||
+        !SameFloat(base->invaderMoveInterval, game->invaderMoveInterval) ||
+        !SameFloat(base->invaderFireInterval, game->invaderFireInterval)) sections |= SECTION_SWARM;
+    if (!SameFloat(base->invaderMoveTimer, game->invaderMoveTimer) ||
+        !SameFloat(base->invaderFireTimer, game->invaderFireTimer) ||
+        !SameFloat(base->bulletCooldown, game->bulletCooldown)) sections |= SECTION_TIMERS;
+    if (*fresh || memcmp(before->alive, swarm->alive, AliveWords(swarm) * sizeof(uint64_t)) != 0) {
+        sections |= SECTION_ALIVE;
+    }
+    if (base->score != game->score || base->lives != game->lives || base->state != game->state) {
+        sections |= SECTION_SCORE;
+    }
+    if (memcmp(&base->rng, &game->rng, sizeof(GameRng)) != 0) sections |= SECTION_RNG;
+    return sections;
+}
+
+int InvadersSnapshotMaxSize(const Game *game) {
+    int words = AliveWords(&game->swarm);
+    return 37 + 8 * game->swarm.count + 5 + 13 * game->projectiles.capacity + 17 + 12 + 5 + 18 * words + 7 + 16;
+}
+
+static int Encode(const Game *base, const Game *game, uint8_t *out, int size) {
+    bool fresh;
+    uint32_t sections = ChangedSections(base, game, &fresh);
+    const InvaderSwarm *swarm = &game->swarm;
+    uint8_t kind = SNAPSHOT_INVADERS | (base ? SNAPSHOT_DELTA : 0);
+    
+    SnapshotWriter w;
+    SnapshotWriterInit(&w, out, size);
+    SnapshotPutHeader(&w, kind, INVADERS_SNAPSHOT_VERSION, sections);
+    
+    if (sections & SECTION_LAYOUT) {
+        bool onGrid = OnGrid(swarm);
+        SnapshotPutVarint(&w, (uint32_t)swarm->rows);
+        SnapshotPutVarint(&w, (uint32_t)swarm->cols);
+        SnapshotPutVarint(&w, (uint32_t)game->projectiles.capacity);
+        SnapshotPutU8(&w, !onGrid);
+        for (int i = 0; i < swarm->count && !onGrid; i++) {
+            SnapshotPutF32(&w, swarm->x[i]);
+            SnapshotPutF32(&w, swarm->y[i]);
+        }
+    }
+    if (sections & SECTION_PLAYER) {
+        SnapshotPutF32(&w, game->player.x);
+        SnapshotPutF32(&w, game->player.prevX);
+        SnapshotPutU8(&w, game->player.alive);
+    }
+    if (sections & SECTION_SHOTS) {
+        const ProjectilePool *pool = &game->projectiles;
+        SnapshotPutVarint(&w, (uint32_t)pool->count);
+        for (int i = 0; i < pool->count; i++) {
+            SnapshotPutU8(&w, pool->owner[i]);
+            SnapshotPutF32(&w, pool->x[i]);
+            SnapshotPutF32(&w, pool->y[i]);
+            SnapshotPutF32(&w, pool->prevY[i]);
+        }
+    }
+    if (sections & SECTION_SWARM) {
+        SnapshotPutF32(&w, swarm->originX);
+        SnapshotPutF32(&w, swarm->originY);
+        SnapshotPutU8(&w, (uint8_t)(int8_t)game->invaderDirection);
+        SnapshotPutF32(&w, game->invaderMoveInterval);
+        SnapshotPutF32(&w, game->invaderFireInterval);
+    }
+    if (sections & SECTION_TIMERS) {
+        SnapshotPutF32(&w, game->invaderMoveTimer);
+        SnapshotPutF32(&w, game->invaderFireTimer);
+        SnapshotPutF32(&w, game->bulletCooldown);
+    }
+    if (sections & SECTION_ALIVE) {
+        int words = AliveWords(swarm);
+        int changed = 0;
+        for (int i = 0; i < words; i++) {
+            uint64_t before = fresh ? 0 : base->swarm.alive[i];
+            changed += before != swarm->alive[i];
+        }
+        SnapshotPutVarint(&w, (uint32_t)changed);
+        for (int i = 0; i < words; i++) {
+            uint64_t before = fresh ? 0 : base->swarm.alive[i];
+            if (before == swarm->alive[i]) continue;
+            SnapshotPutVarint(&w, (uint32_t)i);
+            SnapshotPutU64(&w, before ^ swarm->alive[i]);
+        }
+    }
+    if (sections & SECTION_SCORE) {
+        SnapshotPutVarint(&w, (uint32_t)game->score);
+        SnapshotPutU8(&w, (uint8_t)game->lives);
+        SnapshotPutU8(&w, (uint8_t)game->state);
+    }
+    if (sections & SECTION_RNG) {
+        for (int i = 0; i < 4; i++) SnapshotPutU32(&w, game->rng.s[i]);
+    }
+    return w.overflow ? 0 : w.size;
+}
+
+// Read a snapshot or delta. Without commit this only validates it and
+// leaves game alone; with commit it applies it, which cannot fail for a
+// stream that validated except when a new formation cannot be allocated.
+static bool Decode(Game *game, const uint8_t *data, int size, uint8_t kind, bool commit) {
+    SnapshotReader r;
+    SnapshotReaderInit(&r, data, size);
+    uint32_t sections;
+    if (!SnapshotGetHeader(&r, kind, INVADERS_SNAPSHOT_VERSION, &sections)) return false;
+    if (sections & ~(uint32_t)SECTION_ALL) return false;
+    bool full = !(kind & SNAPSHOT_DELTA);
+    if (full && sections != SECTION_ALL) return false;
+    
+    // Scalars go to a copy and arrays are written only on commit, so the
+    // game changes all at once at the end
+    Game staged = *game;
+    int rows = game->swarm.rows, cols = game->swarm.cols;
+    int shotCapacity = game->projectiles.capacity;
+    bool fresh = full;
+    bool onGrid = false;
+    int explicitAt = 0;
+    
+    if (sections & SECTION_LAYOUT) {
+        uint64_t newRows = SnapshotGetVarint(&r);
+        uint64_t newCols = SnapshotGetVarint(&r);
+        uint64_t newCapacity = SnapshotGetVarint(&r);
+        if (newRows < 1 || newCols < 1 || newRows * newCols > MAX_FORMATION) return false;
+        if (newCapacity < 1 || newCapacity > MAX_PROJECTILES || newCapacity != SIMD_PAD(newCapacity)) return false;
+        rows = (int)newRows;
+        cols = (int)newCols;
+        shotCapacity = (int)newCapacity;
+        fresh = fresh || rows != game->swarm.rows || cols != game->swarm.cols ||
+                shotCapacity != game->projectiles.capacity;
+        onGrid = SnapshotGetU8(&r) == 0;
+        explicitAt = r.pos;
+        if (!onGrid) r.pos += 8 * rows * cols;
+        if (r.pos > r.size) return false;
+    }
+    if (sections & SECTION_PLAYER) {
+        staged.player.x = SnapshotGetF32(&r);
+        staged.player.prevX = SnapshotGetF32(&r);
+        staged.player.alive = SnapshotGetU8(&r) != 0;
+    }
+    
+    // A resized pool starts empty, so its shots must come along
+    if (fresh && !(sections & SECTION_SHOTS)) return false;
+    int shotsAt = r.pos;
+    int shotCount = game->projectiles.count;
+    if (sections & SECTION_SHOTS) {
+        uint64_t count = SnapshotGetVarint(&r);
+        if (count > (uint64_t)shotCapacity) return false;
+        shotCount = (int)count;
+        for (int i = 0; i < shotCount && !r.error; i++) {
+            if (SnapshotGetU8(&r) > PROJECTILE_INVADER) return false;
+            r.pos += 12;
+            if (r.pos > r.size) return false;
+        }
+    }
+    if (sections & SECTION_SWARM) {
+        staged.swarm.originX = SnapshotGetF32(&r);
+        staged.swarm.originY = SnapshotGetF32(&r);
+        staged.invaderDirection = (int8_t)SnapshotGetU8(&r);
+        staged.invaderMoveInterval = SnapshotGetF32(&r);
+        staged.invaderFireInterval = SnapshotGetF32(&r);
+    }
+    if (sections & SECTION_TIMERS) {
+        staged.invaderMoveTimer = SnapshotGetF32(&r);
+        staged.invaderFireTimer = SnapshotGetF32(&r);
+        staged.bulletCooldown = SnapshotGetF32(&r);
+    }
+    
+    // Alive bits come after the formation is (re)allocated
+    int count = rows * cols;
+    int words = (SIMD_PAD(count) + 63) / 64;
+    int aliveAt = r.pos;
+    if (sections & SECTION_ALIVE) {
+        uint64_t changed = SnapshotGetVarint(&r);
+        if (changed > (uint64_t)words) return false;
+        for (uint64_t i = 0; i < changed; i++) {
+            uint64_t word = SnapshotGetVarint(&r);
+            uint64_t flips = SnapshotGetU64(&r);
+            if (word >= (uint64_t)words) return false;
+            int past = count - (int)word * 64;
+            if (past < 64 && (flips >> past)) return false;   // padding is never alive
+        }
+    }
+    if (sections & SECTION_SCORE) {
+        staged.score = (int)(uint32_t)SnapshotGetVarint(&r);
+        staged.lives = SnapshotGetU8(&r);
+        uint8_t state = SnapshotGetU8(&r);
+        if (state > INVADERS_GAME_OVER) return false;
+        staged.state = (InvadersGameState)state;
+    }
+    if (sections & SECTION_RNG) {
+        for (int i = 0; i < 4; i++) staged.rng.s[i] = SnapshotGetU32(&r);
+    }
+    if (r.error || r.pos != r.size) return false;
+    if (!commit) return true;
+    
+    // A new formation or pool size starts from fresh storage of the right size
+    InvaderSwarm swarm = game->swarm;
+    ProjectilePool pool = game->projectiles;
+    if (rows != swarm.rows || cols != swarm.cols || shotCapacity != pool.capacity) {
+        Game resized;
+        if (!InitGameEx(&resized, 0, (InvadersConfig){ rows, cols, shotCapacity })) {
+            FreeGame(&resized);
+            return false;
+        }
+        FreeGame(game);
+        swarm = resized.swarm;
+        pool = resized.projectiles;
+        CopyConstants(&staged, &resized);
+    }
+    if (sections & SECTION_SHOTS) {
+        SnapshotReader shots;
+        SnapshotReaderInit(&shots, data, size);
+        shots.pos = shotsAt;
+        SnapshotGetVarint(&shots);
+        for (int i = 0; i < shotCount; i++) {
+            pool.owner[i] = SnapshotGetU8(&shots);
+            pool.x[i] = SnapshotGetF32(&shots);
+            pool.y[i] = SnapshotGetF32(&shots);
+            pool.prevY[i] = SnapshotGetF32(&shots);
+            pool.vy[i] = (pool.owner[i] == PROJECTILE_PLAYER) ? -BULLET_SPEED : INVADER_SHOT_SPEED;
+        }
+    }
+    pool.count = shotCount;
+    staged.projectiles = pool;
+    swarm.originX = staged.swarm.originX;
+    swarm.originY = staged.swarm.originY;
+    staged.swarm = swarm;
+    
+    if (sections & SECTION_LAYOUT) {
+        SnapshotReader positions;
+        SnapshotReaderInit(&positions, data, size);
+        positions.pos = explicitAt;
+        for (int i = 0; i < count; i++) {
+            int row = i / cols, col = i % cols;
+            float x = onGrid ? swarm.originX + col * swarm.pitchX : SnapshotGetF32(&positions);
+            float y = onGrid ? swarm.originY + row * swarm.pitchY : SnapshotGetF32(&positions);
+            swarm.x[i] = x;
+            swarm.y[i] = y;
+        }
+    }
+    if (fresh) memset(swarm.alive, 0, (size_t)words * sizeof(uint64_t));
+    if (sections & SECTION_ALIVE) {
+        SnapshotReader alive;
+        SnapshotReaderInit(&alive, data, size);
+        alive.pos = aliveAt;
+        uint64_t changed = SnapshotGetVarint(&alive);
+        for (uint64_t i = 0; i < changed; i++) {
+            uint64_t word = SnapshotGetVarint(&alive);
+            swarm.alive[word] ^= SnapshotGetU64(&alive);
+        }
+    }
+    staged.swarm.aliveCount = 0;
+    for (int i = 0; i < words; i++) staged.swarm.aliveCount += __builtin_popcountll(swarm.alive[i]);
+    if (fresh || (sections & SECTION_ALIVE)) InvadersSwarmSyncColumns(&staged.swarm);
+    
+    *game = staged;
+    return true;
+}
+
+int InvadersSnapshotSave(const Game *game, uint8_t *out, int size) {
+    return Encode(NULL, game, out, size);
+}
+
+bool InvadersSnapshotLoad(Game *game, const uint8_t *data, int size) {
+    return Decode(game, data, size, SNAPSHOT_INVADERS, false) &&
+           Decode(game, data, size, SNAPSHOT_INVADERS, true);
+}
+
+int InvadersDeltaEncode(const Game *base, const Game *game, uint8_t *out, int size) {
+    return Encode(base, game, out, size);
+}
+
+bool InvadersDeltaApply(Game *game, const uint8_t *data, int size) {
+    uint8_t kind = SNAPSHOT_INVADERS | SNAPSHOT_DELTA;
+    return Decode(game, data, size, kind, false) && Decode(game, data, size, kind, true);
+}
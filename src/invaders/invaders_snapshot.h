@@ -0,0 +1,49 @@
+#ifndef INVADERS_SNAPSHOT_H
+#define INVADERS_SNAPSHOT_H
+
+// Versioned snapshots of an invaders Game and deltas between two of them,
+// in the stream format of snapshot.h. Sections, in stream order:
+//   LAYOUT   varint rows, varint cols, varint projectile capacity,
+//            u8 explicit positions, then when set f32 x and f32 y of every
+//            invader; otherwise positions are
+//            origin + (col * pitchX, row * pitchY)
+//   PLAYER   f32 x, f32 previous x, u8 alive
+//   SHOTS    varint live projectiles, then u8 owner, f32 x, f32 y,
+//            f32 previous y for each, in pool order
+//   SWARM    f32 origin x, f32 origin y, i8 direction, f32 move interval,
+//            f32 fire interval
+//   TIMERS   f32 move timer, f32 fire timer, f32 bullet cooldown
+//   ALIVE    varint changed words, then varint word index and u64 of
+//            flipped alive bits for each
+//   SCORE    varint score, u8 lives, u8 state
+//   RNG      4 x u32 generator state
+// Sizes, speeds and pitches are constants the game sets itself, and each
+// column's shooter follows from the alive bits, so they are not stored.
+// The classic formation always sits exactly on its grid, so a snapshot of
+// it is about 100 bytes and a delta is the timers plus whatever moved,
+// died or was fired that tick.
+
+#include "invaders_core.h"
+#include "snapshot.h"
+
+#define INVADERS_SNAPSHOT_VERSION 2
+
+// Function declarations
+
+// Room needed for any snapshot or delta ending at game
+int InvadersSnapshotMaxSize(const Game *game);
+
+// Returns the bytes written, or 0 if size is too small
+int InvadersSnapshotSave(const Game *game, uint8_t *out, int size);
+
+// game must be initialized (or zeroed); its swarm and projectile pool are
+// reallocated when the formation or pool capacity differs. Leaves the
+// game untouched and returns false on a malformed snapshot.
+bool InvadersSnapshotLoad(Game *game, const uint8_t *data, int size);
+
+// What changed from base to game; applying it to a game equal to base
+// makes that game equal to game
+int InvadersDeltaEncode(const Game *base, const Game *game, uint8_t *out, int size);
+bool InvadersDeltaApply(Game *game, const uint8_t *data, int size);
+
+#endif // INVADERS_SNAPSHOT_H
@@ -0,0 +1,85 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+// Game server wire protocol, spoken over a local stream socket.
+//
+// Every message is a u16 payload size, a u8 type, then the payload (all
+// integers little-endian):
+//   client -> server
+//     CREATE   u8 game (ServerGame), u64 seed
+//     INPUT    u32 session, u8 input bits (TetrisInput / InvadersInput)
+//     CLOSE    u32 session
+//     SAVE     u32 session
+//     RESTORE  u8 game, snapshot (tetris_snapshot.h, invaders_snapshot.h)
+//   server -> client
+//     CREATED  u32 session (SERVER_NO_SESSION if refused), u8 game
+//     DELTA    u32 session, u32 tick, then runs of
+//              u8 skip, u8 length, length bytes
+//     SNAPSHOT u32 session, snapshot (empty if the session is not yours)
+//
+// A session's view is a small fixed-layout byte image of what a client
+// needs to draw it (see server.h). A DELTA patches the previous view: each
+// run skips unchanged bytes and replaces the next length bytes. The first
+// DELTA of a session patches an all-zero view. Sessions with no change in
+// a tick send nothing.
+//
+// SAVE and RESTORE move a session between servers: RESTORE of a SAVEd
+// snapshot answers with CREATED, and the new session continues exactly
+// where the old one was.
+//
+// Input bits that are held (soft drop; invaders move and fire) stay in
+// effect until the next INPUT; the rest apply to the next tick only.
+
+#include <stdint.h>
+
+#define PROTOCOL_HEADER_SIZE 3
+#define PROTOCOL_MAX_PAYLOAD 1024
+
+typedef enum {
+    PROTOCOL_CREATE = 1,
+    PROTOCOL_INPUT = 2,
+    PROTOCOL_CLOSE = 3,
+    PROTOCOL_SAVE = 4,
+    PROTOCOL_RESTORE = 5,
+    PROTOCOL_CREATED = 0x81,
+    PROTOCOL_DELTA = 0x82,
+    PROTOCOL_SNAPSHOT = 0x83
+} ProtocolMessage;
+
+static inline void ProtocolPutU16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void ProtocolPutU32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void ProtocolPutU64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline uint16_t ProtocolGetU16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t ProtocolGetU32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static inline uint64_t ProtocolGetU64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+// Message header; returns where the payload goes
+static inline uint8_t *ProtocolPutHeader(uint8_t *p, ProtocolMessage type, uint16_t size) {
+    ProtocolPutU16(p, size);
+    p[2] = (uint8_t)type;
+    return p + PROTOCOL_HEADER_SIZE;
+}
+
+#endif // PROTOCOL_H
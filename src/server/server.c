@@ -0,0 +1,350 @@
+#include "server.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Session id: generation in the top 11 bits, then the game, then the slot
+#define ID_SLOT_BITS 20
+#define ID_GAME_BIT (1u << ID_SLOT_BITS)
+#define ID_GENERATION_SHIFT (ID_SLOT_BITS + 1)
+#define ID_GENERATION_MASK 0x7FF
+
+// Changed bytes closer together than a run header are sent in one run
+#define DELTA_MERGE_GAP 2
+
+static uint32_t MakeId(ServerGame game, uint32_t slot, uint16_t generation) {
+    return ((uint32_t)generation << ID_GENERATION_SHIFT) | (game ? ID_GAME_BIT : 0) | slot;
+}
+
+static void *PoolGame(ServerPool *pool, uint32_t slot) {
+    size_t size = pool->game == SERVER_GAME_TETRIS ? sizeof(TetrisGame) : sizeof(Game);
+    return (char *)pool->games + slot * size;
+}
+
+static bool PoolInit(ServerPool *pool, ServerGame game, int capacity) {
+    memset(pool, 0, sizeof(*pool));
+    pool->game = game;
+    pool->capacity = capacity;
+    if (game == SERVER_GAME_TETRIS) {
+        pool->viewSize = SERVER_TETRIS_VIEW_SIZE;
+        pool->levelInputs = TETRIS_INPUT_SOFT_DROP;
+    }
+    else {
+        pool->viewSize = SERVER_INVADERS_VIEW_BASE + (INVADER_ROWS * INVADER_COLS + 7) / 8;
+        pool->levelInputs = INVADERS_INPUT_LEFT | INVADERS_INPUT_RIGHT | INVADERS_INPUT_FIRE;
+    }
+    
+    size_t gameSize = game == SERVER_GAME_TETRIS ? sizeof(TetrisGame) : sizeof(Game);
+    pool->sessions = calloc(capacity, sizeof(ServerSession));
+    pool->games = calloc(capacity, gameSize);
+    pool->generations = calloc(capacity, sizeof(uint16_t));
+    pool->live = malloc(capacity * sizeof(uint32_t));
+    pool->livePos = malloc(capacity * sizeof(uint32_t));
+    pool->freeSlots = malloc(capacity * sizeof(uint32_t));
+    if (!pool->sessions || !pool->games || !pool->generations || !pool->live ||
+        !pool->livePos || !pool->freeSlots) return false;
+    
+    // Lowest slots are handed out first
+    for (int i = 0; i < capacity; i++) {
+        pool->sessions[i].id = SERVER_NO_SESSION;
+        pool->freeSlots[i] = (uint32_t)(capacity - 1 - i);
+    }
+    pool->freeCount = capacity;
+    return true;
+}
+
+static void PoolRemove(ServerPool *pool, uint32_t slot) {
+    ServerSession *session = &pool->sessions[slot];
+    if (pool->game == SERVER_GAME_INVADERS) FreeGame(PoolGame(pool, slot));
+    session->id = SERVER_NO_SESSION;
+    pool->generations[slot] = (pool->generations[slot] + 1) & ID_GENERATION_MASK;
+    
+    // Swap the last live slot into the hole
+    uint32_t pos = pool->livePos[slot];
+    uint32_t last = pool->live[--pool->count];
+    pool->live[pos] = last;
+    pool->livePos[last] = pos;
+    pool->freeSlots[pool->freeCount++] = slot;
+}
+
+static void PoolFree(ServerPool *pool) {
+    if (pool->sessions && pool->game == SERVER_GAME_INVADERS) {
+        for (int i = 0; i < pool->count; i++) FreeGame(PoolGame(pool, pool->live[i]));
+    }
+    free(pool->sessions);
+    free(pool->games);
+    free(pool->generations);
+    free(pool->live);
+    free(pool->livePos);
+    free(pool->freeSlots);
+    memset(pool, 0, sizeof(*pool));
+}
+
+bool ServerInit(Server *server, int capacity, ThreadPool *threads) {
+    memset(server, 0, sizeof(*server));
+    if (capacity < 1) capacity = 1;
+    if (capacity > SERVER_MAX_SESSIONS) capacity = SERVER_MAX_SESSIONS;
+    server->threads = threads;
+    server->dt = 1.0f / SERVER_TICK_RATE;
+    
+    for (int g = 0; g < SERVER_GAME_COUNT; g++) {
+        if (!PoolInit(&server->pools[g], (ServerGame)g, capacity)) {
+            ServerFree(server);
+            return false;
+        }
+    }
+    return true;
+}
+
+void ServerFree(Server *server) {
+    for (int g = 0; g < SERVER_GAME_COUNT; g++) PoolFree(&server->pools[g]);
+}
+
+uint32_t ServerCreateSession(Server *server, ServerGame game, uint64_t seed, int client) {
+    if ((unsigned int)game >= SERVER_GAME_COUNT) return SERVER_NO_SESSION;
+    ServerPool *pool = &server->pools[game];
+    if (pool->freeCount == 0) return SERVER_NO_SESSION;
+    
+    uint32_t slot = pool->freeSlots[pool->freeCount - 1];
+    if (game == SERVER_GAME_TETRIS) {
+        InitTetrisGame(PoolGame(pool, slot), seed, TETRIS_RANDOMIZER_BAG7);
+    }
+    else if (!InitGameEx(PoolGame(pool, slot), seed, (InvadersConfig){ INVADER_ROWS, INVADER_COLS, 0 })) {
+        FreeGame(PoolGame(pool, slot));
+        return SERVER_NO_SESSION;
+    }
+    pool->freeCount--;
+    
+    ServerSession *session = &pool->sessions[slot];
+    memset(session, 0, sizeof(*session));
+    session->id = MakeId(game, slot, pool->generations[slot]);
+    session->client = client;
+    RngSeed(&session->botRng, seed ^ 0xB07B07B07ull);
+    
+    pool->livePos[slot] = (uint32_t)pool->count;
+    pool->live[pool->count++] = slot;
+    return session->id;
+}
+
+ServerSession *ServerFindSession(Server *server, uint32_t id) {
+    if (id == SERVER_NO_SESSION) return NULL;
+    ServerPool *pool = &server->pools[(id & ID_GAME_BIT) ? SERVER_GAME_INVADERS : SERVER_GAME_TETRIS];
+    uint32_t slot = id & (ID_GAME_BIT - 1);
+    if (slot >= (uint32_t)pool->capacity || pool->sessions[slot].id != id) return NULL;
+    return &pool->sessions[slot];
+}
+
+bool ServerSetInput(Server *server, uint32_t id, int client, unsigned int input) {
+    ServerSession *session = ServerFindSession(server, id);
+    if (!session || session->client != client) return false;
+    
+    // Edges accumulate until the next tick, so a quick tap is never lost
+    uint8_t level = server->pools[(id & ID_GAME_BIT) ? 1 : 0].levelInputs;
+    session->held = (uint8_t)(input & level);
+    session->pressed |= (uint8_t)(input & ~level);
+    return true;
+}
+
+bool ServerCloseSession(Server *server, uint32_t id, int client) {
+    ServerSession *session = ServerFindSession(server, id);
+    if (!session || session->client != client) return false;
+    ServerPool *pool = &server->pools[(id & ID_GAME_BIT) ? 1 : 0];
+    PoolRemove(pool, id & (ID_GAME_BIT - 1));
+    return true;
+}
+
+void ServerCloseClient(Server *server, int client) {
+    for (int g = 0; g < SERVER_GAME_COUNT; g++) {
+        ServerPool *pool = &server->pools[g];
+        // Backwards, since removal swaps the last live slot forward
+        for (int i = pool->count - 1; i >= 0; i--) {
+            uint32_t slot = pool->live[i];
+            if (pool->sessions[slot].client == client) PoolRemove(pool, slot);
+        }
+    }
+}
+
+int ServerSaveSession(Server *server, uint32_t id, int client, uint8_t *out, int size) {
+    ServerSession *session = ServerFindSession(server, id);
+    if (!session || session->client != client) return 0;
+    ServerPool *pool = &server->pools[(id & ID_GAME_BIT) ? 1 : 0];
+    void *game = PoolGame(pool, id & (ID_GAME_BIT - 1));
+    if (pool->game == SERVER_GAME_TETRIS) return TetrisSnapshotSave(game, out, size);
+    return InvadersSnapshotSave(game, out, size);
+}
+
+uint32_t ServerRestoreSession(Server *server, ServerGame game, const uint8_t *data, int size, int client) {
+    uint32_t id = ServerCreateSession(server, game, 0, client);
+    if (id == SERVER_NO_SESSION) return id;
+    ServerPool *pool = &server->pools[game];
+    uint32_t slot = id & (ID_GAME_BIT - 1);
+    bool loaded;
+    if (game == SERVER_GAME_TETRIS) {
+        loaded = TetrisSnapshotLoad(PoolGame(pool, slot), data, size);
+    }
+    else {
+        // Views only have room for the classic formation
+        Game *invaders = PoolGame(pool, slot);
+        loaded = InvadersSnapshotLoad(invaders, data, size) &&
+                 invaders->swarm.rows == INVADER_ROWS && invaders->swarm.cols == INVADER_COLS;
+    }
+    if (loaded) return id;
+    PoolRemove(pool, slot);
+    return SERVER_NO_SESSION;
+}
+
+// Random play for load testing: Tetris taps a move every few ticks and
+// sometimes holds soft drop; Invaders starts, then holds random directions
+// and fire for a while at a time
+static unsigned int BotInput(ServerGame game, const void *state, ServerSession *session) {
+    uint32_t r = RngNext(&session->botRng);
+    if (game == SERVER_GAME_TETRIS) {
+        const TetrisGame *tetris = state;
+        if (tetris->gameOver) return TETRIS_INPUT_RESTART;
+        unsigned int input = (r & 0x100) ? TETRIS_INPUT_SOFT_DROP : 0;
+        if ((r & 7) == 0) {
+            static const uint8_t taps[] = {
+                TETRIS_INPUT_LEFT, TETRIS_INPUT_RIGHT, TETRIS_INPUT_ROTATE, TETRIS_INPUT_LEFT,
+                TETRIS_INPUT_RIGHT, TETRIS_INPUT_ROTATE_CCW, TETRIS_INPUT_LEFT, TETRIS_INPUT_HARD_DROP
+            };
+            input |= taps[(r >> 3) & 7];
+        }
+        return input;
+    }
+    
+    const Game *invaders = state;
+    if (invaders->state != INVADERS_PLAYING) return INVADERS_INPUT_START;
+    if ((r & 31) == 0) session->held = (uint8_t)((r >> 5) & 7);
+    return session->held;
+}
+
+// Pack what a client draws into a fixed byte layout (see server.h)
+static void BuildView(ServerGame game, const void *state, uint8_t *view) {
+    if (game == SERVER_GAME_TETRIS) {
+        const TetrisGame *tetris = state;
+        for (int y = 0; y < TETRIS_ROWS; y++) {
+            uint32_t row = 0;
+            for (int x = 0; x < TETRIS_COLS; x++) row |= (uint32_t)(tetris->colors[y][x] & 7) << (3 * x);
+            ProtocolPutU32(view + 4 * y, row);
+        }
+        uint8_t *p = view + TETRIS_ROWS * 4;
+        p[0] = (uint8_t)tetris->currentPieceType;
+        p[1] = (uint8_t)tetris->rotation;
+        p[2] = (uint8_t)(int8_t)tetris->pieceX;
+        p[3] = (uint8_t)(int8_t)tetris->pieceY;
+        p[4] = (uint8_t)tetris->nextPieceType;
+        ProtocolPutU32(p + 5, (uint32_t)tetris->score);
+        ProtocolPutU16(p + 9, (uint16_t)tetris->level);
+        ProtocolPutU16(p + 11, (uint16_t)tetris->linesCleared);
+        p[13] = tetris->gameOver;
+        return;
+    }
+    
+    const Game *invaders = state;
+    view[0] = (uint8_t)invaders->state;
+    view[1] = (uint8_t)invaders->lives;
+    ProtocolPutU32(view + 2, (uint32_t)invaders->score);
+    ProtocolPutU16(view + 6, (uint16_t)lrintf(invaders->player.x));
+    ProtocolPutU16(view + 8, (uint16_t)(int16_t)lrintf(invaders->swarm.originX));
+    ProtocolPutU16(view + 10, (uint16_t)(int16_t)lrintf(invaders->swarm.originY));
+    
+    const ProjectilePool *shots = &invaders->projectiles;
+    int shown = shots->count < SERVER_INVADERS_VIEW_SHOTS ? shots->count : SERVER_INVADERS_VIEW_SHOTS;
+    view[12] = (uint8_t)shown;
+    uint8_t *p = view + 13;
+    for (int i = 0; i < SERVER_INVADERS_VIEW_SHOTS; i++, p += 4) {
+        uint16_t x = 0, y = 0;
+        if (i < shown) {
+            x = (uint16_t)(lrintf(shots->x[i]) & 0x7FFF) | (uint16_t)(shots->owner[i] << 15);
+            y = (uint16_t)(int16_t)lrintf(shots->y[i]);
+        }
+        ProtocolPutU16(p, x);
+        ProtocolPutU16(p + 2, y);
+    }
+    
+    const InvaderSwarm *swarm = &invaders->swarm;
+    int bytes = (swarm->count + 7) / 8;
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(swarm->alive[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+// Runs of changed bytes as [skip][length][bytes], patching old into new in
+// place. Returns the bytes written, 0 when nothing changed.
+static int EncodeDelta(uint8_t *old, const uint8_t *new, int size, uint8_t *out) {
+    int bytes = 0;
+    int last = 0;   // end of the previous run
+    int i = 0;
+    while (i < size) {
+        if (old[i] == new[i]) {
+            i++;
+            continue;
+        }
+        
+        // Extend the run while the next change is within the merge gap
+        int start = i, end = i + 1;
+        for (int j = end; j < size && j <= end + DELTA_MERGE_GAP; j++) {
+            if (old[j] != new[j]) end = j + 1;
+        }
+        out[bytes++] = (uint8_t)(start - last);
+        out[bytes++] = (uint8_t)(end - start);
+        memcpy(out + bytes, new + start, end - start);
+        memcpy(old + start, new + start, end - start);
+        bytes += end - start;
+        last = i = end;
+    }
+    return bytes;
+}
+
+typedef struct {
+    Server *server;
+    int chunks[SERVER_GAME_COUNT];  // chunks per pool, in order
+} TickJob;
+
+static void TickChunk(void *arg, int index, int worker) {
+    TickJob *job = arg;
+    Server *server = job->server;
+    int g = 0;
+    while (index >= job->chunks[g]) index -= job->chunks[g++];
+    
+    ServerPool *pool = &server->pools[g];
+    ServerGame game = pool->game;
+    int first = index * SERVER_TICK_CHUNK;
+    int last = first + SERVER_TICK_CHUNK < pool->count ? first + SERVER_TICK_CHUNK : pool->count;
+    
+    uint8_t view[SERVER_VIEW_MAX];
+    for (int i = first; i < last; i++) {
+        uint32_t slot = pool->live[i];
+        ServerSession *session = &pool->sessions[slot];
+        void *state = PoolGame(pool, slot);
+        
+        unsigned int input = session->client == SERVER_BOT ? BotInput(game, state, session)
+                                                           : (unsigned int)(session->held | session->pressed);
+        session->pressed = 0;
+        if (game == SERVER_GAME_TETRIS) StepTetrisGame(state, input, server->dt);
+        else StepInvadersGame(state, input, server->dt);
+        
+        BuildView(game, state, view);
+        uint8_t *payload = session->delta + PROTOCOL_HEADER_SIZE;
+        int runs = EncodeDelta(session->view, view, pool->viewSize, payload + 8);
+        if (runs == 0) {
+            session->deltaSize = 0;
+            continue;
+        }
+        ProtocolPutU32(payload, session->id);
+        ProtocolPutU32(payload + 4, server->tick);
+        ProtocolPutHeader(session->delta, PROTOCOL_DELTA, (uint16_t)(8 + runs));
+        session->deltaSize = (uint16_t)(PROTOCOL_HEADER_SIZE + 8 + runs);
+    }
+}
+
+void ServerTick(Server *server) {
+    TickJob job = { .server = server };
+    int total = 0;
+    for (int g = 0; g < SERVER_GAME_COUNT; g++) {
+        job.chunks[g] = (server->pools[g].count + SERVER_TICK_CHUNK - 1) / SERVER_TICK_CHUNK;
+        total += job.chunks[g];
+    }
+    ThreadPoolParallelFor(server->threads, total, TickChunk, &job);
+    server->tick++;
+}
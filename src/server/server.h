@@ -0,0 +1,108 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// Headless multi-session game server core. Hosts thousands of independent
+// Tetris and Space Invaders games, ticks all of them at a fixed rate spread
+// across a ThreadPool, and turns each game's state into a compact view
+// whose byte changes become that session's DELTA message (protocol.h).
+// Sockets live in the tool that drives this (tools/game_server.c); nothing
+// here does I/O.
+//
+// Sessions of one game sit in a pool of fixed capacity. Live slots are kept
+// dense in a list, so a tick walks only live sessions, in chunks that the
+// ThreadPool spreads across cores. Session ids carry the slot and a
+// generation count, so an id held past its session's close never reaches
+// whoever reused the slot.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "invaders_snapshot.h"
+#include "protocol.h"
+#include "tetris_snapshot.h"
+#include "thread_pool.h"
+
+#define SERVER_TICK_RATE 60
+#define SERVER_TICK_CHUNK 64            // sessions per parallel task
+#define SERVER_MAX_SESSIONS 0xFFFFF     // per game, so no id is SERVER_NO_SESSION
+#define SERVER_NO_SESSION 0xFFFFFFFFu
+#define SERVER_BOT (-1)                 // client of a server-driven session
+
+// Largest view of any game, and the DELTA message that can patch all of it
+#define SERVER_VIEW_MAX 96
+#define SERVER_DELTA_MAX (PROTOCOL_HEADER_SIZE + 8 + 2 * SERVER_VIEW_MAX)
+
+// View layouts (all integers little-endian)
+//   Tetris    20 x u32 rows, 3 bits per cell (TetrominoType, cell 0 lowest),
+//             u8 piece, u8 rotation, i8 x, i8 y, u8 next piece,
+//             u32 score, u16 level, u16 lines, u8 game over
+//   Invaders  u8 state, u8 lives, u32 score, u16 player x,
+//             i16 swarm origin x, i16 swarm origin y, u8 shots shown,
+//             SERVER_INVADERS_VIEW_SHOTS x (u16 x, i16 y) shots, the first
+//             in the pool, with bit 15 of x set on invader shots and unused
+//             entries zero, then one bit per invader, alive when set
+#define SERVER_INVADERS_VIEW_SHOTS 16
+#define SERVER_TETRIS_VIEW_SIZE (TETRIS_ROWS * 4 + 5 + 4 + 2 + 2 + 1)
+#define SERVER_INVADERS_VIEW_BASE (6 + 2 + 4 + 1 + SERVER_INVADERS_VIEW_SHOTS * 4)
+
+typedef enum {
+    SERVER_GAME_TETRIS = 0,
+    SERVER_GAME_INVADERS,
+    SERVER_GAME_COUNT
+} ServerGame;
+
+typedef struct {
+    uint32_t id;                // SERVER_NO_SESSION while the slot is free
+    int client;                 // owning connection, or SERVER_BOT
+    uint8_t held;               // level-triggered input, kept until replaced
+    uint8_t pressed;            // edge-triggered input for the next tick only
+    GameRng botRng;             // drives the input of SERVER_BOT sessions
+    uint16_t deltaSize;         // bytes in delta this tick, 0 when unchanged
+    uint8_t view[SERVER_VIEW_MAX];      // what the client was last sent
+    uint8_t delta[SERVER_DELTA_MAX];    // this tick's DELTA message
+} ServerSession;
+
+typedef struct {
+    ServerGame game;
+    int capacity;
+    int viewSize;               // bytes of view in use
+    uint8_t levelInputs;        // input bits that are held rather than pressed
+    int count;                  // live sessions
+    ServerSession *sessions;    // by slot
+    void *games;                // TetrisGame or Game, by slot
+    uint16_t *generations;      // bumped whenever a slot is freed
+    uint32_t *live;             // slots in use, dense
+    uint32_t *livePos;          // index of each slot in live
+    uint32_t *freeSlots;        // stack of unused slots
+    int freeCount;
+} ServerPool;
+
+typedef struct {
+    ServerPool pools[SERVER_GAME_COUNT];
+    ThreadPool *threads;        // NULL ticks on the calling thread
+    uint32_t tick;
+    float dt;
+} Server;
+
+// Function declarations
+bool ServerInit(Server *server, int capacity, ThreadPool *threads);
+void ServerFree(Server *server);
+
+// Returns the new session's id, or SERVER_NO_SESSION when the pool is full
+uint32_t ServerCreateSession(Server *server, ServerGame game, uint64_t seed, int client);
+ServerSession *ServerFindSession(Server *server, uint32_t id);
+
+// Only the owning client may steer or close a session
+bool ServerSetInput(Server *server, uint32_t id, int client, unsigned int input);
+bool ServerCloseSession(Server *server, uint32_t id, int client);
+void ServerCloseClient(Server *server, int client);
+
+// Move sessions between servers. Save returns the snapshot's size, or 0 if
+// the session is not the client's or out is too small; Restore returns the
+// new session's id, or SERVER_NO_SESSION for a malformed snapshot.
+int ServerSaveSession(Server *server, uint32_t id, int client, uint8_t *out, int size);
+uint32_t ServerRestoreSession(Server *server, ServerGame game, const uint8_t *data, int size, int client);
+
+// Step every session once, then fill in each one's delta
+void ServerTick(Server *server);
+
+#endif // SERVER_H
@@ -1,54 +1,14 @@
 #include "tetris.h"
+#include "particles.h"
 #include "raylib.h"
+#include "replay.h"
+#include "scene.h"
+#include "tetris_ai.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-// Tetromino shapes
-static const int tetrominoes[7][4][4] = {
-    // I
-    {
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY},
-        {TETRO_CYAN, TETRO_CYAN, TETRO_CYAN, TETRO_CYAN},
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY},
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY}
-    },
-    // J
-    {
-        {TETRO_BLUE, TETRO_EMPTY, TETRO_EMPTY},
-        {TETRO_BLUE, TETRO_BLUE, TETRO_BLUE},
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY}
-    },
-    // L
-    {
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_ORANGE},
-        {TETRO_ORANGE, TETRO_ORANGE, TETRO_ORANGE},
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY}
-    },
-    // O
-    {
-        {TETRO_YELLOW, TETRO_YELLOW},
-        {TETRO_YELLOW, TETRO_YELLOW}
-    },
-    // S
-    {
-        {TETRO_EMPTY, TETRO_GREEN, TETRO_GREEN},
-        {TETRO_GREEN, TETRO_GREEN, TETRO_EMPTY},
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY}
-    },
-    // T
-    {
-        {TETRO_EMPTY, TETRO_PURPLE, TETRO_EMPTY},
-        {TETRO_PURPLE, TETRO_PURPLE, TETRO_PURPLE},
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY}
-    },
-    // Z
-    {
-        {TETRO_RED, TETRO_RED, TETRO_EMPTY},
-        {TETRO_EMPTY, TETRO_RED, TETRO_RED},
-        {TETRO_EMPTY, TETRO_EMPTY, TETRO_EMPTY}
-    }
-};
-
 static const Color tetrominoColors[] = {
     {0, 0, 0, 0},        // TETRO_EMPTY
     {0, 255, 255, 255},   // TETRO_CYAN (I)
@@ -57,247 +17,101 @@ static const Color tetrominoColors[] = {
     {255, 255, 0, 255},   // TETRO_YELLOW (O)
     {0, 255, 0, 255},     // TETRO_GREEN (S)
     {128, 0, 128, 255},   // TETRO_PURPLE (T)
-    {255, 0, 0, 255}      // TETRO_RED (Z)
+    {255, 0, 0, 255},     // TETRO_RED (Z)
+    {130, 130, 130, 255}  // TETRO_GARBAGE
 };
 
-void InitTetrisGame(TetrisGame *game) {
-    // Initialize grid
-    for (int y = 0; y < 20; y++) {
-        for (int x = 0; x < 10; x++) {
-            game->grid[y][x] = TETRO_EMPTY;
-        }
-    }
-    
-    // Initialize game state
-    game->pieceX = 3;
-    game->pieceY = 0;
-    game->rotation = 0;
-    game->fallSpeed = 1.0f;
-    game->score = 0;
-    game->level = 1;
-    game->linesCleared = 0;
-    game->gameOver = false;
-    
-    // Initialize random seed
-    srand(time(NULL));
-    
-    // Get first pieces
-    game->currentPieceType = rand() % 7 + TETRO_CYAN;
-    game->nextPieceType = rand() % 7 + TETRO_CYAN;
-    
-    // Copy current piece
-    for (int y = 0; y < 4; y++) {
-        for (int x = 0; x < 4; x++) {
-            game->currentPiece[y][x] = tetrominoes[game->currentPieceType - TETRO_CYAN][y][x];
-        }
-    }
-    // Set initial position
-    game->pieceX = 3;
-    game->pieceY = 0;
+// Translate this frame's keyboard state into core input bits
+unsigned int ReadTetrisInput(void) {
+    unsigned int input = 0;
+    if (IsKeyPressed(KEY_LEFT)) input |= TETRIS_INPUT_LEFT;
+    if (IsKeyPressed(KEY_RIGHT)) input |= TETRIS_INPUT_RIGHT;
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_X)) input |= TETRIS_INPUT_ROTATE;
+    if (IsKeyPressed(KEY_Z)) input |= TETRIS_INPUT_ROTATE_CCW;
+    if (IsKeyDown(KEY_DOWN)) input |= TETRIS_INPUT_SOFT_DROP;
+    if (IsKeyPressed(KEY_SPACE)) input |= TETRIS_INPUT_HARD_DROP;
+    if (IsKeyPressed(KEY_ENTER)) input |= TETRIS_INPUT_RESTART;
+    return input;
 }
 
-bool CheckCollision(TetrisGame *game, int offsetX, int offsetY) {
-    for (int y = 0; y < 4; y++) {
-        for (int x = 0; x < 4; x++) {
-            if (game->currentPiece[y][x] != TETRO_EMPTY) {
-                int newX = game->pieceX + x + offsetX;
-                int newY = game->pieceY + y + offsetY;
-                
-                if (newX < 0 || newX >= 10 || newY >= 20 || 
-                    (newY >= 0 && game->grid[newY][newX] != TETRO_EMPTY)) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
-}
-
-void LockPiece(TetrisGame *game) {
-    // Add piece to grid
-    for (int y = 0; y < 4; y++) {
-        for (int x = 0; x < 4; x++) {
-            if (game->currentPiece[y][x] != TETRO_EMPTY) {
-                int gridY = game->pieceY + y;
-                int gridX = game->pieceX + x;
-                if (gridY >= 0 && gridX >= 0 && gridX < 10) {
-                    game->grid[gridY][gridX] = game->currentPieceType;
-                }
-            }
-        }
-    }
+// Draw the grid and the locked cells with the board's top-left at (x, y)
+static void DrawBoard(const TetrisGame *game, int originX, int originY, int cellSize) {
+    // Draw grid background
+    DrawRectangle(originX, originY, 10 * cellSize, 20 * cellSize, DARKGRAY);
     
-    // Check for completed lines
-    int linesCleared = 0;
-    for (int y = 19; y >= 0; y--) {
-        bool lineComplete = true;
-        for (int x = 0; x < 10; x++) {
-            if (game->grid[y][x] == TETRO_EMPTY) {
-                lineComplete = false;
-                break;
-            }
-        }
-        
-        if (lineComplete) {
-            // Remove line and move everything down
-            for (int ny = y; ny > 0; ny--) {
-                for (int x = 0; x < 10; x++) {
-                    game->grid[ny][x] = game->grid[ny-1][x];
-                }
-            }
-            // Clear top line
-            for (int x = 0; x < 10; x++) {
-                game->grid[0][x] = TETRO_EMPTY;
-            }
-            
-            linesCleared++;
-            y++; // Check the same row again
-        }
+    // Draw grid lines
+    for (int x = 0; x <= 10; x++) {
+        DrawLine(originX + x * cellSize, originY, 
+                 originX + x * cellSize, originY + 20 * cellSize, GRAY);
     }
-    
-    // Update score
-    if (linesCleared > 0) {
-        int points = 0;
-        switch (linesCleared) {
-            case 1: points = 100; break;
-            case 2: points = 300; break;
-            case 3: points = 500; break;
-            case 4: points = 800; break;
-        }
-        game->score += points * game->level;
-        game->linesCleared += linesCleared;
-        game->level = game->linesCleared / 10 + 1;
-        game->fallSpeed = 0.5f / game->level;
+    for (int y = 0; y <= 20; y++) {
+        DrawLine(originX, originY + y * cellSize, 
+                 originX + 10 * cellSize, originY + y * cellSize, GRAY);
     }
     
-    // Get next piece
-    game->currentPieceType = game->nextPieceType;
-    game->nextPieceType = rand() % 7 + TETRO_CYAN;
-    
-    // Copy new current piece
-    for (int y = 0; y < 4; y++) {
-        for (int x = 0; x < 4; x++) {
-            if (y < 3 && x < 3) {
-                game->currentPiece[y][x] = tetrominoes[game->currentPieceType - TETRO_CYAN][y][x];
-            } else {
-                game->currentPiece[y][x] = TETRO_EMPTY;
+    // Draw placed pieces
+    for (int y = 0; y < 20; y++) {
+        for (int x = 0; x < 10; x++) {
+            if (game->colors[y][x] != TETRO_EMPTY) {
+                DrawRectangle(originX + x * cellSize + 1, 
+                             originY + y * cellSize + 1, 
+                             cellSize - 1, cellSize - 1, 
+                             tetrominoColors[game->colors[y][x]]);
             }
         }
     }
-    
-    // Reset position
-    game->pieceX = 3;
-    game->pieceY = 0;
-    
-    // Check if game over
-    if (CheckCollision(game, 0, 0)) {
-        game->gameOver = true;
-    }
 }
 
-void RotatePiece(TetrisGame *game) {
-    int temp[4][4] = {0};
-    
-    // Create a copy of the current piece
-    for (int y = 0; y < 4; y++) {
-        for (int x = 0; x < 4; x++) {
-            temp[y][x] = game->currentPiece[y][x];
-        }
-    }
-    
-    // Rotate the piece
-    for (int y = 0; y < 4; y++) {
-        for (int x = 0; x < 4; x++) {
-            game->currentPiece[x][3 - y] = temp[y][x];
-        }
-    }
-    
-    // If rotation causes collision, rotate back
-    if (CheckCollision(game, 0, 0)) {
-        for (int y = 0; y < 4; y++) {
-            for (int x = 0; x < 4; x++) {
-                game->currentPiece[y][x] = temp[y][x];
-            }
-        }
-    }
+void InitTetrisRenderCache(TetrisRenderCache *cache) {
+    memset(cache, 0, sizeof(*cache));
+    cache->board = LoadRenderTexture(TETRIS_CELL_SIZE * TETRIS_COLS + 1, TETRIS_CELL_SIZE * TETRIS_ROWS + 1);
+    cache->score = -1;
+    cache->level = -1;
 }
 
-void UpdateTetrisGame(TetrisGame *game) {
-    if (game->gameOver) {
-        if (IsKeyPressed(KEY_ENTER)) {
-            InitTetrisGame(game);
-        }
-        return;
-    }
-    
-    // Move left
-    if (IsKeyPressed(KEY_LEFT) && !CheckCollision(game, -1, 0)) {
-        game->pieceX--;
-    }
-    
-    // Move right
-    if (IsKeyPressed(KEY_RIGHT) && !CheckCollision(game, 1, 0)) {
-        game->pieceX++;
-    }
-    
-    // Rotate
-    if (IsKeyPressed(KEY_UP)) {
-        RotatePiece(game);
-    }
-    
-    // Soft drop
-    if (IsKeyDown(KEY_DOWN)) {
-        game->fallTimer += 2 * GetFrameTime();
-    }
-    
-    // Hard drop
-    if (IsKeyPressed(KEY_SPACE)) {
-        while (!CheckCollision(game, 0, 1)) {
-            game->pieceY++;
-        }
-        LockPiece(game);
-        return;
-    }
-    
-    // Fall
-    game->fallTimer += GetFrameTime();
-    if (game->fallTimer >= game->fallSpeed) {
-        game->fallTimer = 0;
-        
-        if (!CheckCollision(game, 0, 1)) {
-            game->pieceY++;
-        } else {
-            LockPiece(game);
-        }
-    }
+void UnloadTetrisRenderCache(TetrisRenderCache *cache) {
+    if (cache->board.id != 0) UnloadRenderTexture(cache->board);
+    cache->board.id = 0;
 }
 
-void DrawTetrisGame(const TetrisGame *game) {
-    const int cellSize = 30;
-    const int offsetX = (GetScreenWidth() - 10 * cellSize) / 2;
-    const int offsetY = 50;
-    
-    // Draw grid background
-    DrawRectangle(offsetX, offsetY, 10 * cellSize, 20 * cellSize, DARKGRAY);
+void DrawTetrisGame(const TetrisGame *game, TetrisRenderCache *cache) {
+    DrawTetrisGameAt(game, cache, (GetScreenWidth() - 10 * TETRIS_CELL_SIZE) / 2, 50);
+}
+
+void DrawTetrisGameAt(const TetrisGame *game, TetrisRenderCache *cache, int offsetX, int offsetY) {
+    const int cellSize = TETRIS_CELL_SIZE;
     
-    // Draw grid lines
-    for (int x = 0; x <= 10; x++) {
-        DrawLine(offsetX + x * cellSize, offsetY, 
-                 offsetX + x * cellSize, offsetY + 20 * cellSize, GRAY);
-    }
-    for (int y = 0; y <= 20; y++) {
-        DrawLine(offsetX, offsetY + y * cellSize, 
-                 offsetX + 10 * cellSize, offsetY + y * cellSize, GRAY);
+    if (cache && cache->board.id != 0) {
+        // Redraw the static board only after the core changed it
+        if (!cache->valid || cache->boardVersion != game->boardVersion) {
+            BeginTextureMode(cache->board);
+            ClearBackground(BLANK);
+            DrawBoard(game, 0, 0, cellSize);
+            EndTextureMode();
+            cache->valid = true;
+            cache->boardVersion = game->boardVersion;
+        }
+        
+        // Render textures are stored upside down, hence the negative height
+        Texture2D texture = cache->board.texture;
+        DrawTextureRec(texture, (Rectangle){ 0, 0, (float)texture.width, -(float)texture.height },
+                       (Vector2){ (float)offsetX, (float)offsetY }, WHITE);
+    } else {
+        DrawBoard(game, offsetX, offsetY, cellSize);
     }
     
-    // Draw placed pieces
-    for (int y = 0; y < 20; y++) {
-        for (int x = 0; x < 10; x++) {
-            if (game->grid[y][x] != TETRO_EMPTY) {
-                DrawRectangle(offsetX + x * cellSize + 1, 
-                             offsetY + y * cellSize + 1, 
-                             cellSize - 1, cellSize - 1, 
-                             tetrominoColors[game->grid[y][x]]);
+    // Draw ghost piece where a hard drop would land
+    const TetrisPieceMask *piece = TetrisGetPieceMask(game->currentPieceType, game->rotation);
+    int ghostY = game->gameOver ? game->pieceY : TetrisLandingY(game);
+    if (ghostY != game->pieceY) {
+        Color ghostColor = Fade(tetrominoColors[game->currentPieceType], 0.3f);
+        for (int y = piece->minY; y <= piece->maxY; y++) {
+            for (int x = piece->minX; x <= piece->maxX; x++) {
+                if ((piece->rows[y] & (1u << x)) && ghostY + y >= 0) {
+                    DrawRectangle(offsetX + (game->pieceX + x) * cellSize + 1,
+                                  offsetY + (ghostY + y) * cellSize + 1,
+                                  cellSize - 1, cellSize - 1, ghostColor);
+                }
             }
         }
     }
@@ -305,7 +119,7 @@ void DrawTetrisGame(const TetrisGame *game) {
     // Draw current piece
     for (int y = 0; y < 4; y++) {
         for (int x = 0; x < 4; x++) {
-            if (game->currentPiece[y][x] != TETRO_EMPTY) {
+            if (piece->rows[y] & (1u << x)) {
                 int drawX = game->pieceX + x;
                 int drawY = game->pieceY + y;
                 
@@ -321,9 +135,10 @@ void DrawTetrisGame(const TetrisGame *game) {
     
     // Draw next piece preview
     DrawText("NEXT:", offsetX + 12 * cellSize, offsetY, 20, WHITE);
+    const TetrisPieceMask *next = TetrisGetPieceMask(game->nextPieceType, 0);
     for (int y = 0; y < 4; y++) {
         for (int x = 0; x < 4; x++) {
-            if (y < 3 && x < 3 && tetrominoes[game->nextPieceType - TETRO_CYAN][y][x] != TETRO_EMPTY) {
+            if (next->rows[y] & (1u << x)) {
                 DrawRectangle(offsetX + 12 * cellSize + x * cellSize, 
                              offsetY + 30 + y * cellSize, 
                              cellSize - 1, cellSize - 1, 
@@ -332,9 +147,22 @@ void DrawTetrisGame(const TetrisGame *game) {
         }
     }
     
-    // Draw score and level
-    DrawText(TextFormat("SCORE: %d", game->score), offsetX, 10, 20, WHITE);
-    DrawText(TextFormat("LEVEL: %d", game->level), offsetX + 200, 10, 20, WHITE);
+    // Draw score and level; the strings are rebuilt only when they change
+    if (cache) {
+        if (cache->score != game->score) {
+            cache->score = game->score;
+            snprintf(cache->scoreText, sizeof(cache->scoreText), "SCORE: %d", game->score);
+        }
+        if (cache->level != game->level) {
+            cache->level = game->level;
+            snprintf(cache->levelText, sizeof(cache->levelText), "LEVEL: %d", game->level);
+        }
+        DrawText(cache->scoreText, offsetX, offsetY - 40, 20, WHITE);
+        DrawText(cache->levelText, offsetX + 200, offsetY - 40, 20, WHITE);
+    } else {
+        DrawText(TextFormat("SCORE: %d", game->score), offsetX, offsetY - 40, 20, WHITE);
+        DrawText(TextFormat("LEVEL: %d", game->level), offsetX + 200, offsetY - 40, 20, WHITE);
+    }
     
     // Draw game over message
     if (game->gameOver) {
@@ -344,35 +172,140 @@ void DrawTetrisGame(const TetrisGame *game) {
     }
 }
 
-void PlayTetris(void) {
-    // Initialize game
+// Scene state: the game plus its recording and the autoplay bot
+typedef struct {
     TetrisGame game;
-    InitTetrisGame(&game);
+    ReplayWriter replay;
+    bool autoplay;
+    TetrisBot bot;
+    TetrisBotDriver driver;
+    TetrisRenderCache cache;
+    ParticlePool particles;
+    uint8_t colors[TETRIS_ROWS][TETRIS_COLS];  // the board before this tick, for line clear bursts
+    unsigned int keys;      // keyboard bits read this frame
+    unsigned int pressed;   // key presses not yet consumed by a tick
+} TetrisScene;
+
+static void *TetrisSceneInit(void) {
+    TetrisScene *scene = calloc(1, sizeof(TetrisScene));
+    if (!scene) return NULL;
     
-    // Game loop
-    while (!WindowShouldClose()) {
-        // Check for exit
-        if (IsKeyPressed(KEY_ESCAPE)) {
-            break;
+    // Initialize game
+    uint64_t seed = (uint64_t)time(NULL);
+    InitTetrisGame(&scene->game, seed, TETRIS_RANDOMIZER_BAG7);
+    
+    // Record the session so it can be re-simulated headless
+    ReplayHeader header = { REPLAY_GAME_TETRIS, TETRIS_RANDOMIZER_BAG7, REPLAY_TICK_RATE, seed };
+    char replayPath[256];
+    if (ReplayMakePath(replayPath, sizeof(replayPath), "tetris", seed)) {
+        ReplayWriterOpen(&scene->replay, replayPath, &header);
+    }
+    
+    // Autoplay demo: the bot presses the keys through the same input bits
+    scene->bot.lookahead = true;
+    TetrisBotDriverInit(&scene->driver, 2);
+    
+    InitTetrisRenderCache(&scene->cache);
+    ParticlesInit(&scene->particles, 0, seed);
+    return scene;
+}
+
+static void TetrisSceneUpdate(void *state, SceneStack *stack) {
+    TetrisScene *scene = state;
+    
+    // Check for exit
+    if (IsKeyPressed(KEY_ESCAPE)) {
+        ScenePop(stack);
+        return;
+    }
+    
+    if (IsKeyPressed(KEY_A)) {
+        scene->autoplay = !scene->autoplay;
+        if (scene->autoplay && !scene->bot.pool) scene->bot.pool = ThreadPoolCreate(0);
+    }
+    
+    // Key presses are latched until a tick consumes them; soft drop is
+    // held and applies to every tick of the frame
+    scene->keys = ReadTetrisInput();
+    scene->pressed |= scene->keys & ~TETRIS_INPUT_SOFT_DROP;
+}
+
+// Burst every cell of the rows the last lock cleared, in the colors they
+// had; the cells the piece itself filled take the piece's color
+static void SpawnLineClear(TetrisScene *scene, int pieceType) {
+    const float originX = (GetScreenWidth() - TETRIS_COLS * TETRIS_CELL_SIZE) / 2;
+    const float originY = 50;
+    for (int y = 0; y < TETRIS_ROWS; y++) {
+        if (!(scene->game.clearedRows & (1u << y))) continue;
+        for (int x = 0; x < TETRIS_COLS; x++) {
+            int type = scene->colors[y][x] != TETRO_EMPTY ? scene->colors[y][x] : pieceType;
+            ParticlesBurst(&scene->particles, originX + x * TETRIS_CELL_SIZE, originY + y * TETRIS_CELL_SIZE,
+                           TETRIS_CELL_SIZE, TETRIS_CELL_SIZE, 48, 260.0f, 0.9f,
+                           ParticleColor(tetrominoColors[type]));
         }
-        
-        // Update
-        UpdateTetrisGame(&game);
-        
-        // Draw
-        BeginDrawing();
-        ClearBackground(BLACK);
-        
-        DrawTetrisGame(&game);
-        
-        // Draw controls
-        DrawText("CONTROLS:", 30, 500, 20, WHITE);
-        DrawText("LEFT/RIGHT: Move", 30, 530, 20, WHITE);
-        DrawText("UP: Rotate", 30, 550, 20, WHITE);
-        DrawText("DOWN: Soft Drop", 30, 570, 20, WHITE);
-        DrawText("SPACE: Hard Drop", 30, 590, 20, WHITE);
-        DrawText("ESC: Back to Menu", 30, 630, 20, YELLOW);
-        
-        EndDrawing();
     }
 }
+
+// Simulate in fixed ticks so the recording replays exactly
+static void TetrisSceneTick(void *state, float dt) {
+    TetrisScene *scene = state;
+    unsigned int input;
+    if (scene->autoplay) {
+        input = TetrisBotDriverInput(&scene->driver, &scene->bot, &scene->game);
+    } else {
+        input = (scene->keys & TETRIS_INPUT_SOFT_DROP) | scene->pressed;
+    }
+    scene->pressed = 0;
+    
+    memcpy(scene->colors, scene->game.colors, sizeof(scene->colors));
+    int pieceType = scene->game.currentPieceType;
+    uint32_t pieces = scene->game.pieceCount;
+    StepTetrisGame(&scene->game, input, dt);
+    ReplayWriterPush(&scene->replay, (uint8_t)input);
+    
+    if (scene->game.pieceCount != pieces && scene->game.clearedRows) SpawnLineClear(scene, pieceType);
+    ParticlesUpdate(&scene->particles, dt);
+}
+
+static void TetrisSceneDraw(void *state, float alpha) {
+    TetrisScene *scene = state;
+    ClearBackground(BLACK);
+    
+    DrawTetrisGame(&scene->game, &scene->cache);
+    DrawParticles(&scene->particles, 3.0f);
+    
+    // Draw controls
+    DrawText("CONTROLS:", 30, 500, 20, WHITE);
+    DrawText("LEFT/RIGHT: Move", 30, 530, 20, WHITE);
+    DrawText("UP/X, Z: Rotate", 30, 550, 20, WHITE);
+    DrawText("DOWN: Soft Drop", 30, 570, 20, WHITE);
+    DrawText("SPACE: Hard Drop", 30, 590, 20, WHITE);
+    DrawText(scene->autoplay ? "A: Autoplay (ON)" : "A: Autoplay", 30, 610, 20, scene->autoplay ? GREEN : WHITE);
+    DrawText("ESC: Back to Menu", 30, 630, 20, YELLOW);
+    DrawParticleCounter(&scene->particles, 30, 670);
+}
+
+static void TetrisSceneShutdown(void *state) {
+    TetrisScene *scene = state;
+    ReplayWriterClose(&scene->replay, scene->game.score);
+    ThreadPoolDestroy(scene->bot.pool);
+    UnloadTetrisRenderCache(&scene->cache);
+    ParticlesFree(&scene->particles);
+    free(scene);
+}
+
+const Scene tetrisScene = {
+    .title = "Tetris",
+    .width = 800,
+    .height = 700,
+    .tickRate = REPLAY_TICK_RATE,
+    .init = TetrisSceneInit,
+    .update = TetrisSceneUpdate,
+    .tick = TetrisSceneTick,
+    .draw = TetrisSceneDraw,
+    .shutdown = TetrisSceneShutdown
+};
+
+void PlayTetris(void) {
+    SceneRun(&tetrisScene);
+}
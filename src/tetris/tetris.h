@@ -2,39 +2,31 @@
 #define TETRIS_H
 
 #include "raylib.h"
+#include "tetris_core.h"
+#include "scene.h"
 
-// Tetromino types
-typedef enum {
-    TETRO_EMPTY = 0,
-    TETRO_CYAN,
-    TETRO_BLUE,
-    TETRO_ORANGE,
-    TETRO_YELLOW,
-    TETRO_GREEN,
-    TETRO_PURPLE,
-    TETRO_RED
-} TetrominoType;
+#define TETRIS_CELL_SIZE 30
 
+// The grid and locked cells are drawn into a texture and redrawn only when
+// the core's boardVersion changes; HUD strings are rebuilt only on change.
+// Only the falling piece, the preview and the text are drawn every frame.
 typedef struct {
-    int grid[20][10];
-    int currentPiece[4][4];
-    int nextPiece[4][4];
-    int pieceX, pieceY;
-    int nextPieceType;
-    int currentPieceType;
-    int rotation;
-    float fallTimer;
-    float fallSpeed;
-    int score;
-    int level;
-    int linesCleared;
-    bool gameOver;
-} TetrisGame;
+    RenderTexture2D board;
+    bool valid;
+    uint32_t boardVersion;
+    int score, level;
+    char scoreText[32];
+    char levelText[32];
+} TetrisRenderCache;
 
 // Function declarations
-void InitTetrisGame(TetrisGame *game);
-void UpdateTetrisGame(TetrisGame *game);
-void DrawTetrisGame(const TetrisGame *game);
+unsigned int ReadTetrisInput(void);
+void InitTetrisRenderCache(TetrisRenderCache *cache);     // needs a window
+void UnloadTetrisRenderCache(TetrisRenderCache *cache);
+void DrawTetrisGame(const TetrisGame *game, TetrisRenderCache *cache); // cache may be NULL
+void DrawTetrisGameAt(const TetrisGame *game, TetrisRenderCache *cache, int offsetX, int offsetY);
 void PlayTetris(void);
 
+extern const Scene tetrisScene;
+
 #endif // TETRIS_H
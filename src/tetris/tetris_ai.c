@@ -0,0 +1,188 @@
+#include "tetris_ai.h"
+#include <string.h>
+
+// Weights for the default evaluator (aggregate height, lines, holes, bumpiness)
+#define WEIGHT_HEIGHT    -0.510066f
+#define WEIGHT_LINES      0.760666f
+#define WEIGHT_HOLES     -0.35663f
+#define WEIGHT_BUMPINESS -0.184483f
+
+// Scored as a top-out when the next piece cannot even spawn
+#define TOP_OUT_SCORE -1.0e9f
+
+// Shared state for one parallel search; each task writes only its own score
+typedef struct {
+    const TetrisBot *bot;
+    const TetrisBoard *board;
+    int type;
+    int nextType;
+    const TetrisPlacement *candidates;
+    float *scores;
+} SearchJob;
+
+void TetrisComputeFeatures(const TetrisBoard *board, TetrisBoardFeatures *features) {
+    memset(features, 0, sizeof(*features));
+    
+    // The board keeps its column heights; every empty cell under a
+    // column's top is a hole
+    for (int x = 0; x < TETRIS_COLS; x++) {
+        features->heights[x] = board->heights[x];
+        features->holes += board->heights[x] - __builtin_popcount(board->columns[x]);
+    }
+    
+    for (int x = 0; x < TETRIS_COLS; x++) {
+        features->aggregateHeight += features->heights[x];
+        if (features->heights[x] > features->maxHeight) features->maxHeight = features->heights[x];
+        if (x > 0) {
+            int diff = features->heights[x] - features->heights[x - 1];
+            features->bumpiness += diff < 0 ? -diff : diff;
+        }
+    }
+}
+
+float TetrisDefaultEvaluator(const TetrisBoard *board, int linesCleared, void *user) {
+    (void)user;
+    TetrisBoardFeatures f;
+    TetrisComputeFeatures(board, &f);
+    return WEIGHT_HEIGHT * f.aggregateHeight + WEIGHT_LINES * linesCleared +
+           WEIGHT_HOLES * f.holes + WEIGHT_BUMPINESS * f.bumpiness;
+}
+
+// Apply the rotation sequence the driver will press: one turn clockwise for
+// rotation 1, two for 2 and one counter-clockwise for 3
+static bool RotateFromSpawn(const TetrisBoard *board, int type, int target, int *x, int *y) {
+    int rotation = 0;
+    int direction = (target == 3) ? TETRIS_ROTATE_CCW : TETRIS_ROTATE_CW;
+    while (rotation != target) {
+        rotation = TetrisBoardRotate(board, type, rotation, direction, x, y);
+        if (rotation < 0) return false;
+    }
+    return true;
+}
+
+int TetrisEnumeratePlacements(const TetrisBoard *board, int type, TetrisPlacement *out) {
+    int count = 0;
+    
+    // Nothing is reachable if the piece cannot spawn
+    if (TetrisBoardCollides(board, TetrisGetPieceMask(type, 0), TETRIS_SPAWN_X, TETRIS_SPAWN_Y)) {
+        return 0;
+    }
+    
+    // O looks the same in every rotation
+    int rotations = (type == TETRO_YELLOW) ? 1 : 4;
+    for (int rotation = 0; rotation < rotations; rotation++) {
+        int x = TETRIS_SPAWN_X;
+        int y = TETRIS_SPAWN_Y;
+        const TetrisPieceMask *piece = TetrisGetPieceMask(type, rotation);
+        if (!RotateFromSpawn(board, type, rotation, &x, &y)) continue;
+        
+        // Slide as far left as possible, then visit every column to the right
+        while (!TetrisBoardCollides(board, piece, x - 1, y)) x--;
+        for (; !TetrisBoardCollides(board, piece, x, y); x++) {
+            out[count].rotation = rotation;
+            out[count].x = x;
+            out[count].y = TetrisBoardDropY(board, piece, x, y);
+            out[count].score = 0.0f;
+            count++;
+        }
+    }
+    return count;
+}
+
+static float Evaluate(const TetrisBot *bot, const TetrisBoard *board, int linesCleared) {
+    if (bot->evaluate) return bot->evaluate(board, linesCleared, bot->user);
+    return TetrisDefaultEvaluator(board, linesCleared, NULL);
+}
+
+// Score one candidate for the current piece, including the best follow-up
+// placement of the next piece when looking ahead
+static void SearchCandidate(void *arg, int index, int worker) {
+    (void)worker;
+    SearchJob *job = arg;
+    const TetrisPlacement *candidate = &job->candidates[index];
+    
+    TetrisBoard board = *job->board;
+    int lines = TetrisBoardPlace(&board, NULL, job->type, candidate->rotation, candidate->x, candidate->y);
+    
+    if (!job->bot->lookahead) {
+        bool toppedOut = TetrisBoardCollides(&board, TetrisGetPieceMask(job->nextType, 0),
+                                             TETRIS_SPAWN_X, TETRIS_SPAWN_Y);
+        job->scores[index] = toppedOut ? TOP_OUT_SCORE : Evaluate(job->bot, &board, lines);
+        return;
+    }
+    
+    // No follow-up placements means the next piece cannot spawn
+    TetrisPlacement next[TETRIS_MAX_PLACEMENTS];
+    int count = TetrisEnumeratePlacements(&board, job->nextType, next);
+    float best = TOP_OUT_SCORE;
+    for (int i = 0; i < count; i++) {
+        TetrisBoard after = board;
+        int moreLines = TetrisBoardPlace(&after, NULL, job->nextType, next[i].rotation, next[i].x, next[i].y);
+        float score = Evaluate(job->bot, &after, lines + moreLines);
+        if (score > best) best = score;
+    }
+    job->scores[index] = best;
+}
+
+// Pick the best placement for the current piece, searched from its spawn.
+// Ties go to the first candidate, so the choice does not depend on threading.
+bool TetrisBotChoose(const TetrisBot *bot, const TetrisGame *game, TetrisPlacement *best) {
+    TetrisPlacement candidates[TETRIS_MAX_PLACEMENTS];
+    float scores[TETRIS_MAX_PLACEMENTS];
+    
+    int count = TetrisEnumeratePlacements(&game->board, game->currentPieceType, candidates);
+    if (count == 0) return false;
+    
+    SearchJob job = {
+        .bot = bot,
+        .board = &game->board,
+        .type = game->currentPieceType,
+        .nextType = game->nextPieceType,
+        .candidates = candidates,
+        .scores = scores
+    };
+    ThreadPoolParallelFor(bot->pool, count, SearchCandidate, &job);
+    
+    int bestIndex = 0;
+    for (int i = 1; i < count; i++) {
+        if (scores[i] > scores[bestIndex]) bestIndex = i;
+    }
+    *best = candidates[bestIndex];
+    best->score = scores[bestIndex];
+    return true;
+}
+
+void TetrisBotDriverInit(TetrisBotDriver *driver, int actionDelay) {
+    memset(driver, 0, sizeof(*driver));
+    driver->actionDelay = actionDelay;
+}
+
+// Input for the next tick: rotate, then slide, then hard drop, pausing
+// actionDelay ticks between actions so a live demo stays watchable
+unsigned int TetrisBotDriverInput(TetrisBotDriver *driver, const TetrisBot *bot, const TetrisGame *game) {
+    if (game->gameOver) {
+        driver->hasTarget = false;
+        return TETRIS_INPUT_RESTART;
+    }
+    
+    // Plan once per piece
+    if (!driver->hasTarget || driver->pieceCount != game->pieceCount) {
+        driver->pieceCount = game->pieceCount;
+        driver->hasTarget = TetrisBotChoose(bot, game, &driver->target);
+        driver->cooldown = driver->actionDelay;
+        if (!driver->hasTarget) return TETRIS_INPUT_HARD_DROP;
+    }
+    
+    if (driver->cooldown > 0) {
+        driver->cooldown--;
+        return 0;
+    }
+    driver->cooldown = driver->actionDelay;
+    
+    if (game->rotation != driver->target.rotation) {
+        return (driver->target.rotation == 3) ? TETRIS_INPUT_ROTATE_CCW : TETRIS_INPUT_ROTATE;
+    }
+    if (game->pieceX < driver->target.x) return TETRIS_INPUT_RIGHT;
+    if (game->pieceX > driver->target.x) return TETRIS_INPUT_LEFT;
+    return TETRIS_INPUT_HARD_DROP;
+}
@@ -0,0 +1,61 @@
+#ifndef TETRIS_AI_H
+#define TETRIS_AI_H
+
+// Placement-search Tetris bot.
+// Enumerates every placement the current piece can reach from its spawn
+// (rotate first, then slide, then hard drop), optionally looks one piece
+// ahead with nextPieceType, and scores the resulting boards with a
+// pluggable evaluator. Candidate placements are searched in parallel when a
+// ThreadPool is supplied.
+
+#include "tetris_core.h"
+#include "thread_pool.h"
+
+// Upper bound on placements for one piece: 4 rotations x every column
+#define TETRIS_MAX_PLACEMENTS (4 * (TETRIS_COLS + 3))
+
+typedef struct {
+    int rotation;
+    int x, y;           // final position after the hard drop
+    float score;
+} TetrisPlacement;
+
+// Board shape measurements used by evaluators
+typedef struct {
+    int heights[TETRIS_COLS];
+    int aggregateHeight;
+    int maxHeight;
+    int holes;
+    int bumpiness;
+} TetrisBoardFeatures;
+
+// Scores a board after placing pieces; higher is better.
+// linesCleared is the number of lines the evaluated placements cleared.
+typedef float (*TetrisEvaluator)(const TetrisBoard *board, int linesCleared, void *user);
+
+typedef struct {
+    TetrisEvaluator evaluate;   // NULL uses TetrisDefaultEvaluator
+    void *user;                 // passed through to evaluate
+    bool lookahead;             // also place nextPieceType before scoring
+    ThreadPool *pool;           // NULL searches on the calling thread
+} TetrisBot;
+
+// Turns a chosen placement into per-tick input bits for StepTetrisGame
+typedef struct {
+    uint32_t pieceCount;        // piece the current target belongs to
+    bool hasTarget;
+    TetrisPlacement target;
+    int actionDelay;            // ticks to wait between actions
+    int cooldown;
+} TetrisBotDriver;
+
+// Function declarations
+void TetrisComputeFeatures(const TetrisBoard *board, TetrisBoardFeatures *features);
+float TetrisDefaultEvaluator(const TetrisBoard *board, int linesCleared, void *user);
+int TetrisEnumeratePlacements(const TetrisBoard *board, int type, TetrisPlacement *out);
+bool TetrisBotChoose(const TetrisBot *bot, const TetrisGame *game, TetrisPlacement *best);
+
+void TetrisBotDriverInit(TetrisBotDriver *driver, int actionDelay);
+unsigned int TetrisBotDriverInput(TetrisBotDriver *driver, const TetrisBot *bot, const TetrisGame *game);
+
+#endif // TETRIS_AI_H
@@ -0,0 +1,435 @@
+#include "tetris_core.h"
+#include <string.h>
+
+// Piece masks for every type and rotation, indexed by type - TETRO_CYAN.
+// Orientations follow the Super Rotation System: J, L, S, T and Z turn inside
+// a 3x3 box, I inside a 4x4 box and O does not move.
+static const TetrisPieceMask pieceMasks[7][4] = {
+    // I
+    {
+        {{0x0, 0xF, 0x0, 0x0}, 0, 3, 1, 1},
+        {{0x4, 0x4, 0x4, 0x4}, 2, 2, 0, 3},
+        {{0x0, 0x0, 0xF, 0x0}, 0, 3, 2, 2},
+        {{0x2, 0x2, 0x2, 0x2}, 1, 1, 0, 3}
+    },
+    // J
+    {
+        {{0x1, 0x7, 0x0, 0x0}, 0, 2, 0, 1},
+        {{0x6, 0x2, 0x2, 0x0}, 1, 2, 0, 2},
+        {{0x0, 0x7, 0x4, 0x0}, 0, 2, 1, 2},
+        {{0x2, 0x2, 0x3, 0x0}, 0, 1, 0, 2}
+    },
+    // L
+    {
+        {{0x4, 0x7, 0x0, 0x0}, 0, 2, 0, 1},
+        {{0x2, 0x2, 0x6, 0x0}, 1, 2, 0, 2},
+        {{0x0, 0x7, 0x1, 0x0}, 0, 2, 1, 2},
+        {{0x3, 0x2, 0x2, 0x0}, 0, 1, 0, 2}
+    },
+    // O
+    {
+        {{0x6, 0x6, 0x0, 0x0}, 1, 2, 0, 1},
+        {{0x6, 0x6, 0x0, 0x0}, 1, 2, 0, 1},
+        {{0x6, 0x6, 0x0, 0x0}, 1, 2, 0, 1},
+        {{0x6, 0x6, 0x0, 0x0}, 1, 2, 0, 1}
+    },
+    // S
+    {
+        {{0x6, 0x3, 0x0, 0x0}, 0, 2, 0, 1},
+        {{0x2, 0x6, 0x4, 0x0}, 1, 2, 0, 2},
+        {{0x0, 0x6, 0x3, 0x0}, 0, 2, 1, 2},
+        {{0x1, 0x3, 0x2, 0x0}, 0, 1, 0, 2}
+    },
+    // T
+    {
+        {{0x2, 0x7, 0x0, 0x0}, 0, 2, 0, 1},
+        {{0x2, 0x6, 0x2, 0x0}, 1, 2, 0, 2},
+        {{0x0, 0x7, 0x2, 0x0}, 0, 2, 1, 2},
+        {{0x2, 0x3, 0x2, 0x0}, 0, 1, 0, 2}
+    },
+    // Z
+    {
+        {{0x3, 0x6, 0x0, 0x0}, 0, 2, 0, 1},
+        {{0x4, 0x6, 0x2, 0x0}, 1, 2, 0, 2},
+        {{0x0, 0x3, 0x6, 0x0}, 0, 2, 1, 2},
+        {{0x2, 0x3, 0x1, 0x0}, 0, 1, 0, 2}
+    }
+};
+
+// SRS wall kick offsets, tried in order until one fits.
+// Indexed by [kind][from rotation][0 = clockwise, 1 = counter-clockwise][test].
+// Kind 0 is J, L, O, S, T, Z and kind 1 is I. Offsets are {dx, dy} in board
+// coordinates, so y grows downwards (the SRS tables list y upwards).
+static const int8_t wallKicks[2][4][2][5][2] = {
+    // J, L, O, S, T, Z
+    {
+        { {{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}},   // 0 -> R
+          {{0, 0}, { 1, 0}, { 1, -1}, {0, 2}, { 1, 2}} }, // 0 -> L
+        { {{0, 0}, { 1, 0}, { 1,  1}, {0, -2}, { 1, -2}},   // R -> 2
+          {{0, 0}, { 1, 0}, { 1,  1}, {0, -2}, { 1, -2}} }, // R -> 0
+        { {{0, 0}, { 1, 0}, { 1, -1}, {0, 2}, { 1, 2}},   // 2 -> L
+          {{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}} }, // 2 -> R
+        { {{0, 0}, {-1, 0}, {-1,  1}, {0, -2}, {-1, -2}},   // L -> 0
+          {{0, 0}, {-1, 0}, {-1,  1}, {0, -2}, {-1, -2}} }  // L -> 2
+    },
+    // I
+    {
+        { {{0, 0}, {-2, 0}, { 1, 0}, {-2,  1}, { 1, -2}},   // 0 -> R
+          {{0, 0}, {-1, 0}, { 2, 0}, {-1, -2}, { 2,  1}} }, // 0 -> L
+        { {{0, 0}, {-1, 0}, { 2, 0}, {-1, -2}, { 2,  1}},   // R -> 2
+          {{0, 0}, { 2, 0}, {-1, 0}, { 2, -1}, {-1,  2}} }, // R -> 0
+        { {{0, 0}, { 2, 0}, {-1, 0}, { 2, -1}, {-1,  2}},   // 2 -> L
+          {{0, 0}, { 1, 0}, {-2, 0}, { 1,  2}, {-2, -1}} }, // 2 -> R
+        { {{0, 0}, { 1, 0}, {-2, 0}, { 1,  2}, {-2, -1}},   // L -> 0
+          {{0, 0}, {-2, 0}, { 1, 0}, {-2,  1}, { 1, -2}} }  // L -> 2
+    }
+};
+
+const TetrisPieceMask *TetrisGetPieceMask(int type, int rotation) {
+    return &pieceMasks[type - TETRO_CYAN][rotation & 3];
+}
+
+bool TetrisBoardCollides(const TetrisBoard *board, const TetrisPieceMask *piece, int x, int y) {
+    // Walls and floor
+    if (x + piece->minX < 0 || x + piece->maxX >= TETRIS_COLS || y + piece->maxY >= TETRIS_ROWS) {
+        return true;
+    }
+    
+    // Rows above the board never collide
+    for (int row = piece->minY; row <= piece->maxY; row++) {
+        int boardY = y + row;
+        if (boardY < 0) continue;
+        
+        uint16_t mask = (x >= 0) ? (uint16_t)(piece->rows[row] << x) : (uint16_t)(piece->rows[row] >> -x);
+        if (board->rows[boardY] & mask) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Try to turn a piece in the given direction using the SRS kick tests.
+// On success x and y are moved by the kick that fit and the new rotation is
+// returned; otherwise -1 is returned and x and y are left untouched.
+int TetrisBoardRotate(const TetrisBoard *board, int type, int rotation, int direction, int *x, int *y) {
+    int from = rotation & 3;
+    int to = (from + direction) & 3;
+    const TetrisPieceMask *piece = TetrisGetPieceMask(type, to);
+    const int8_t (*kicks)[2] = wallKicks[type == TETRO_CYAN][from][direction < 0];
+    
+    for (int test = 0; test < 5; test++) {
+        int kickX = *x + kicks[test][0];
+        int kickY = *y + kicks[test][1];
+        if (!TetrisBoardCollides(board, piece, kickX, kickY)) {
+            *x = kickX;
+            *y = kickY;
+            return to;
+        }
+    }
+    return -1;
+}
+
+static uint8_t ColumnHeight(uint32_t column) {
+    return column ? (uint8_t)(TETRIS_ROWS - __builtin_ctz(column)) : 0;
+}
+
+// Rebuild the column view from the rows
+void TetrisBoardSyncColumns(TetrisBoard *board) {
+    for (int x = 0; x < TETRIS_COLS; x++) {
+        uint32_t column = 0;
+        for (int y = 0; y < TETRIS_ROWS; y++) {
+            column |= (uint32_t)(board->rows[y] >> x & 1) << y;
+        }
+        board->columns[x] = column;
+        board->heights[x] = ColumnHeight(column);
+    }
+}
+
+// Row a piece at (x, y) comes to rest on when dropped straight down; (x, y)
+// must not collide. The piece's columns are contiguous runs, so it stops on
+// the first filled cell (or the floor) under the lowest cell of any of its
+// columns: one bit scan per column instead of a collision test per row.
+int TetrisBoardDropY(const TetrisBoard *board, const TetrisPieceMask *piece, int x, int y) {
+    int landing = TETRIS_ROWS;
+    for (int col = piece->minX; col <= piece->maxX; col++) {
+        int bottom = piece->maxY;
+        while (!(piece->rows[bottom] >> col & 1)) bottom--;
+        
+        // First filled cell strictly below the piece's lowest cell in this column
+        int below = y + bottom + 1;
+        uint32_t column = board->columns[x + col];
+        if (below > 0) column &= ~((1u << below) - 1);
+        int stop = column ? __builtin_ctz(column) : TETRIS_ROWS;
+        if (stop - 1 - bottom < landing) landing = stop - 1 - bottom;
+    }
+    return landing;
+}
+
+// Remove full rows between top and bottom (inclusive) and shift the rows
+// above them down. colors may be NULL for boards without a renderer.
+// Returns the number of rows removed.
+int TetrisBoardClearLines(TetrisBoard *board, uint8_t (*colors)[TETRIS_COLS], int top, int bottom) {
+    if (top < 0) top = 0;
+    if (bottom >= TETRIS_ROWS) bottom = TETRIS_ROWS - 1;
+    
+    int linesCleared = 0;
+    for (int y = bottom; y >= top; y--) {
+        // After each removal the row above has moved into y
+        int row = y + linesCleared;
+        if (board->rows[row] != TETRIS_FULL_ROW) continue;
+        
+        memmove(&board->rows[1], &board->rows[0], row * sizeof(board->rows[0]));
+        board->rows[0] = 0;
+        if (colors) {
+            memmove(colors[1], colors[0], row * sizeof(colors[0]));
+            memset(colors[0], TETRO_EMPTY, sizeof(colors[0]));
+        }
+        
+        // Same shift per column: the bits above row move down by one
+        uint32_t above = (1u << row) - 1;
+        for (int x = 0; x < TETRIS_COLS; x++) {
+            uint32_t column = board->columns[x];
+            board->columns[x] = ((column & above) << 1) | (column & ~(above | (1u << row)));
+        }
+        linesCleared++;
+    }
+    
+    if (linesCleared > 0) {
+        for (int x = 0; x < TETRIS_COLS; x++) {
+            board->heights[x] = ColumnHeight(board->columns[x]);
+        }
+    }
+    return linesCleared;
+}
+
+// Deal the next piece type from a generator and, for BAG7, its bag. Games
+// and batched boards share this, so a seed deals the same pieces anywhere.
+int TetrisDealPiece(GameRng *rng, TetrisRandomizer randomizer, uint8_t bag[7], int *bagCount) {
+    if (randomizer == TETRIS_RANDOMIZER_BAG7) {
+        // Refill and shuffle (Fisher-Yates) once the bag runs out
+        if (*bagCount == 0) {
+            for (int i = 0; i < 7; i++) {
+                bag[i] = (uint8_t)(TETRO_CYAN + i);
+            }
+            for (int i = 6; i > 0; i--) {
+                int j = (int)RngRange(rng, (uint32_t)i + 1);
+                uint8_t tmp = bag[i];
+                bag[i] = bag[j];
+                bag[j] = tmp;
+            }
+            *bagCount = 7;
+        }
+        return bag[--*bagCount];
+    }
+    return (int)RngRange(rng, 7) + TETRO_CYAN;
+}
+
+// Draw the next piece type from the game's own generator
+static int NextPieceType(TetrisGame *game) {
+    return TetrisDealPiece(&game->rng, game->randomizer, game->bag, &game->bagCount);
+}
+
+// Write a piece into the board (and colors, if given) and clear the lines it
+// completed. Returns the number of lines cleared.
+int TetrisBoardPlace(TetrisBoard *board, uint8_t (*colors)[TETRIS_COLS], int type, int rotation, int x, int y) {
+    const TetrisPieceMask *piece = TetrisGetPieceMask(type, rotation);
+    
+    for (int row = piece->minY; row <= piece->maxY; row++) {
+        int boardY = y + row;
+        if (boardY < 0) continue;
+        
+        board->rows[boardY] |= (x >= 0) ? (uint16_t)(piece->rows[row] << x) : (uint16_t)(piece->rows[row] >> -x);
+        for (int col = piece->minX; col <= piece->maxX; col++) {
+            if (!(piece->rows[row] & (1u << col))) continue;
+            board->columns[x + col] |= 1u << boardY;
+            if (colors) colors[boardY][x + col] = (uint8_t)type;
+        }
+    }
+    
+    // Only the piece's own columns can have grown
+    for (int col = piece->minX; col <= piece->maxX; col++) {
+        board->heights[x + col] = ColumnHeight(board->columns[x + col]);
+    }
+    
+    // Only the rows the piece touched can have been completed
+    return TetrisBoardClearLines(board, colors, y + piece->minY, y + piece->maxY);
+}
+
+void InitTetrisGame(TetrisGame *game, uint64_t seed, TetrisRandomizer randomizer) {
+    // Initialize grid
+    memset(&game->board, 0, sizeof(game->board));
+    memset(game->colors, TETRO_EMPTY, sizeof(game->colors));
+    
+    // Initialize game state
+    game->pieceX = TETRIS_SPAWN_X;
+    game->pieceY = TETRIS_SPAWN_Y;
+    game->rotation = 0;
+    game->fallSpeed = 1.0f;
+    game->score = 0;
+    game->level = 1;
+    game->linesCleared = 0;
+    game->pieceCount = 0;
+    game->boardVersion = 0;
+    game->clearedRows = 0;
+    game->fallTimer = 0.0f;
+    game->gameOver = false;
+    
+    // Initialize random seed
+    game->seed = seed;
+    game->randomizer = randomizer;
+    game->bagCount = 0;
+    RngSeed(&game->rng, seed);
+    
+    // Get first pieces
+    game->currentPieceType = NextPieceType(game);
+    game->nextPieceType = NextPieceType(game);
+}
+
+bool CheckCollision(TetrisGame *game, int offsetX, int offsetY) {
+    return TetrisBoardCollides(&game->board,
+                               TetrisGetPieceMask(game->currentPieceType, game->rotation),
+                               game->pieceX + offsetX, game->pieceY + offsetY);
+}
+
+void LockPiece(TetrisGame *game) {
+    // Note the rows this piece completes while they are still on the board
+    const TetrisPieceMask *piece = TetrisGetPieceMask(game->currentPieceType, game->rotation);
+    game->clearedRows = 0;
+    for (int row = piece->minY; row <= piece->maxY; row++) {
+        int boardY = game->pieceY + row;
+        if (boardY < 0 || boardY >= TETRIS_ROWS) continue;
+        uint16_t bits = (game->pieceX >= 0) ? (uint16_t)(piece->rows[row] << game->pieceX)
+                                            : (uint16_t)(piece->rows[row] >> -game->pieceX);
+        if ((game->board.rows[boardY] | bits) == TETRIS_FULL_ROW) game->clearedRows |= 1u << boardY;
+    }
+    
+    int linesCleared = TetrisBoardPlace(&game->board, game->colors, game->currentPieceType,
+                                        game->rotation, game->pieceX, game->pieceY);
+    game->pieceCount++;
+    game->boardVersion++;
+    
+    // Update score
+    if (linesCleared > 0) {
+        int points = 0;
+        switch (linesCleared) {
+            case 1: points = 100; break;
+            case 2: points = 300; break;
+            case 3: points = 500; break;
+            case 4: points = 800; break;
+        }
+        game->score += points * game->level;
+        game->linesCleared += linesCleared;
+        game->level = game->linesCleared / 10 + 1;
+        game->fallSpeed = 0.5f / game->level;
+    }
+    
+    // Get next piece
+    game->currentPieceType = game->nextPieceType;
+    game->nextPieceType = NextPieceType(game);
+    
+    // Reset position
+    game->pieceX = TETRIS_SPAWN_X;
+    game->pieceY = TETRIS_SPAWN_Y;
+    game->rotation = 0;
+    
+    // Check if game over
+    if (CheckCollision(game, 0, 0)) {
+        game->gameOver = true;
+    }
+}
+
+int TetrisLandingY(const TetrisGame *game) {
+    return TetrisBoardDropY(&game->board, TetrisGetPieceMask(game->currentPieceType, game->rotation),
+                            game->pieceX, game->pieceY);
+}
+
+// Push the stack up by lines rows that are full but for the hole column.
+// The game ends when that pushes blocks off the top or into the falling piece.
+bool TetrisAddGarbage(TetrisGame *game, int lines, int hole) {
+    if (lines <= 0 || game->gameOver) return !game->gameOver;
+    if (lines > TETRIS_ROWS) lines = TETRIS_ROWS;
+    if (hole < 0) hole = 0;
+    if (hole >= TETRIS_COLS) hole = TETRIS_COLS - 1;
+    
+    TetrisBoard *board = &game->board;
+    bool overflow = false;
+    for (int y = 0; y < lines; y++) {
+        if (board->rows[y]) overflow = true;
+    }
+    
+    memmove(&board->rows[0], &board->rows[lines], (TETRIS_ROWS - lines) * sizeof(board->rows[0]));
+    memmove(&game->colors[0], &game->colors[lines], (TETRIS_ROWS - lines) * sizeof(game->colors[0]));
+    for (int y = TETRIS_ROWS - lines; y < TETRIS_ROWS; y++) {
+        board->rows[y] = (uint16_t)(TETRIS_FULL_ROW & ~(1u << hole));
+        memset(game->colors[y], TETRO_GARBAGE, TETRIS_COLS);
+        game->colors[y][hole] = TETRO_EMPTY;
+    }
+    TetrisBoardSyncColumns(board);
+    game->boardVersion++;
+    
+    if (overflow || CheckCollision(game, 0, 0)) game->gameOver = true;
+    return !game->gameOver;
+}
+
+void RotatePiece(TetrisGame *game, int direction) {
+    // Rotation is an index change; the position only moves by the kick that fit
+    int rotation = TetrisBoardRotate(&game->board, game->currentPieceType, game->rotation,
+                                     direction, &game->pieceX, &game->pieceY);
+    if (rotation >= 0) {
+        game->rotation = rotation;
+    }
+}
+
+void StepTetrisGame(TetrisGame *game, unsigned int input, float dt) {
+    if (game->gameOver) {
+        if (input & TETRIS_INPUT_RESTART) {
+            // Derive the next seed so a whole session replays from the first one
+            uint32_t boardVersion = game->boardVersion;
+            InitTetrisGame(game, RngNext64(&game->rng), game->randomizer);
+            game->boardVersion = boardVersion + 1;
+        }
+        return;
+    }
+    
+    // Move left
+    if ((input & TETRIS_INPUT_LEFT) && !CheckCollision(game, -1, 0)) {
+        game->pieceX--;
+    }
+    
+    // Move right
+    if ((input & TETRIS_INPUT_RIGHT) && !CheckCollision(game, 1, 0)) {
+        game->pieceX++;
+    }
+    
+    // Rotate
+    if (input & TETRIS_INPUT_ROTATE) {
+        RotatePiece(game, TETRIS_ROTATE_CW);
+    }
+    if (input & TETRIS_INPUT_ROTATE_CCW) {
+        RotatePiece(game, TETRIS_ROTATE_CCW);
+    }
+    
+    // Soft drop
+    if (input & TETRIS_INPUT_SOFT_DROP) {
+        game->fallTimer += 2 * dt;
+    }
+    
+    // Hard drop
+    if (input & TETRIS_INPUT_HARD_DROP) {
+        game->pieceY = TetrisLandingY(game);
+        LockPiece(game);
+        return;
+    }
+    
+    // Fall
+    game->fallTimer += dt;
+    if (game->fallTimer >= game->fallSpeed) {
+        game->fallTimer = 0;
+        
+        if (!CheckCollision(game, 0, 1)) {
+            game->pieceY++;
+        } else {
+            LockPiece(game);
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef TETRIS_CORE_H
+#define TETRIS_CORE_H
+
+// Raylib-free Tetris rules. Everything in here can run without a window,
+// so headless tools (simulators, benchmarks, bots) link only this module.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "rng.h"
+
+// Board dimensions
+#define TETRIS_COLS 10
+#define TETRIS_ROWS 20
+
+// Where new pieces appear
+#define TETRIS_SPAWN_X 3
+#define TETRIS_SPAWN_Y 0
+
+// Row mask with every column filled
+#define TETRIS_FULL_ROW 0x3FF
+
+// Tetromino types
+typedef enum {
+    TETRO_EMPTY = 0,
+    TETRO_CYAN,
+    TETRO_BLUE,
+    TETRO_ORANGE,
+    TETRO_YELLOW,
+    TETRO_GREEN,
+    TETRO_PURPLE,
+    TETRO_RED,
+    TETRO_GARBAGE       // rows sent by a versus opponent; never a piece
+} TetrominoType;
+
+// Input bits for a single simulation step.
+// Move, rotate, hard drop and restart are edge-triggered (set them only on the
+// tick the key went down); soft drop is level-triggered (set while held).
+typedef enum {
+    TETRIS_INPUT_LEFT      = 1 << 0,
+    TETRIS_INPUT_RIGHT     = 1 << 1,
+    TETRIS_INPUT_ROTATE    = 1 << 2,
+    TETRIS_INPUT_SOFT_DROP = 1 << 3,
+    TETRIS_INPUT_HARD_DROP = 1 << 4,
+    TETRIS_INPUT_RESTART   = 1 << 5,
+    TETRIS_INPUT_ROTATE_CCW = 1 << 6
+} TetrisInput;
+
+// How the next piece type is chosen
+typedef enum {
+    TETRIS_RANDOMIZER_UNIFORM = 0, // each piece drawn independently
+    TETRIS_RANDOMIZER_BAG7         // shuffled bag holding one of each piece
+} TetrisRandomizer;
+
+// Rotation directions for RotatePiece
+#define TETRIS_ROTATE_CW   1
+#define TETRIS_ROTATE_CCW -1
+
+// Occupancy bitboard: bit x of rows[y] is set when cell (x, y) is filled.
+// The same cells are kept per column, so the surface and the first filled
+// cell under any row are one bit scan away; TetrisBoardPlace and
+// TetrisBoardClearLines keep both views in step.
+typedef struct {
+    uint16_t rows[TETRIS_ROWS];
+    uint32_t columns[TETRIS_COLS];  // bit y of columns[x] is set when cell (x, y) is filled
+    uint8_t heights[TETRIS_COLS];   // rows from the floor to the top filled cell; 0 if empty
+} TetrisBoard;
+
+// Precomputed mask for one piece orientation inside its 4x4 box
+typedef struct {
+    uint16_t rows[4];   // bit x of rows[y] is set when cell (x, y) is filled
+    int8_t minX, maxX;  // bounding box: occupied columns
+    int8_t minY, maxY;  // bounding box: occupied rows
+} TetrisPieceMask;
+
+typedef struct {
+    TetrisBoard board;
+    uint8_t colors[TETRIS_ROWS][TETRIS_COLS]; // TetrominoType per cell, read only by the renderer
+    int pieceX, pieceY;
+    int nextPieceType;
+    int currentPieceType;
+    int rotation;
+    float fallTimer;
+    float fallSpeed;
+    int score;
+    int level;
+    int linesCleared;
+    uint32_t pieceCount;    // pieces locked so far
+    uint32_t boardVersion;  // changes whenever board or colors change, for render caches
+    uint32_t clearedRows;   // bit y set for each row the last lock cleared, numbered before the clear
+    bool gameOver;
+    
+    // Piece randomizer; the same seed always deals the same pieces
+    uint64_t seed;
+    GameRng rng;
+    TetrisRandomizer randomizer;
+    uint8_t bag[7];
+    int bagCount;
+} TetrisGame;
+
+// Function declarations
+const TetrisPieceMask *TetrisGetPieceMask(int type, int rotation);
+bool TetrisBoardCollides(const TetrisBoard *board, const TetrisPieceMask *piece, int x, int y);
+int TetrisBoardRotate(const TetrisBoard *board, int type, int rotation, int direction, int *x, int *y);
+int TetrisBoardClearLines(TetrisBoard *board, uint8_t (*colors)[TETRIS_COLS], int top, int bottom);
+int TetrisBoardPlace(TetrisBoard *board, uint8_t (*colors)[TETRIS_COLS], int type, int rotation, int x, int y);
+void TetrisBoardSyncColumns(TetrisBoard *board);    // after writing rows directly
+int TetrisBoardDropY(const TetrisBoard *board, const TetrisPieceMask *piece, int x, int y);
+
+int TetrisDealPiece(GameRng *rng, TetrisRandomizer randomizer, uint8_t bag[7], int *bagCount);
+
+void InitTetrisGame(TetrisGame *game, uint64_t seed, TetrisRandomizer randomizer);
+bool CheckCollision(TetrisGame *game, int offsetX, int offsetY);
+void LockPiece(TetrisGame *game);
+void RotatePiece(TetrisGame *game, int direction);
+int TetrisLandingY(const TetrisGame *game);     // where a hard drop puts the piece; the ghost row
+bool TetrisAddGarbage(TetrisGame *game, int lines, int hole);   // false when it ends the game; hole is clamped to the board
+
+// Advance the game by one step of dt seconds using a TetrisInput bitmask
+void StepTetrisGame(TetrisGame *game, unsigned int input, float dt);
+
+#endif // TETRIS_CORE_H
@@ -0,0 +1,184 @@
+#include "tetris_env.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Shared state for one parallel step; each task owns a chunk of boards
+typedef struct {
+    TetrisEnv *env;
+    const uint8_t *actions;
+    float *rewards;
+    uint8_t *dones;
+    TetrisEnvObservation *obs;
+} StepJob;
+
+// Take the next size bytes of the block
+static void *Carve(char **cursor, size_t size) {
+    void *p = *cursor;
+    *cursor += size;
+    return p;
+}
+
+// Start a new game on board i, dealing as InitTetrisGame does
+static void ResetBoard(TetrisEnv *env, int i, uint64_t seed) {
+    memset(&env->boards[i], 0, sizeof(TetrisBoard));
+    RngSeed(&env->rngs[i], seed);
+    env->bagCounts[i] = 0;
+    env->pieces[i] = (uint8_t)TetrisDealPiece(&env->rngs[i], env->randomizer, env->bags[i], &env->bagCounts[i]);
+    env->nextPieces[i] = (uint8_t)TetrisDealPiece(&env->rngs[i], env->randomizer, env->bags[i], &env->bagCounts[i]);
+    env->steps[i] = 0;
+    env->lines[i] = 0;
+}
+
+bool TetrisEnvInit(TetrisEnv *env, int count, uint64_t seed, TetrisRandomizer randomizer) {
+    memset(env, 0, sizeof(*env));
+    if (count < 1) return false;
+    
+    // Widest alignment first
+    size_t n = (size_t)count;
+    size_t size = n * (2 * sizeof(uint64_t) + sizeof(TetrisBoard) + sizeof(GameRng) +
+                       2 * sizeof(uint32_t) + sizeof(int) + 7 + 2);
+    char *cursor = calloc(1, size);
+    if (!cursor) return false;
+    env->block = cursor;
+    env->games = Carve(&cursor, n * sizeof(uint64_t));
+    env->gameLines = Carve(&cursor, n * sizeof(uint64_t));
+    env->boards = Carve(&cursor, n * sizeof(TetrisBoard));
+    env->rngs = Carve(&cursor, n * sizeof(GameRng));
+    env->steps = Carve(&cursor, n * sizeof(uint32_t));
+    env->lines = Carve(&cursor, n * sizeof(uint32_t));
+    env->bagCounts = Carve(&cursor, n * sizeof(int));
+    env->bags = Carve(&cursor, n * 7);
+    env->pieces = Carve(&cursor, n);
+    env->nextPieces = Carve(&cursor, n);
+    
+    env->count = count;
+    env->randomizer = randomizer;
+    
+    // Line rewards in units of the game's 100 points
+    const float lineRewards[5] = { 0.0f, 1.0f, 3.0f, 5.0f, 8.0f };
+    memcpy(env->lineRewards, lineRewards, sizeof(lineRewards));
+    env->topOutReward = -1.0f;
+    
+    for (int i = 0; i < count; i++) {
+        ResetBoard(env, i, seed + (uint64_t)i);
+    }
+    return true;
+}
+
+void TetrisEnvFree(TetrisEnv *env) {
+    free(env->block);
+    memset(env, 0, sizeof(*env));
+}
+
+// Columns a rotation can take without clamping
+static int LastColumn(const TetrisPieceMask *piece) {
+    return TETRIS_COLS - 1 - (piece->maxX - piece->minX);
+}
+
+// Actions that place the piece without clamping or topping out. While the
+// spawn rows are empty every action that fits is legal, so only tall
+// stacks pay for collision tests.
+static uint64_t LegalActions(const TetrisBoard *board, int type) {
+    bool clear = (board->rows[0] | board->rows[1] | board->rows[2] | board->rows[3]) == 0;
+    uint64_t legal = 0;
+    for (int rotation = 0; rotation < 4; rotation++) {
+        const TetrisPieceMask *piece = TetrisGetPieceMask(type, rotation);
+        int last = LastColumn(piece);
+        if (clear) {
+            legal |= ((1ull << (last + 1)) - 1) << (rotation * TETRIS_COLS);
+            continue;
+        }
+        for (int column = 0; column <= last; column++) {
+            if (!TetrisBoardCollides(board, piece, column - piece->minX, TETRIS_SPAWN_Y)) {
+                legal |= 1ull << (rotation * TETRIS_COLS + column);
+            }
+        }
+    }
+    return legal;
+}
+
+static void ObserveBoard(const TetrisEnv *env, int i, TetrisEnvObservation *obs) {
+    const TetrisBoard *board = &env->boards[i];
+    obs->legal = LegalActions(board, env->pieces[i]);
+    memcpy(obs->rows, board->rows, sizeof(obs->rows));
+    memcpy(obs->heights, board->heights, sizeof(obs->heights));
+    obs->piece = env->pieces[i];
+    obs->next = env->nextPieces[i];
+    memset(obs->pad, 0, sizeof(obs->pad));
+}
+
+void TetrisEnvObserve(const TetrisEnv *env, TetrisEnvObservation *obs) {
+    for (int i = 0; i < env->count; i++) {
+        ObserveBoard(env, i, &obs[i]);
+    }
+}
+
+// Place board i's piece; returns its TetrisEnvDone and restarts the board
+// when the game ended
+static uint8_t StepBoard(TetrisEnv *env, int i, int action, float *reward) {
+    TetrisBoard *board = &env->boards[i];
+    int type = env->pieces[i];
+    int rotation = (action / TETRIS_COLS) & 3;
+    const TetrisPieceMask *piece = TetrisGetPieceMask(type, rotation);
+    int column = action % TETRIS_COLS;
+    if (column > LastColumn(piece)) column = LastColumn(piece);
+    int x = column - piece->minX;
+    
+    uint8_t done = TETRIS_ENV_RUNNING;
+    if (TetrisBoardCollides(board, piece, x, TETRIS_SPAWN_Y)) {
+        *reward = env->topOutReward;
+        done = TETRIS_ENV_TOPPED_OUT;
+    } else {
+        int y = TetrisBoardDropY(board, piece, x, TETRIS_SPAWN_Y);
+        int cleared = TetrisBoardPlace(board, NULL, type, rotation, x, y);
+        *reward = env->lineRewards[cleared];
+        env->lines[i] += (uint32_t)cleared;
+        env->steps[i]++;
+        
+        // The game ends when the next piece cannot spawn, as in LockPiece
+        env->pieces[i] = env->nextPieces[i];
+        env->nextPieces[i] = (uint8_t)TetrisDealPiece(&env->rngs[i], env->randomizer, env->bags[i], &env->bagCounts[i]);
+        if (TetrisBoardCollides(board, TetrisGetPieceMask(env->pieces[i], 0), TETRIS_SPAWN_X, TETRIS_SPAWN_Y)) {
+            *reward += env->topOutReward;
+            done = TETRIS_ENV_TOPPED_OUT;
+        } else if (env->maxSteps && env->steps[i] >= env->maxSteps) {
+            done = TETRIS_ENV_TRUNCATED;
+        }
+    }
+    
+    if (done) {
+        env->games[i]++;
+        env->gameLines[i] += env->lines[i];
+        ResetBoard(env, i, RngNext64(&env->rngs[i]));
+    }
+    return done;
+}
+
+static void StepChunk(void *arg, int index, int worker) {
+    (void)worker;
+    StepJob *job = arg;
+    TetrisEnv *env = job->env;
+    int first = index * TETRIS_ENV_CHUNK;
+    int end = first + TETRIS_ENV_CHUNK < env->count ? first + TETRIS_ENV_CHUNK : env->count;
+    
+    for (int i = first; i < end; i++) {
+        float reward;
+        uint8_t done = StepBoard(env, i, job->actions[i] % TETRIS_ENV_ACTIONS, &reward);
+        if (job->rewards) job->rewards[i] = reward;
+        if (job->dones) job->dones[i] = done;
+        if (job->obs) ObserveBoard(env, i, &job->obs[i]);
+    }
+}
+
+void TetrisEnvStep(TetrisEnv *env, const uint8_t *actions, float *rewards, uint8_t *dones,
+                   TetrisEnvObservation *obs) {
+    StepJob job = {
+        .env = env,
+        .actions = actions,
+        .rewards = rewards,
+        .dones = dones,
+        .obs = obs
+    };
+    int chunks = (env->count + TETRIS_ENV_CHUNK - 1) / TETRIS_ENV_CHUNK;
+    ThreadPoolParallelFor(env->pool, chunks, StepChunk, &job);
+}
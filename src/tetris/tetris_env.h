@@ -0,0 +1,78 @@
+#ifndef TETRIS_ENV_H
+#define TETRIS_ENV_H
+
+// Batched Tetris environment for training placement policies.
+// Holds many boards in one allocation, one array per field, and steps all
+// of them at once: each step places every board's current piece where its
+// action says, then writes rewards, done flags and observations into
+// caller-owned arrays. Finished boards start a new game on the spot, so the
+// batch never stalls. Steps are split across a ThreadPool in chunks of
+// boards. No window, no per-tick simulation: one step is one placement.
+//
+// Board i with seed s deals the same pieces as InitTetrisGame(seed + i),
+// and a finished board is reseeded the way a restarted game is.
+
+#include "tetris_core.h"
+#include "thread_pool.h"
+
+// An action is rotation * TETRIS_COLS + column: the piece is turned to
+// rotation, moved so its leftmost cell is in column (clamped so it fits)
+// and dropped straight down from the spawn row
+#define TETRIS_ENV_ACTIONS (4 * TETRIS_COLS)
+
+// Boards per parallel task
+#define TETRIS_ENV_CHUNK 256
+
+// Done flags
+typedef enum {
+    TETRIS_ENV_RUNNING = 0,
+    TETRIS_ENV_TOPPED_OUT,  // the piece or the next one did not fit
+    TETRIS_ENV_TRUNCATED    // reached maxSteps placements
+} TetrisEnvDone;
+
+// What a policy sees of one board; one cache line
+typedef struct {
+    uint64_t legal;             // bit a is set when action a fits unclamped and does not top out
+    uint16_t rows[TETRIS_ROWS]; // occupancy, as TetrisBoard rows
+    uint8_t heights[TETRIS_COLS];
+    uint8_t piece;              // TetrominoType to place
+    uint8_t next;               // TetrominoType after it
+    uint8_t pad[4];
+} TetrisEnvObservation;
+
+typedef struct {
+    int count;
+    TetrisRandomizer randomizer;
+    uint32_t maxSteps;          // placements per game before truncation; 0 for none
+    float lineRewards[5];       // reward by lines cleared in one placement
+    float topOutReward;
+    ThreadPool *pool;           // NULL steps on the calling thread
+    
+    // Per board, all carved from one block
+    TetrisBoard *boards;
+    GameRng *rngs;
+    uint8_t (*bags)[7];
+    int *bagCounts;
+    uint8_t *pieces;
+    uint8_t *nextPieces;
+    uint32_t *steps;            // placements this game
+    uint32_t *lines;            // lines this game
+    uint64_t *games;            // games finished
+    uint64_t *gameLines;        // lines over the finished games
+    void *block;
+} TetrisEnv;
+
+// Function declarations
+bool TetrisEnvInit(TetrisEnv *env, int count, uint64_t seed, TetrisRandomizer randomizer);
+void TetrisEnvFree(TetrisEnv *env);
+
+// Observations of every board; obs holds count entries
+void TetrisEnvObserve(const TetrisEnv *env, TetrisEnvObservation *obs);
+
+// One placement on every board. actions, rewards, dones and obs hold count
+// entries; rewards, dones and obs may be NULL. A finished board reports its
+// final reward and done flag, and obs already shows its new game.
+void TetrisEnvStep(TetrisEnv *env, const uint8_t *actions, float *rewards, uint8_t *dones,
+                   TetrisEnvObservation *obs);
+
+#endif // TETRIS_ENV_H
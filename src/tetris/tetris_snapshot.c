@@ -0,0 +1,188 @@
+#include "tetris_snapshot.h"
+
+typedef enum {
+    SECTION_ROWS  = 1 << 0,
+    SECTION_PIECE = 1 << 1,
+    SECTION_FALL  = 1 << 2,
+    SECTION_SCORE = 1 << 3,
+    SECTION_STATE = 1 << 4,
+    SECTION_RNG   = 1 << 5,
+    SECTION_ALL   = (1 << 6) - 1
+} TetrisSection;
+
+static bool SameFloat(float a, float b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// Sections of game that differ from base; everything but the board for a
+// snapshot, whose rows are compared against an empty board
+static uint32_t ChangedSections(const TetrisGame *base, const TetrisGame *game, uint32_t *rows) {
+    static const uint8_t empty[TETRIS_COLS];
+    *rows = 0;
+    for (int y = 0; y < TETRIS_ROWS; y++) {
+        const uint8_t *before = base ? base->colors[y] : empty;
+        if (memcmp(before, game->colors[y], TETRIS_COLS) != 0) *rows |= 1u << y;
+    }
+    if (!base) return SECTION_ALL & ~(*rows ? 0 : SECTION_ROWS);
+    
+    uint32_t sections = *rows ? SECTION_ROWS : 0;
+    if (base->currentPieceType != game->currentPieceType || base->rotation != game->rotation ||
+        base->pieceX != game->pieceX || base->pieceY != game->pieceY ||
+        base->nextPieceType != game->nextPieceType) sections |= SECTION_PIECE;
+    if (!SameFloat(base->fallTimer, game->fallTimer)) sections |= SECTION_FALL;
+    if (base->score != game->score || base->level != game->level ||
+        base->linesCleared != game->linesCleared || base->pieceCount != game->pieceCount ||
+        !SameFloat(base->fallSpeed, game->fallSpeed)) sections |= SECTION_SCORE;
+    if (base->gameOver != game->gameOver || base->randomizer != game->randomizer) sections |= SECTION_STATE;
+    if (base->seed != game->seed || memcmp(&base->rng, &game->rng, sizeof(GameRng)) != 0 ||
+        base->bagCount != game->bagCount ||
+        memcmp(base->bag, game->bag, (size_t)game->bagCount) != 0) sections |= SECTION_RNG;
+    return sections;
+}
+
+static int Encode(const TetrisGame *base, const TetrisGame *game, uint8_t *out, int size) {
+    uint32_t rows;
+    uint32_t sections = ChangedSections(base, game, &rows);
+    uint8_t kind = SNAPSHOT_TETRIS | (base ? SNAPSHOT_DELTA : 0);
+    
+    SnapshotWriter w;
+    SnapshotWriterInit(&w, out, size);
+    SnapshotPutHeader(&w, kind, TETRIS_SNAPSHOT_VERSION, sections);
+    
+    if (sections & SECTION_ROWS) {
+        SnapshotPutVarint(&w, rows);
+        for (int y = 0; y < TETRIS_ROWS; y++) {
+            if (!(rows >> y & 1)) continue;
+            uint32_t occupied = 0;
+            for (int x = 0; x < TETRIS_COLS; x++) {
+                if (game->colors[y][x] != TETRO_EMPTY) occupied |= 1u << x;
+            }
+            SnapshotPutBits(&w, occupied, TETRIS_COLS);
+            for (int x = 0; x < TETRIS_COLS; x++) {
+                if (occupied >> x & 1) SnapshotPutBits(&w, game->colors[y][x] & 7, 3);
+            }
+        }
+        SnapshotFlushBits(&w);
+    }
+    if (sections & SECTION_PIECE) {
+        SnapshotPutU8(&w, (uint8_t)game->currentPieceType);
+        SnapshotPutU8(&w, (uint8_t)game->rotation);
+        SnapshotPutU8(&w, (uint8_t)(int8_t)game->pieceX);
+        SnapshotPutU8(&w, (uint8_t)(int8_t)game->pieceY);
+        SnapshotPutU8(&w, (uint8_t)game->nextPieceType);
+    }
+    if (sections & SECTION_FALL) {
+        SnapshotPutF32(&w, game->fallTimer);
+    }
+    if (sections & SECTION_SCORE) {
+        SnapshotPutVarint(&w, (uint32_t)game->score);
+        SnapshotPutVarint(&w, (uint32_t)game->level);
+        SnapshotPutVarint(&w, (uint32_t)game->linesCleared);
+        SnapshotPutVarint(&w, game->pieceCount);
+        SnapshotPutF32(&w, game->fallSpeed);
+    }
+    if (sections & SECTION_STATE) {
+        SnapshotPutU8(&w, game->gameOver);
+        SnapshotPutU8(&w, (uint8_t)game->randomizer);
+    }
+    if (sections & SECTION_RNG) {
+        SnapshotPutU64(&w, game->seed);
+        for (int i = 0; i < 4; i++) SnapshotPutU32(&w, game->rng.s[i]);
+        SnapshotPutU8(&w, (uint8_t)game->bagCount);
+        for (int i = 0; i < game->bagCount; i++) SnapshotPutBits(&w, game->bag[i], 3);
+        SnapshotFlushBits(&w);
+    }
+    return w.overflow ? 0 : w.size;
+}
+
+// Read the sections of a snapshot or delta into game
+static bool Decode(TetrisGame *game, const uint8_t *data, int size, uint8_t kind) {
+    SnapshotReader r;
+    SnapshotReaderInit(&r, data, size);
+    uint32_t sections;
+    if (!SnapshotGetHeader(&r, kind, TETRIS_SNAPSHOT_VERSION, &sections)) return false;
+    if (sections & ~(uint32_t)SECTION_ALL) return false;
+    
+    if (sections & SECTION_ROWS) {
+        uint32_t rows = (uint32_t)SnapshotGetVarint(&r);
+        if (rows >> TETRIS_ROWS) return false;
+        for (int y = 0; y < TETRIS_ROWS; y++) {
+            if (!(rows >> y & 1)) continue;
+            uint32_t occupied = SnapshotGetBits(&r, TETRIS_COLS);
+            for (int x = 0; x < TETRIS_COLS; x++) {
+                uint8_t color = (occupied >> x & 1) ? (uint8_t)SnapshotGetBits(&r, 3) : TETRO_EMPTY;
+                if ((occupied >> x & 1) && color == TETRO_EMPTY) color = TETRO_GARBAGE;
+                game->colors[y][x] = color;
+            }
+            game->board.rows[y] = (uint16_t)occupied;
+        }
+        TetrisBoardSyncColumns(&game->board);
+        SnapshotAlignBits(&r);
+        game->boardVersion++;
+    }
+    if (sections & SECTION_PIECE) {
+        game->currentPieceType = SnapshotGetU8(&r);
+        game->rotation = SnapshotGetU8(&r) & 3;
+        game->pieceX = (int8_t)SnapshotGetU8(&r);
+        game->pieceY = (int8_t)SnapshotGetU8(&r);
+        game->nextPieceType = SnapshotGetU8(&r);
+    }
+    if (sections & SECTION_FALL) {
+        game->fallTimer = SnapshotGetF32(&r);
+    }
+    if (sections & SECTION_SCORE) {
+        game->score = (int)(uint32_t)SnapshotGetVarint(&r);
+        game->level = (int)(uint32_t)SnapshotGetVarint(&r);
+        game->linesCleared = (int)(uint32_t)SnapshotGetVarint(&r);
+        game->pieceCount = (uint32_t)SnapshotGetVarint(&r);
+        game->fallSpeed = SnapshotGetF32(&r);
+    }
+    if (sections & SECTION_STATE) {
+        game->gameOver = SnapshotGetU8(&r) != 0;
+        game->randomizer = SnapshotGetU8(&r) ? TETRIS_RANDOMIZER_BAG7 : TETRIS_RANDOMIZER_UNIFORM;
+    }
+    if (sections & SECTION_RNG) {
+        game->seed = SnapshotGetU64(&r);
+        for (int i = 0; i < 4; i++) game->rng.s[i] = SnapshotGetU32(&r);
+        game->bagCount = SnapshotGetU8(&r);
+        if (game->bagCount > 7) return false;
+        for (int i = 0; i < game->bagCount; i++) {
+            game->bag[i] = (uint8_t)SnapshotGetBits(&r, 3);
+            if (game->bag[i] == TETRO_EMPTY) return false;
+        }
+        SnapshotAlignBits(&r);
+    }
+    
+    // Piece types index the mask table, and a falling piece must be inside
+    // the board, or locking it would write outside the board
+    bool pieces = game->currentPieceType >= TETRO_CYAN && game->currentPieceType <= TETRO_RED &&
+                  game->nextPieceType >= TETRO_CYAN && game->nextPieceType <= TETRO_RED;
+    if (!pieces || r.error || r.pos != r.size) return false;
+    const TetrisPieceMask *piece = TetrisGetPieceMask(game->currentPieceType, game->rotation);
+    return game->gameOver || (game->pieceY >= TETRIS_SPAWN_Y - 4 &&
+                              !TetrisBoardCollides(&game->board, piece, game->pieceX, game->pieceY));
+}
+
+int TetrisSnapshotSave(const TetrisGame *game, uint8_t *out, int size) {
+    return Encode(NULL, game, out, size);
+}
+
+bool TetrisSnapshotLoad(TetrisGame *game, const uint8_t *data, int size) {
+    TetrisGame loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    loaded.boardVersion = game->boardVersion + 1;  // render caches must redraw
+    if (!Decode(&loaded, data, size, SNAPSHOT_TETRIS)) return false;
+    *game = loaded;
+    return true;
+}
+
+int TetrisDeltaEncode(const TetrisGame *base, const TetrisGame *game, uint8_t *out, int size) {
+    return Encode(base, game, out, size);
+}
+
+bool TetrisDeltaApply(TetrisGame *game, const uint8_t *data, int size) {
+    TetrisGame applied = *game;
+    if (!Decode(&applied, data, size, SNAPSHOT_TETRIS | SNAPSHOT_DELTA)) return false;
+    *game = applied;
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef TETRIS_SNAPSHOT_H
+#define TETRIS_SNAPSHOT_H
+
+// Versioned snapshots of a TetrisGame and deltas between two of them, in
+// the stream format of snapshot.h. Sections, in stream order:
+//   ROWS   varint mask of changed rows (bit y), then for each changed row,
+//          top down: 10 occupancy bits and 3 bits (TetrominoType, 0 for
+//          garbage) per occupied cell; padded to a byte
+//   PIECE  u8 piece, u8 rotation, i8 x, i8 y, u8 next piece
+//   FALL   f32 fall timer
+//   SCORE  varint score, varint level, varint lines, varint pieces,
+//          f32 fall speed
+//   STATE  u8 game over, u8 randomizer
+//   RNG    u64 seed, 4 x u32 generator state, u8 bag count, then the pieces
+//          left in the bag at 3 bits each, padded to a byte
+// The occupancy bitboard is rebuilt from the colors, and only rows with
+// blocks are stored, so a snapshot of a typical board is well under
+// 100 bytes. A delta is usually just the fall timer, plus the piece when it
+// moves and the rows it locked into.
+
+#include "snapshot.h"
+#include "tetris_core.h"
+
+#define TETRIS_SNAPSHOT_VERSION 1
+
+// Largest snapshot or delta: every section, every row full
+#define TETRIS_SNAPSHOT_MAX 192
+
+// Function declarations
+
+// Returns the bytes written, or 0 if size is too small
+int TetrisSnapshotSave(const TetrisGame *game, uint8_t *out, int size);
+bool TetrisSnapshotLoad(TetrisGame *game, const uint8_t *data, int size);
+
+// What changed from base to game; applying it to a game equal to base
+// makes that game equal to game. Apply leaves the game untouched and
+// returns false on a malformed delta.
+int TetrisDeltaEncode(const TetrisGame *base, const TetrisGame *game, uint8_t *out, int size);
+bool TetrisDeltaApply(TetrisGame *game, const uint8_t *data, int size);
+
+#endif // TETRIS_SNAPSHOT_H
@@ -0,0 +1,104 @@
+#include "tetris_versus.h"
+#include <string.h>
+
+// Garbage rows sent by lines cleared with one piece
+static const int garbageForLines[5] = { 0, 0, 1, 2, 4 };
+
+static void StartMatch(TetrisVersus *versus, uint64_t seed) {
+    int matches = versus->matches;
+    memset(versus, 0, sizeof(*versus));
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        InitTetrisGame(&versus->games[p], seed, TETRIS_RANDOMIZER_BAG7);
+    }
+    RngSeed(&versus->rng, ~seed);
+    versus->result = VERSUS_RUNNING;
+    versus->matches = matches + 1;
+}
+
+void InitTetrisVersus(TetrisVersus *versus, uint64_t seed) {
+    versus->matches = 0;
+    StartMatch(versus, seed);
+}
+
+void StepTetrisVersus(TetrisVersus *versus, const uint8_t inputs[VERSUS_PLAYERS], float dt) {
+    uint32_t frame = versus->frame + 1;
+    
+    if (versus->result != VERSUS_RUNNING) {
+        if ((inputs[0] | inputs[1]) & TETRIS_INPUT_RESTART) {
+            StartMatch(versus, RngNext64(&versus->rng));
+        }
+        versus->frame = frame;
+        return;
+    }
+    
+    // Restart is for the match, not a single board
+    int sent[VERSUS_PLAYERS];
+    bool locked[VERSUS_PLAYERS];
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        TetrisGame *game = &versus->games[p];
+        int lines = game->linesCleared;
+        uint32_t pieces = game->pieceCount;
+        StepTetrisGame(game, inputs[p] & ~TETRIS_INPUT_RESTART, dt);
+        int cleared = game->linesCleared - lines;
+        sent[p] = garbageForLines[cleared < 4 ? cleared : 4];
+        locked[p] = game->pieceCount != pieces;
+    }
+    
+    // Sent rows first cancel what the sender has queued
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        int cancel = sent[p] < versus->pendingGarbage[p] ? sent[p] : versus->pendingGarbage[p];
+        versus->pendingGarbage[p] -= cancel;
+        sent[p] -= cancel;
+    }
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        int *pending = &versus->pendingGarbage[1 - p];
+        *pending = *pending + sent[p] < TETRIS_ROWS ? *pending + sent[p] : TETRIS_ROWS;
+        versus->linesSent[p] += sent[p];
+    }
+    
+    // Queued garbage rises once the receiver's piece has locked
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        if (!locked[p] || versus->pendingGarbage[p] == 0) continue;
+        int hole = (int)RngRange(&versus->rng, TETRIS_COLS);
+        TetrisAddGarbage(&versus->games[p], versus->pendingGarbage[p], hole);
+        versus->pendingGarbage[p] = 0;
+    }
+    
+    bool over0 = versus->games[0].gameOver, over1 = versus->games[1].gameOver;
+    if (over0 && over1) versus->result = VERSUS_DRAW;
+    else if (over0) versus->result = VERSUS_PLAYER_2_WINS;
+    else if (over1) versus->result = VERSUS_PLAYER_1_WINS;
+    versus->frame = frame;
+}
+
+// FNV-1a
+static uint32_t Hash(uint32_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t TetrisVersusChecksum(const TetrisVersus *versus) {
+    // Field by field, so struct padding never counts
+    uint32_t hash = 2166136261u;
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        const TetrisGame *game = &versus->games[p];
+        hash = Hash(hash, game->board.rows, sizeof(game->board.rows));
+        hash = Hash(hash, game->colors, sizeof(game->colors));
+        int fields[] = {
+            game->pieceX, game->pieceY, game->currentPieceType, game->nextPieceType, game->rotation,
+            game->score, game->level, game->linesCleared, (int)game->pieceCount, game->gameOver,
+            game->bagCount, versus->pendingGarbage[p], versus->linesSent[p]
+        };
+        hash = Hash(hash, fields, sizeof(fields));
+        hash = Hash(hash, &game->fallTimer, sizeof(game->fallTimer));
+        hash = Hash(hash, &game->fallSpeed, sizeof(game->fallSpeed));
+        hash = Hash(hash, game->rng.s, sizeof(game->rng.s));
+        hash = Hash(hash, game->bag, sizeof(game->bag));
+    }
+    int fields[] = { versus->result, versus->matches, (int)versus->frame };
+    hash = Hash(hash, fields, sizeof(fields));
+    return Hash(hash, versus->rng.s, sizeof(versus->rng.s));
+}
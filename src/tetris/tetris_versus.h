@@ -0,0 +1,42 @@
+#ifndef TETRIS_VERSUS_H
+#define TETRIS_VERSUS_H
+
+// Raylib-free two-player versus Tetris. Both players are dealt the same
+// pieces; clearing 2, 3 or 4 lines at once sends 1, 2 or 4 garbage rows
+// to the opponent, first cancelling garbage still queued for the sender.
+// Queued garbage rises from the bottom when the receiver next locks a
+// piece, all of it with the hole in one random column. The first player
+// to top out loses; a restart input from either player starts a rematch.
+//
+// The whole match is one flat struct with no pointers, so it can be saved
+// and restored with a plain copy (see rollback.h).
+
+#include "tetris_core.h"
+
+#define VERSUS_PLAYERS 2
+
+typedef enum {
+    VERSUS_RUNNING = -1,
+    VERSUS_PLAYER_1_WINS = 0,
+    VERSUS_PLAYER_2_WINS = 1,
+    VERSUS_DRAW = 2
+} VersusResult;
+
+typedef struct {
+    TetrisGame games[VERSUS_PLAYERS];
+    int pendingGarbage[VERSUS_PLAYERS];  // rows queued for each player
+    int linesSent[VERSUS_PLAYERS];       // garbage rows sent this match
+    int result;                          // VersusResult
+    int matches;                         // matches started, counting this one
+    uint32_t frame;
+    GameRng rng;                         // garbage holes and rematch seeds
+} TetrisVersus;
+
+// Function declarations
+void InitTetrisVersus(TetrisVersus *versus, uint64_t seed);
+void StepTetrisVersus(TetrisVersus *versus, const uint8_t inputs[VERSUS_PLAYERS], float dt);
+
+// Hash of everything that affects the simulation, for desync checks
+uint32_t TetrisVersusChecksum(const TetrisVersus *versus);
+
+#endif // TETRIS_VERSUS_H
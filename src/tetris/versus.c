@@ -0,0 +1,214 @@
+#include "versus.h"
+#include "raylib.h"
+#include "replay.h"
+#include "rollback.h"
+#include "tetris.h"
+#include "tetris_versus.h"
+#include "udp_link.h"
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VERSUS_BOARD_Y 80
+
+static const int boardX[VERSUS_PLAYERS] = { 40, 560 };
+
+// Scene state: the match, its rollback session and the link to the peer
+typedef struct {
+    TetrisVersus versus;
+    RollbackSession session;
+    UdpLink link;
+    bool connected;             // socket open and peer resolved
+    bool needsPlayer;           // both sides would pick the same player
+    int port;
+    char peerText[64];
+    TetrisRenderCache caches[VERSUS_PLAYERS];
+    unsigned int keys;          // keyboard bits read this frame
+    unsigned int pressed;       // key presses not yet taken by a frame
+} VersusScene;
+
+static int EnvInt(const char *name, int fallback) {
+    const char *value = getenv(name);
+    return value && *value ? atoi(value) : fallback;
+}
+
+static void StepVersus(void *state, const uint8_t inputs[2], void *user) {
+    (void)user;
+    StepTetrisVersus(state, inputs, 1.0f / REPLAY_TICK_RATE);
+}
+
+// Player 1 is the side with the lower address, then the lower port, so
+// two copies agree without being told; 0 when that cannot decide
+static int PickPlayer(const UdpLink *link) {
+    struct sockaddr_in local;
+    if (!UdpLinkLocalAddress(link, &local)) return 0;
+    uint64_t self = (uint64_t)ntohl(local.sin_addr.s_addr) << 16 | ntohs(local.sin_port);
+    uint64_t peer = (uint64_t)ntohl(link->peer.sin_addr.s_addr) << 16 | ntohs(link->peer.sin_port);
+    if (self == peer) return 0;
+    return self < peer ? 1 : 2;
+}
+
+static void *VersusSceneInit(void) {
+    VersusScene *scene = calloc(1, sizeof(VersusScene));
+    if (!scene) return NULL;
+    
+    // Peer address as host:port
+    char host[64] = "127.0.0.1";
+    int peerPort = 7002;
+    const char *peer = getenv("GAME_VERSUS_PEER");
+    if (peer && *peer) {
+        const char *colon = strrchr(peer, ':');
+        size_t length = colon ? (size_t)(colon - peer) : strlen(peer);
+        if (length >= sizeof(host)) length = sizeof(host) - 1;
+        memcpy(host, peer, length);
+        host[length] = '\0';
+        if (colon) peerPort = atoi(colon + 1);
+    }
+    scene->port = EnvInt("GAME_VERSUS_PORT", 7001);
+    uint64_t seed = (uint64_t)EnvInt("GAME_VERSUS_SEED", 1);
+    snprintf(scene->peerText, sizeof(scene->peerText), "%s:%d", host, peerPort);
+    
+    scene->connected = UdpLinkOpen(&scene->link, scene->port, seed + (uint64_t)scene->port) &&
+                       UdpLinkSetPeer(&scene->link, host, peerPort);
+    
+    // Both copies must agree on who is who, or each simulates a mirror of
+    // the other's match; an explicit setting always wins
+    int player = EnvInt("GAME_VERSUS_PLAYER", 0);
+    if (player != 1 && player != 2) player = scene->connected ? PickPlayer(&scene->link) : 1;
+    if (player == 0) {
+        scene->needsPlayer = true;
+        scene->connected = false;
+        player = 1;
+    }
+    
+    InitTetrisVersus(&scene->versus, seed);
+    if (!RollbackInit(&scene->session, &scene->versus, sizeof(scene->versus), player - 1,
+                      TETRIS_INPUT_SOFT_DROP, StepVersus, NULL)) {
+        UdpLinkClose(&scene->link);
+        free(scene);
+        return NULL;
+    }
+    scene->link.latencyMs = EnvInt("GAME_VERSUS_LATENCY", 0);
+    scene->link.jitterMs = EnvInt("GAME_VERSUS_JITTER", 0);
+    scene->link.loss = EnvInt("GAME_VERSUS_LOSS", 0) / 100.0f;
+    
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        InitTetrisRenderCache(&scene->caches[p]);
+    }
+    return scene;
+}
+
+static void VersusSceneUpdate(void *state, SceneStack *stack) {
+    VersusScene *scene = state;
+    
+    if (IsKeyPressed(KEY_ESCAPE)) {
+        ScenePop(stack);
+        return;
+    }
+    
+    // Presses are latched until a frame takes them, which can be a few
+    // ticks later while the session waits for the peer
+    scene->keys = ReadTetrisInput();
+    scene->pressed |= scene->keys & ~TETRIS_INPUT_SOFT_DROP;
+}
+
+// One tick: take the peer's inputs, simulate the next frame (rolling back
+// first if a prediction was wrong), then send our inputs
+static void VersusSceneTick(void *state, float dt) {
+    (void)dt;
+    VersusScene *scene = state;
+    if (!scene->connected) return;
+    
+    uint8_t packet[UDP_LINK_MAX_PACKET];
+    int size;
+    while ((size = UdpLinkReceive(&scene->link, packet, sizeof(packet))) > 0) {
+        RollbackReadPacket(&scene->session, packet, size);
+    }
+    
+    uint8_t input = (uint8_t)((scene->keys & TETRIS_INPUT_SOFT_DROP) | scene->pressed);
+    uint64_t rollbacks = scene->session.stats.rollbacks;
+    if (RollbackAdvance(&scene->session, input)) scene->pressed = 0;
+    
+    // A rollback restores boardVersion too, so a corrected board can come
+    // back with the version the cached one had
+    if (scene->session.stats.rollbacks != rollbacks) {
+        for (int p = 0; p < VERSUS_PLAYERS; p++) scene->caches[p].valid = false;
+    }
+    
+    size = RollbackWritePacket(&scene->session, packet, sizeof(packet));
+    UdpLinkSend(&scene->link, packet, size);
+}
+
+static void DrawPendingGarbage(int rows, int x) {
+    if (rows <= 0) return;
+    int height = rows * TETRIS_CELL_SIZE;
+    DrawRectangle(x - 12, VERSUS_BOARD_Y + TETRIS_ROWS * TETRIS_CELL_SIZE - height, 8, height, RED);
+}
+
+static void VersusSceneDraw(void *state, float alpha) {
+    (void)alpha;
+    VersusScene *scene = state;
+    const TetrisVersus *versus = &scene->versus;
+    const RollbackSession *session = &scene->session;
+    ClearBackground(BLACK);
+    
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        DrawTetrisGameAt(&versus->games[p], &scene->caches[p], boardX[p], VERSUS_BOARD_Y);
+        DrawPendingGarbage(versus->pendingGarbage[p], boardX[p]);
+        DrawText(p == session->localPlayer ? "YOU" : "OPPONENT", boardX[p], 10, 20,
+                 p == session->localPlayer ? GREEN : LIGHTGRAY);
+    }
+    
+    if (versus->result != VERSUS_RUNNING) {
+        const char *text = versus->result == VERSUS_DRAW ? "DRAW" :
+                           versus->result == session->localPlayer ? "YOU WIN" : "YOU LOSE";
+        DrawRectangle(0, 300, GetScreenWidth(), 90, Fade(BLACK, 0.8f));
+        DrawText(text, (GetScreenWidth() - MeasureText(text, 40)) / 2, 310, 40, YELLOW);
+        DrawText("ENTER: Rematch", (GetScreenWidth() - MeasureText("ENTER: Rematch", 20)) / 2, 360, 20, WHITE);
+    }
+    
+    // Connection and rollback figures along the bottom
+    const RollbackStats *stats = &session->stats;
+    int y = VERSUS_BOARD_Y + TETRIS_ROWS * TETRIS_CELL_SIZE + 15;
+    if (scene->needsPlayer) {
+        DrawText("Both sides would be the same player: set GAME_VERSUS_PLAYER=1 on one and 2 on the other",
+                 40, y, 16, RED);
+    } else if (!scene->connected) {
+        DrawText(TextFormat("Could not open UDP port %d or reach %s", scene->port, scene->peerText),
+                 40, y, 20, RED);
+    } else if (session->remoteFrame == 0) {
+        DrawText(TextFormat("Waiting for %s on port %d...", scene->peerText, scene->port), 40, y, 20, YELLOW);
+    } else {
+        DrawText(TextFormat("frame %u   rollbacks %llu (%.1f%%)   avg depth %.1f   resim avg %.1f us, max %.1f us   stalls %llu",
+                            session->frame, (unsigned long long)stats->rollbacks,
+                            stats->frames ? 100.0 * stats->rollbacks / stats->frames : 0.0,
+                            stats->rollbacks ? (double)stats->resimulated / stats->rollbacks : 0.0,
+                            stats->rollbacks ? stats->resimulateNs / 1e3 / stats->rollbacks : 0.0,
+                            stats->maxResimulateNs / 1e3, (unsigned long long)stats->stalls),
+                 40, y, 16, LIGHTGRAY);
+    }
+    DrawText("ARROWS/X/Z/SPACE: Play   ESC: Back to Menu", 40, y + 25, 16, GRAY);
+}
+
+static void VersusSceneShutdown(void *state) {
+    VersusScene *scene = state;
+    UdpLinkClose(&scene->link);
+    RollbackFree(&scene->session);
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        UnloadTetrisRenderCache(&scene->caches[p]);
+    }
+    free(scene);
+}
+
+const Scene versusScene = {
+    .title = "Tetris Versus",
+    .width = 1060,
+    .height = 760,
+    .tickRate = REPLAY_TICK_RATE,
+    .init = VersusSceneInit,
+    .update = VersusSceneUpdate,
+    .tick = VersusSceneTick,
+    .draw = VersusSceneDraw,
+    .shutdown = VersusSceneShutdown
+};
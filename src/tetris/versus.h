@@ -0,0 +1,16 @@
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include "scene.h"
+
+// Two-player versus Tetris against another copy of the game over UDP, with
+// rollback netcode. Configured through the environment:
+//   GAME_VERSUS_PORT     local UDP port (default 7001)
+//   GAME_VERSUS_PEER     host:port of the opponent (default 127.0.0.1:7002)
+//   GAME_VERSUS_PLAYER   1 or 2; by default the lower port is player 1
+//   GAME_VERSUS_SEED     piece seed, the same on both sides (default 1)
+//   GAME_VERSUS_LATENCY, GAME_VERSUS_JITTER (ms), GAME_VERSUS_LOSS (%)
+//                        artificial conditions added to outgoing packets
+extern const Scene versusScene;
+
+#endif // VERSUS_H
@@ -0,0 +1,118 @@
+// Dictionary indexing checks: every word is indexed whether or not the
+// data ends with a newline, whatever the data size modulo the 64-byte
+// scan block, and with the index split into chunks on a thread pool.
+//
+// Usage: test_dictionary
+
+#include "dictionary.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failures++; \
+    } \
+} while (0)
+
+// Five-letter lines, then one last word that makes the data exactly
+// size bytes; returns the number of words and the last word's length
+static int FillWords(char *out, size_t size, bool newline, int *lastLength) {
+    size_t end = size - (newline ? 1 : 0);
+    size_t n = 0;
+    int words = 0;
+    while (end - n > 11) {
+        memcpy(out + n, "house\n", 6);
+        n += 6;
+        words++;
+    }
+    *lastLength = (int)(end - n);
+    memset(out + n, 'z', end - n);
+    n = end;
+    if (newline) out[n++] = '\n';
+    return words + 1;
+}
+
+static void CheckWords(size_t size, bool newline) {
+    char data[256];
+    int lastLength;
+    int words = FillWords(data, size, newline, &lastLength);
+    HangmanDictionary dict;
+    bool ok = HangmanDictionaryLoadMemory(&dict, data, size, NULL);
+    CHECK(ok, "load of %zu bytes failed", size);
+    if (!ok) return;
+    
+    CHECK(dict.count == (uint32_t)words, "%zu bytes, %s trailing newline: %u words, want %d",
+          size, newline ? "with" : "no", dict.count, words);
+    if (dict.count == (uint32_t)words) {
+        int length = HangmanDictionaryLength(&dict, dict.count - 1);
+        CHECK(length == lastLength, "%zu bytes: last word has %d letters, want %d", size, length, lastLength);
+    }
+    HangmanDictionaryFree(&dict);
+}
+
+// A file big enough to be split into chunks, ending on a block boundary
+// with no newline; the pool must index the same words as one thread
+static void CheckChunked(void) {
+    const size_t size = 3 * 1024 * 1024;
+    char *data = malloc(size);
+    if (!data) return;
+    
+    GameRng rng;
+    RngSeed(&rng, 1);
+    uint32_t words = 0;
+    size_t n = 0;
+    while (n < size) {
+        size_t length = 2 + RngRange(&rng, 10);
+        if (length > size - n) length = size - n;
+        for (size_t i = 0; i < length; i++) data[n + i] = (char)('a' + RngRange(&rng, 26));
+        n += length;
+        words++;
+        if (n < size) data[n++] = '\n';
+    }
+    
+    // The data must end inside a word, not on the newline after one
+    if (data[size - 1] == '\n') {
+        data[size - 1] = 'a';
+        words++;
+    }
+    
+    ThreadPool *pool = ThreadPoolCreate(4);
+    HangmanDictionary serial, parallel;
+    bool ok = HangmanDictionaryLoadMemory(&serial, data, size, NULL);
+    ok = HangmanDictionaryLoadMemory(&parallel, data, size, pool) && ok;
+    CHECK(ok, "chunked load failed");
+    if (ok) {
+        CHECK(serial.count == words, "one thread: %u words, want %u", serial.count, words);
+        CHECK(parallel.count == words, "thread pool: %u words, want %u", parallel.count, words);
+        CHECK(serial.count == parallel.count &&
+              !memcmp(serial.offsets, parallel.offsets, serial.count * sizeof(uint32_t)),
+              "thread pool and one thread index different words");
+    }
+    HangmanDictionaryFree(&serial);
+    HangmanDictionaryFree(&parallel);
+    ThreadPoolDestroy(pool);
+    free(data);
+}
+
+int main(void) {
+    // Around one and two scan blocks, with and without a final newline
+    const size_t sizes[] = { 63, 64, 65, 127, 128, 129, 192 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        CheckWords(sizes[i], false);
+        CheckWords(sizes[i], true);
+    }
+    CheckChunked();
+    
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all dictionary checks passed\n");
+    return 0;
+}
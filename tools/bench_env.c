@@ -0,0 +1,183 @@
+// Batched Tetris environment benchmark.
+// Steps a TetrisEnv of many boards in lockstep with a random legal-action
+// policy, the way a training loop would, and reports board-steps per
+// second for 1, 2, 4, ... threads up to the requested maximum. Only
+// TetrisEnvStep is timed; choosing actions runs on the calling thread
+// between steps.
+//
+// Usage: bench_env [--boards N] [--steps S] [--threads T] [--seed S]
+//                  [--max-steps M] [--bag] [--json FILE|-]
+
+#include "tetris_env.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_RUNS 32
+
+typedef struct {
+    int threads;
+    double seconds;
+    long long boardSteps;
+    long long games;
+    long long lines;
+    double reward;
+} BenchRun;
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// splitmix64, the policy's own stream so actions do not depend on threading
+static uint64_t NextRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// A uniformly chosen legal action, or action 0 (a top-out) when none is left
+static uint8_t RandomLegalAction(uint64_t legal, uint64_t *rng) {
+    int count = __builtin_popcountll(legal);
+    if (count == 0) return 0;
+    for (int skip = (int)(NextRandom(rng) % (uint64_t)count); skip > 0; skip--) {
+        legal &= legal - 1;
+    }
+    return (uint8_t)__builtin_ctzll(legal);
+}
+
+static int RunBenchmark(int threads, int boards, int steps, uint64_t seed, uint32_t maxSteps,
+                        TetrisRandomizer randomizer, BenchRun *run) {
+    TetrisEnv env;
+    if (!TetrisEnvInit(&env, boards, seed, randomizer)) return -1;
+    env.maxSteps = maxSteps;
+    if (threads != 1) env.pool = ThreadPoolCreate(threads);
+    
+    uint8_t *actions = malloc((size_t)boards);
+    float *rewards = malloc((size_t)boards * sizeof(float));
+    uint8_t *dones = malloc((size_t)boards);
+    TetrisEnvObservation *obs = malloc((size_t)boards * sizeof(TetrisEnvObservation));
+    if (!actions || !rewards || !dones || !obs) return -1;
+    
+    memset(run, 0, sizeof(*run));
+    uint64_t rng = seed;
+    uint64_t elapsed = 0;
+    TetrisEnvObserve(&env, obs);
+    for (int step = 0; step < steps; step++) {
+        for (int i = 0; i < boards; i++) {
+            actions[i] = RandomLegalAction(obs[i].legal, &rng);
+        }
+        
+        uint64_t start = NowNs();
+        TetrisEnvStep(&env, actions, rewards, dones, obs);
+        elapsed += NowNs() - start;
+        
+        for (int i = 0; i < boards; i++) {
+            run->reward += rewards[i];
+        }
+    }
+    
+    for (int i = 0; i < boards; i++) {
+        run->games += (long long)env.games[i];
+        run->lines += (long long)env.gameLines[i];
+    }
+    run->threads = env.pool ? ThreadPoolSize(env.pool) : 1;
+    run->seconds = elapsed / 1e9;
+    run->boardSteps = (long long)boards * steps;
+    
+    free(actions);
+    free(rewards);
+    free(dones);
+    free(obs);
+    ThreadPoolDestroy(env.pool);
+    TetrisEnvFree(&env);
+    return 0;
+}
+
+static void WriteJson(FILE *out, int boards, int steps, uint64_t seed, const BenchRun *runs, int runCount) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"bench_env\",\n");
+    fprintf(out, "  \"boards\": %d,\n", boards);
+    fprintf(out, "  \"steps\": %d,\n", steps);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)seed);
+    fprintf(out, "  \"runs\": [\n");
+    for (int i = 0; i < runCount; i++) {
+        const BenchRun *r = &runs[i];
+        fprintf(out, "    {\"threads\": %d, \"seconds\": %.6f, \"board_steps\": %lld, "
+                     "\"board_steps_per_sec\": %.1f, \"games\": %lld, \"lines\": %lld, "
+                     "\"reward\": %.1f, \"speedup\": %.3f}%s\n",
+                r->threads, r->seconds, r->boardSteps, r->boardSteps / r->seconds,
+                r->games, r->lines, r->reward, runs[0].seconds / r->seconds,
+                i + 1 < runCount ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+    int boards = 8192;
+    int steps = 500;
+    int maxThreads = ThreadPoolCoreCount();
+    uint64_t seed = 1;
+    uint32_t maxSteps = 0;
+    TetrisRandomizer randomizer = TETRIS_RANDOMIZER_UNIFORM;
+    const char *jsonPath = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--boards") && i + 1 < argc) boards = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--steps") && i + 1 < argc) steps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) maxThreads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--max-steps") && i + 1 < argc) maxSteps = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--bag")) randomizer = TETRIS_RANDOMIZER_BAG7;
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--boards N] [--steps S] [--threads T] [--seed S] "
+                            "[--max-steps M] [--bag] [--json FILE|-]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads < 1) maxThreads = 1;
+    if (boards < 1) boards = 1;
+    if (steps < 1) steps = 1;
+    
+    // 1, 2, 4, ... and finally the maximum itself
+    BenchRun runs[MAX_RUNS];
+    int runCount = 0;
+    for (int threads = 1; runCount < MAX_RUNS; threads *= 2) {
+        if (threads > maxThreads) threads = maxThreads;
+        if (RunBenchmark(threads, boards, steps, seed, maxSteps, randomizer, &runs[runCount]) != 0) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        runCount++;
+        if (threads == maxThreads) break;
+    }
+    
+    bool jsonToStdout = jsonPath && !strcmp(jsonPath, "-");
+    if (!jsonToStdout) {
+        printf("%-8s %10s %16s %10s %12s %8s\n",
+               "threads", "seconds", "board-steps/sec", "games", "lines/game", "speedup");
+        for (int i = 0; i < runCount; i++) {
+            const BenchRun *r = &runs[i];
+            printf("%-8d %10.3f %16.1f %10lld %12.2f %7.2fx\n",
+                   r->threads, r->seconds, r->boardSteps / r->seconds, r->games,
+                   r->games ? (double)r->lines / r->games : 0.0, runs[0].seconds / r->seconds);
+        }
+    }
+    
+    if (jsonPath) {
+        FILE *out = jsonToStdout ? stdout : fopen(jsonPath, "w");
+        if (!out) {
+            perror(jsonPath);
+            return 1;
+        }
+        WriteJson(out, boards, steps, seed, runs, runCount);
+        if (!jsonToStdout) fclose(out);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Evil Hangman benchmark and dictionary report.
+// For every word length in a dictionary, the minimax bot plays the
+// adversary until only one word is left. Each row shows how many misses
+// the bot needed, which is how hard evil mode is with this dictionary at
+// that length, and how long the adversary took to answer the first guess
+// against the full candidate set.
+//
+// Usage: bench_hangman [--dictionary FILE] [--random N] [--length L]
+//                      [--threads T] [--seed S]
+//
+// --random generates N words (of length L if given, else 4..12) with
+// English letter frequencies instead of reading a file.
+
+#include "hangman_solver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// English letter frequencies, per 1000 letters
+static const int letterWeights[26] = {
+    82, 15, 28, 43, 127, 22, 20, 61, 70, 2, 8, 40, 24,
+    67, 75, 19, 1, 60, 63, 91, 28, 10, 24, 2, 20, 1
+};
+
+static double NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Newline-separated random words; the caller frees the result
+static char *RandomWords(long count, int length, uint64_t seed, size_t *size) {
+    int total = 0;
+    for (int l = 0; l < 26; l++) total += letterWeights[l];
+    
+    GameRng rng;
+    RngSeed(&rng, seed);
+    char *text = malloc((size_t)count * (HANGMAN_MAX_WORD + 1));
+    if (!text) return NULL;
+    
+    char *p = text;
+    for (long w = 0; w < count; w++) {
+        int n = length > 0 ? length : 4 + (int)RngRange(&rng, 9);
+        for (int i = 0; i < n; i++) {
+            int r = (int)RngRange(&rng, (uint32_t)total);
+            int l = 0;
+            while (r >= letterWeights[l]) r -= letterWeights[l++];
+            *p++ = (char)('a' + l);
+        }
+        *p++ = '\n';
+    }
+    *size = (size_t)(p - text);
+    return text;
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    long randomWords = 0;
+    int onlyLength = 0;
+    int threads = 0;
+    uint64_t seed = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--dictionary") && i + 1 < argc) path = argv[++i];
+        else if (!strcmp(argv[i], "--random") && i + 1 < argc) randomWords = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--length") && i + 1 < argc) onlyLength = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "usage: %s [--dictionary FILE] [--random N] [--length L] [--threads T] [--seed S]\n", argv[0]);
+            return 1;
+        }
+    }
+    
+    ThreadPool *pool = ThreadPoolCreate(threads);
+    HangmanDictionary dict;
+    char *text = NULL;
+    double start = NowMs();
+    bool loaded;
+    if (randomWords > 0) {
+        size_t size = 0;
+        text = RandomWords(randomWords, onlyLength, seed, &size);
+        loaded = text && HangmanDictionaryLoadMemory(&dict, text, size, pool);
+    }
+    else if (path) {
+        loaded = HangmanDictionaryLoad(&dict, path, pool);
+    }
+    else {
+        dict = *HangmanGetDictionary();
+        loaded = true;
+    }
+    if (!loaded) {
+        fprintf(stderr, "could not load the dictionary\n");
+        return 1;
+    }
+    
+    printf("words:   %u (indexed in %.1f ms)\n", dict.count, NowMs() - start);
+    printf("threads: %d\n\n", ThreadPoolSize(pool));
+    printf("length  candidates  first guess ms  bot guesses  misses  result\n");
+    
+    int lengths = 0, wins = 0;
+    for (int length = 1; length <= HANGMAN_MAX_WORD; length++) {
+        if (onlyLength > 0 && length != onlyLength) continue;
+        
+        HangmanCandidates set;
+        if (!HangmanCandidatesInit(&set, &dict, length, pool)) continue;
+        uint32_t candidates = set.count;
+        
+        // Adversary's answer to a fixed first letter, against the full set
+        double t0 = NowMs();
+        uint64_t pattern = HangmanCandidatesGuess(&set, 'e');
+        double firstMs = NowMs() - t0;
+        int guesses = 1;
+        int misses = pattern ? 0 : 1;
+        
+        // Bot against adversary until the word is pinned down
+        uint64_t full = (1ull << length) - 1;
+        while (set.revealed != full) {
+            int letter = HangmanCandidatesBestGuess(&set);
+            if (letter < 0) break;
+            if (!HangmanCandidatesGuess(&set, letter)) misses++;
+            guesses++;
+        }
+        
+        bool won = misses < HANGMAN_MAX_MISTAKES;
+        printf("%6d  %10u  %14.3f  %11d  %6d  %s\n", length, candidates, firstMs, guesses, misses,
+               won ? "bot wins" : "evil wins");
+        lengths++;
+        wins += won;
+        HangmanCandidatesFree(&set);
+    }
+    printf("\nbot won %d of %d lengths\n", wins, lengths);
+    
+    if (path || randomWords > 0) HangmanDictionaryFree(&dict);
+    free(text);
+    ThreadPoolDestroy(pool);
+    return 0;
+}
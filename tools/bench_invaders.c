@@ -0,0 +1,316 @@
+// Headless Space Invaders throughput benchmark.
+// Plays seeded games through the raylib-free core on a ThreadPool, with a
+// random or scripted policy, for a fixed number of ticks each; a game that
+// ends is restarted like a player pressing start. Reports ticks and waves
+// cleared per second for 1, 2, 4, ... threads up to the requested
+// maximum, and how a tick's cost splits between input, UpdateBullets,
+// UpdateInvaders and CheckCollisions (timed on every PHASE_SAMPLE-th tick
+// so the clock reads stay out of the throughput figures).
+//
+// Usage: bench_invaders [--games N] [--ticks T] [--threads T] [--seed S]
+//                       [--policy random|scripted] [--rows R] [--cols C]
+//                       [--projectiles P] [--json FILE|-]
+
+#include "invaders_core.h"
+#include "thread_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TICK_RATE 60
+#define PHASE_SAMPLE 8
+#define MAX_RUNS 32
+
+typedef enum {
+    PHASE_INPUT,
+    PHASE_BULLETS,
+    PHASE_INVADERS,
+    PHASE_COLLISIONS,
+    PHASE_COUNT
+} BenchPhase;
+
+static const char *phaseNames[PHASE_COUNT] = { "input", "bullets", "invaders", "collisions" };
+
+typedef enum {
+    POLICY_RANDOM,
+    POLICY_SCRIPTED
+} BenchPolicy;
+
+// Per-worker totals, padded so workers never share a cache line
+typedef struct {
+    long long ticks;
+    long long waves;
+    long long gameOvers;
+    long long samples;
+    uint64_t phaseNs[PHASE_COUNT];
+    char pad[64];
+} WorkerStats;
+
+typedef struct {
+    uint64_t seed;
+    int ticks;
+    BenchPolicy policy;
+    InvadersConfig config;
+    WorkerStats *stats;
+    int failed;
+} BenchJob;
+
+typedef struct {
+    int threads;
+    double seconds;
+    long long ticks;
+    long long waves;
+    long long gameOvers;
+    double phaseNs[PHASE_COUNT];    // mean per sampled tick
+} BenchRun;
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Random held directions and fire, starting whenever not playing
+static unsigned int RandomInput(const Game *game, GameRng *rng, unsigned int *held) {
+    if (game->state != INVADERS_PLAYING) return INVADERS_INPUT_START;
+    uint32_t r = RngNext(rng);
+    if ((r & 31) == 0) *held = (r >> 5) & 7;
+    return *held;
+}
+
+// Step out from under the nearest invader shot coming down, otherwise walk
+// under the nearest column that still has invaders; fire throughout
+static unsigned int ScriptedInput(const Game *game) {
+    if (game->state != INVADERS_PLAYING) return INVADERS_INPUT_START;
+    
+    const Player *player = &game->player;
+    float center = player->x + player->width * 0.5f;
+    const ProjectilePool *pool = &game->projectiles;
+    float threatY = 0.0f, threatX = 0.0f;
+    for (int i = 0; i < pool->count; i++) {
+        if (pool->owner[i] != PROJECTILE_INVADER) continue;
+        if (pool->y[i] < player->y - 160.0f || pool->y[i] > player->y + player->height) continue;
+        if (pool->x[i] + INVADER_SHOT_WIDTH < player->x - 8.0f ||
+            pool->x[i] > player->x + player->width + 8.0f) continue;
+        if (pool->y[i] > threatY) {
+            threatY = pool->y[i];
+            threatX = pool->x[i];
+        }
+    }
+    if (threatY > 0.0f) {
+        bool left = threatX > center;
+        if (player->x <= 0.0f) left = false;
+        if (player->x >= INVADERS_SCREEN_WIDTH - player->width) left = true;
+        return INVADERS_INPUT_FIRE | (left ? INVADERS_INPUT_LEFT : INVADERS_INPUT_RIGHT);
+    }
+    
+    const InvaderSwarm *swarm = &game->swarm;
+    float best = 0.0f, bestDistance = INVADERS_SCREEN_WIDTH * 2.0f;
+    for (int col = 0; col < swarm->cols; col++) {
+        if (swarm->lowest[col] < 0) continue;
+        int i = swarm->lowest[col] * swarm->cols + col;
+        float target = swarm->x[i] + INVADER_WIDTH * 0.5f;
+        float distance = target > center ? target - center : center - target;
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = target;
+        }
+    }
+    
+    unsigned int input = INVADERS_INPUT_FIRE;
+    if (bestDistance > 4.0f) input |= best < center ? INVADERS_INPUT_LEFT : INVADERS_INPUT_RIGHT;
+    return input;
+}
+
+// One tick, split as StepInvadersGame does; sampled ticks time each phase
+static void TimedStep(Game *game, unsigned int input, float dt, bool sample, WorkerStats *stats) {
+    uint64_t t[PHASE_COUNT + 1];
+    if (sample) t[0] = NowNs();
+    if (StepInvadersInput(game, input, dt)) {
+        if (sample) t[1] = NowNs();
+        UpdateBullets(game, dt);
+        if (sample) t[2] = NowNs();
+        UpdateInvaders(game, dt);
+        if (sample) t[3] = NowNs();
+        
+        // A cleared wave refills the swarm inside CheckCollisions
+        int alive = game->swarm.aliveCount;
+        CheckCollisions(game);
+        if (game->swarm.aliveCount > alive) stats->waves++;
+        if (game->state == INVADERS_GAME_OVER) stats->gameOvers++;
+        stats->ticks++;
+        
+        if (sample) {
+            t[4] = NowNs();
+            for (int p = 0; p < PHASE_COUNT; p++) stats->phaseNs[p] += t[p + 1] - t[p];
+            stats->samples++;
+        }
+    }
+}
+
+static void PlayGame(void *arg, int index, int worker) {
+    BenchJob *job = arg;
+    WorkerStats *stats = &job->stats[worker];
+    
+    Game game;
+    if (!InitGameEx(&game, job->seed + (uint64_t)index, job->config)) {
+        job->failed = 1;
+        return;
+    }
+    GameRng rng;
+    RngSeed(&rng, ~(job->seed + (uint64_t)index));
+    unsigned int held = 0;
+    
+    for (int tick = 0; tick < job->ticks; tick++) {
+        unsigned int input = job->policy == POLICY_SCRIPTED ? ScriptedInput(&game) : RandomInput(&game, &rng, &held);
+        TimedStep(&game, input, 1.0f / TICK_RATE, tick % PHASE_SAMPLE == 0, stats);
+    }
+    FreeGame(&game);
+}
+
+static int RunBenchmark(int threads, int games, BenchJob *job, BenchRun *run) {
+    ThreadPool *pool = threads != 1 ? ThreadPoolCreate(threads) : NULL;
+    int workers = pool ? ThreadPoolSize(pool) : 1;
+    job->stats = calloc((size_t)workers, sizeof(WorkerStats));
+    if (!job->stats) return -1;
+    job->failed = 0;
+    
+    uint64_t start = NowNs();
+    ThreadPoolParallelFor(pool, games, PlayGame, job);
+    uint64_t elapsed = NowNs() - start;
+    
+    // Merge per-worker results once everything has finished
+    long long samples = 0;
+    uint64_t phaseNs[PHASE_COUNT] = { 0 };
+    memset(run, 0, sizeof(*run));
+    for (int w = 0; w < workers; w++) {
+        const WorkerStats *s = &job->stats[w];
+        run->ticks += s->ticks;
+        run->waves += s->waves;
+        run->gameOvers += s->gameOvers;
+        samples += s->samples;
+        for (int p = 0; p < PHASE_COUNT; p++) phaseNs[p] += s->phaseNs[p];
+    }
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        run->phaseNs[p] = samples ? (double)phaseNs[p] / samples : 0.0;
+    }
+    run->threads = workers;
+    run->seconds = elapsed / 1e9;
+    
+    free(job->stats);
+    ThreadPoolDestroy(pool);
+    return job->failed ? -1 : 0;
+}
+
+static void WriteJson(FILE *out, int games, const BenchJob *job, const BenchRun *runs, int runCount) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"bench_invaders\",\n");
+    fprintf(out, "  \"games\": %d,\n", games);
+    fprintf(out, "  \"ticks\": %d,\n", job->ticks);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)job->seed);
+    fprintf(out, "  \"policy\": \"%s\",\n", job->policy == POLICY_SCRIPTED ? "scripted" : "random");
+    fprintf(out, "  \"runs\": [\n");
+    for (int i = 0; i < runCount; i++) {
+        const BenchRun *r = &runs[i];
+        fprintf(out, "    {\"threads\": %d, \"seconds\": %.6f, \"ticks\": %lld, \"waves\": %lld, "
+                     "\"game_overs\": %lld, \"ticks_per_sec\": %.1f, \"waves_per_sec\": %.2f, ",
+                r->threads, r->seconds, r->ticks, r->waves, r->gameOvers,
+                r->ticks / r->seconds, r->waves / r->seconds);
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            fprintf(out, "\"%s_ns\": %.1f, ", phaseNames[p], r->phaseNs[p]);
+        }
+        fprintf(out, "\"speedup\": %.3f}%s\n", runs[0].seconds / r->seconds, i + 1 < runCount ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+    int games = 2000;
+    int maxThreads = ThreadPoolCoreCount();
+    BenchJob job = {
+        .seed = 1,
+        .ticks = 60 * TICK_RATE,
+        .policy = POLICY_RANDOM,
+        .config = { INVADER_ROWS, INVADER_COLS, 0 }
+    };
+    const char *jsonPath = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) games = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--ticks") && i + 1 < argc) job.ticks = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) maxThreads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) job.seed = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--policy") && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (!strcmp(name, "scripted")) job.policy = POLICY_SCRIPTED;
+            else if (!strcmp(name, "random")) job.policy = POLICY_RANDOM;
+            else {
+                fprintf(stderr, "unknown policy: %s\n", name);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--rows") && i + 1 < argc) job.config.rows = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--cols") && i + 1 < argc) job.config.cols = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--projectiles") && i + 1 < argc) job.config.projectiles = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--games N] [--ticks T] [--threads T] [--seed S] "
+                            "[--policy random|scripted] [--rows R] [--cols C] [--projectiles P] "
+                            "[--json FILE|-]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads < 1) maxThreads = 1;
+    if (games < 1) games = 1;
+    if (job.ticks < 1) job.ticks = 1;
+    
+    // 1, 2, 4, ... and finally the maximum itself
+    BenchRun runs[MAX_RUNS];
+    int runCount = 0;
+    for (int threads = 1; runCount < MAX_RUNS; threads *= 2) {
+        if (threads > maxThreads) threads = maxThreads;
+        if (RunBenchmark(threads, games, &job, &runs[runCount]) != 0) {
+            fprintf(stderr, "could not create games (%dx%d, %d projectiles)\n",
+                    job.config.rows, job.config.cols, job.config.projectiles);
+            return 1;
+        }
+        runCount++;
+        if (threads == maxThreads) break;
+    }
+    
+    bool jsonToStdout = jsonPath && !strcmp(jsonPath, "-");
+    if (!jsonToStdout) {
+        printf("%-8s %10s %14s %11s %10s %8s\n",
+               "threads", "seconds", "ticks/sec", "waves/sec", "game overs", "speedup");
+        for (int i = 0; i < runCount; i++) {
+            const BenchRun *r = &runs[i];
+            printf("%-8d %10.3f %14.1f %11.2f %10lld %7.2fx\n",
+                   r->threads, r->seconds, r->ticks / r->seconds, r->waves / r->seconds,
+                   r->gameOvers, runs[0].seconds / r->seconds);
+        }
+        
+        // The split barely depends on the thread count; show the last run
+        const BenchRun *last = &runs[runCount - 1];
+        double total = 0.0;
+        for (int p = 0; p < PHASE_COUNT; p++) total += last->phaseNs[p];
+        printf("\nper tick (%d threads, every %dth tick timed):\n", last->threads, PHASE_SAMPLE);
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            printf("  %-12s %9.1f ns %6.1f%%\n", phaseNames[p], last->phaseNs[p],
+                   total > 0.0 ? 100.0 * last->phaseNs[p] / total : 0.0);
+        }
+        printf("  %-12s %9.1f ns\n", "total", total);
+    }
+    
+    if (jsonPath) {
+        FILE *out = jsonToStdout ? stdout : fopen(jsonPath, "w");
+        if (!out) {
+            perror(jsonPath);
+            return 1;
+        }
+        WriteJson(out, games, &job, runs, runCount);
+        if (!jsonToStdout) fclose(out);
+    }
+    
+    return 0;
+}
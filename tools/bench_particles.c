@@ -0,0 +1,137 @@
+// Headless particle pool benchmark.
+// Holds a pool at a steady live count by spawning bursts every tick, the
+// way the games do on line clears and kills, and times ParticlesUpdate at
+// 60 ticks per second of simulated time. Runs at a quarter, half, all and
+// twice the requested live count and reports the mean and worst update,
+// the cost per particle and the share of a 60 FPS frame it takes. Drawing
+// needs a window and is not measured.
+//
+// Usage: bench_particles [--particles N] [--ticks T] [--burst B] [--seed S]
+//                        [--json FILE|-]
+
+#include "particles_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TICK_RATE 60
+#define LIFETIME 1.0f
+#define WARMUP_TICKS (2 * TICK_RATE)
+
+typedef struct {
+    int target;
+    double meanLive;
+    double meanMs;
+    double maxMs;
+    double nsPerParticle;
+    double spawnsPerTick;
+    uint64_t dropped;
+} Run;
+
+// Spawn enough per tick to replace what dies, so the live count settles
+// near target: particles live LIFETIME seconds on average
+static void RunLoad(Run *run, int target, int ticks, int burst, uint64_t seed) {
+    ParticlePool pool;
+    if (!ParticlesInit(&pool, 2 * target, seed)) {
+        fprintf(stderr, "could not allocate %d particles\n", 2 * target);
+        exit(1);
+    }
+    
+    const float dt = 1.0f / TICK_RATE;
+    double perTick = target * dt / LIFETIME;
+    double owed = 0.0;
+    double totalNs = 0.0, totalLive = 0.0;
+    uint64_t maxNs = 0;
+    uint64_t spawned = 0;
+    for (int tick = 0; tick < WARMUP_TICKS + ticks; tick++) {
+        for (owed += perTick; owed >= burst; owed -= burst) {
+            float x = RngFloat(&pool.rng) * 800.0f, y = RngFloat(&pool.rng) * 600.0f;
+            spawned += (uint64_t)ParticlesBurst(&pool, x, y, 30.0f, 30.0f, burst, 260.0f, LIFETIME, 0xFFFFFFFFu);
+        }
+        ParticlesUpdate(&pool, dt);
+        if (tick < WARMUP_TICKS) {
+            spawned = 0;
+            continue;
+        }
+        totalNs += (double)pool.updateNs;
+        totalLive += pool.count;
+        if (pool.updateNs > maxNs) maxNs = pool.updateNs;
+    }
+    
+    run->target = target;
+    run->meanLive = totalLive / ticks;
+    run->meanMs = totalNs / ticks / 1e6;
+    run->maxMs = maxNs / 1e6;
+    run->nsPerParticle = totalLive > 0 ? totalNs / totalLive : 0.0;
+    run->spawnsPerTick = (double)spawned / ticks;
+    run->dropped = pool.dropped;
+    ParticlesFree(&pool);
+}
+
+static void WriteJson(FILE *out, int ticks, int burst, const Run *runs, int runCount) {
+    fprintf(out, "{\n  \"ticks\": %d,\n  \"burst\": %d,\n  \"frame_budget_ms\": %.3f,\n  \"runs\": [\n",
+            ticks, burst, 1000.0 / TICK_RATE);
+    for (int i = 0; i < runCount; i++) {
+        const Run *r = &runs[i];
+        fprintf(out, "    {\"target\": %d, \"mean_live\": %.0f, \"mean_ms\": %.4f, \"max_ms\": %.4f, "
+                     "\"ns_per_particle\": %.3f, \"spawns_per_tick\": %.1f, \"dropped\": %llu}%s\n",
+                r->target, r->meanLive, r->meanMs, r->maxMs, r->nsPerParticle, r->spawnsPerTick,
+                (unsigned long long)r->dropped, i + 1 < runCount ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+    int particles = 100000;
+    int ticks = 600;
+    int burst = 400;
+    uint64_t seed = 1;
+    const char *jsonPath = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--particles") && i + 1 < argc) particles = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--burst") && i + 1 < argc) burst = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--particles N] [--ticks T] [--burst B] [--seed S] [--json FILE|-]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (particles < 4) particles = 4;
+    if (ticks < 1) ticks = 1;
+    if (burst < 1) burst = 1;
+    
+    Run runs[4];
+    const int loads[4] = { particles / 4, particles / 2, particles, 2 * particles };
+    for (int i = 0; i < 4; i++) {
+        RunLoad(&runs[i], loads[i], ticks, burst, seed + (uint64_t)i);
+    }
+    
+    bool jsonToStdout = jsonPath && !strcmp(jsonPath, "-");
+    if (!jsonToStdout) {
+        double budgetMs = 1000.0 / TICK_RATE;
+        printf("%-10s %10s %12s %10s %10s %10s %8s\n",
+               "target", "live", "spawns/tick", "mean ms", "max ms", "ns/part", "budget");
+        for (int i = 0; i < 4; i++) {
+            const Run *r = &runs[i];
+            printf("%-10d %10.0f %12.1f %10.3f %10.3f %10.2f %7.2f%%\n",
+                   r->target, r->meanLive, r->spawnsPerTick, r->meanMs, r->maxMs, r->nsPerParticle,
+                   100.0 * r->meanMs / budgetMs);
+        }
+    }
+    
+    if (jsonPath) {
+        FILE *out = jsonToStdout ? stdout : fopen(jsonPath, "w");
+        if (!out) {
+            perror(jsonPath);
+            return 1;
+        }
+        WriteJson(out, ticks, burst, runs, 4);
+        if (!jsonToStdout) fclose(out);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,214 @@
+// Snapshot and delta benchmark.
+// Plays seeded Tetris and Space Invaders games with random input. Every
+// tick, each game's delta from a mirror copy is encoded and applied to the
+// mirror, the way a server keeps a remote copy in step. Once a simulated
+// second, a snapshot of every game is loaded into a fresh copy and both are
+// checked against the original.
+//
+// Usage: bench_snapshot [--games N] [--ticks T] [--seed S]
+
+#include "invaders_snapshot.h"
+#include "tetris_snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TICK_RATE 60
+
+typedef struct {
+    long long deltaBytes, deltas;
+    long long snapshotBytes, snapshots;
+    int snapshotMax;
+    double encodeMs, applyMs;
+    long mismatches;
+} Stats;
+
+static double NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Random taps and soft drops, restarting after a top out
+static unsigned int RandomTetrisInput(const TetrisGame *game, GameRng *rng) {
+    if (game->gameOver) return TETRIS_INPUT_RESTART;
+    uint32_t r = RngNext(rng);
+    unsigned int input = (r & 0x100) ? TETRIS_INPUT_SOFT_DROP : 0;
+    if ((r & 7) == 0) input |= 1u << ((r >> 3) % 5);
+    return input;
+}
+
+// Random held directions and fire, starting whenever not playing
+static unsigned int RandomInvadersInput(const Game *game, GameRng *rng, unsigned int *held) {
+    if (game->state != INVADERS_PLAYING) return INVADERS_INPUT_START;
+    uint32_t r = RngNext(rng);
+    if ((r & 31) == 0) *held = (r >> 5) & 7;
+    return *held;
+}
+
+static void CountSnapshot(Stats *stats, int bytes) {
+    stats->snapshotBytes += bytes;
+    stats->snapshots++;
+    if (bytes > stats->snapshotMax) stats->snapshotMax = bytes;
+}
+
+static void BenchTetris(int games, int ticks, uint64_t seed, Stats *stats) {
+    TetrisGame *live = malloc(games * sizeof(TetrisGame));
+    TetrisGame *mirror = malloc(games * sizeof(TetrisGame));
+    GameRng *rngs = malloc(games * sizeof(GameRng));
+    uint8_t (*deltas)[TETRIS_SNAPSHOT_MAX] = malloc((size_t)games * TETRIS_SNAPSHOT_MAX);
+    int *sizes = malloc(games * sizeof(int));
+    
+    for (int g = 0; g < games; g++) {
+        InitTetrisGame(&live[g], seed + g, TETRIS_RANDOMIZER_BAG7);
+        mirror[g] = live[g];
+        RngSeed(&rngs[g], ~(seed + g));
+    }
+    
+    for (int t = 0; t < ticks; t++) {
+        for (int g = 0; g < games; g++) {
+            StepTetrisGame(&live[g], RandomTetrisInput(&live[g], &rngs[g]), 1.0f / TICK_RATE);
+        }
+        
+        double t0 = NowMs();
+        for (int g = 0; g < games; g++) {
+            sizes[g] = TetrisDeltaEncode(&mirror[g], &live[g], deltas[g], TETRIS_SNAPSHOT_MAX);
+        }
+        double t1 = NowMs();
+        for (int g = 0; g < games; g++) {
+            if (!TetrisDeltaApply(&mirror[g], deltas[g], sizes[g])) stats->mismatches++;
+            stats->deltaBytes += sizes[g];
+        }
+        stats->encodeMs += t1 - t0;
+        stats->applyMs += NowMs() - t1;
+        stats->deltas += games;
+        
+        if ((t + 1) % TICK_RATE != 0) continue;
+        for (int g = 0; g < games; g++) {
+            uint8_t a[TETRIS_SNAPSHOT_MAX], b[TETRIS_SNAPSHOT_MAX], c[TETRIS_SNAPSHOT_MAX];
+            TetrisGame restored;
+            int size = TetrisSnapshotSave(&live[g], a, sizeof(a));
+            bool same = size > 0 && TetrisSnapshotLoad(&restored, a, size) &&
+                        TetrisSnapshotSave(&restored, b, sizeof(b)) == size &&
+                        TetrisSnapshotSave(&mirror[g], c, sizeof(c)) == size &&
+                        !memcmp(a, b, size) && !memcmp(a, c, size);
+            if (!same) stats->mismatches++;
+            CountSnapshot(stats, size);
+        }
+    }
+    
+    free(live);
+    free(mirror);
+    free(rngs);
+    free(deltas);
+    free(sizes);
+}
+
+static void BenchInvaders(int games, int ticks, uint64_t seed, Stats *stats) {
+    Game *live = calloc(games, sizeof(Game));
+    Game *mirror = calloc(games, sizeof(Game));
+    GameRng *rngs = malloc(games * sizeof(GameRng));
+    unsigned int *held = calloc(games, sizeof(unsigned int));
+    int *sizes = malloc(games * sizeof(int));
+    
+    for (int g = 0; g < games; g++) {
+        InitGame(&live[g], seed + g);
+        InitGame(&mirror[g], seed + g);
+        RngSeed(&rngs[g], ~(seed + g));
+    }
+    int capacity = InvadersSnapshotMaxSize(&live[0]);
+    uint8_t *deltas = malloc((size_t)games * capacity);
+    uint8_t *a = malloc(capacity), *b = malloc(capacity), *c = malloc(capacity);
+    Game restored = { 0 };
+    
+    for (int t = 0; t < ticks; t++) {
+        for (int g = 0; g < games; g++) {
+            StepInvadersGame(&live[g], RandomInvadersInput(&live[g], &rngs[g], &held[g]), 1.0f / TICK_RATE);
+        }
+        
+        double t0 = NowMs();
+        for (int g = 0; g < games; g++) {
+            sizes[g] = InvadersDeltaEncode(&mirror[g], &live[g], deltas + (size_t)g * capacity, capacity);
+        }
+        double t1 = NowMs();
+        for (int g = 0; g < games; g++) {
+            if (!InvadersDeltaApply(&mirror[g], deltas + (size_t)g * capacity, sizes[g])) stats->mismatches++;
+            stats->deltaBytes += sizes[g];
+        }
+        stats->encodeMs += t1 - t0;
+        stats->applyMs += NowMs() - t1;
+        stats->deltas += games;
+        
+        if ((t + 1) % TICK_RATE != 0) continue;
+        for (int g = 0; g < games; g++) {
+            int size = InvadersSnapshotSave(&live[g], a, capacity);
+            bool same = size > 0 && InvadersSnapshotLoad(&restored, a, size) &&
+                        InvadersSnapshotSave(&restored, b, capacity) == size &&
+                        InvadersSnapshotSave(&mirror[g], c, capacity) == size &&
+                        !memcmp(a, b, size) && !memcmp(a, c, size);
+            if (!same) stats->mismatches++;
+            CountSnapshot(stats, size);
+        }
+    }
+    
+    for (int g = 0; g < games; g++) {
+        FreeGame(&live[g]);
+        FreeGame(&mirror[g]);
+    }
+    FreeGame(&restored);
+    free(live);
+    free(mirror);
+    free(rngs);
+    free(held);
+    free(sizes);
+    free(deltas);
+    free(a);
+    free(b);
+    free(c);
+}
+
+static void Report(const char *name, size_t stateBytes, const Stats *stats) {
+    double deltaMs = stats->encodeMs + stats->applyMs;
+    printf("%-8s  %8zu  %8.1f  %6d  %8.2f  %12.0f  %12.0f  %10.1f  %10ld\n", name, stateBytes,
+           stats->snapshots ? (double)stats->snapshotBytes / stats->snapshots : 0.0, stats->snapshotMax,
+           stats->deltas ? (double)stats->deltaBytes / stats->deltas : 0.0,
+           stats->encodeMs > 0 ? stats->deltas / stats->encodeMs * 1e3 : 0.0,
+           stats->applyMs > 0 ? stats->deltas / stats->applyMs * 1e3 : 0.0,
+           deltaMs > 0 ? stats->deltaBytes / deltaMs / 1e3 : 0.0, stats->mismatches);
+}
+
+int main(int argc, char **argv) {
+    int games = 1000;
+    int ticks = 60 * TICK_RATE;
+    uint64_t seed = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) games = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "usage: %s [--games N] [--ticks T] [--seed S]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (games < 1) games = 1;
+    
+    Stats tetris = { 0 }, invaders = { 0 };
+    BenchTetris(games, ticks, seed, &tetris);
+    BenchInvaders(games, ticks, seed, &invaders);
+    
+    // In-memory size of the state a snapshot replaces
+    Game sample;
+    InitGame(&sample, seed);
+    size_t invadersBytes = sizeof(Game) + sample.swarm.capacity * 2 * sizeof(float) +
+                           (sample.swarm.capacity + 63) / 64 * sizeof(uint64_t) +
+                           sample.projectiles.capacity * (4 * sizeof(float) + 1);
+    FreeGame(&sample);
+    
+    printf("games: %d, ticks: %d\n\n", games, ticks);
+    printf("game      struct B  snapshot B  max  delta B/tick  encodes/sec   applies/sec  delta MB/s  mismatches\n");
+    Report("tetris", sizeof(TetrisGame), &tetris);
+    Report("invaders", invadersBytes, &invaders);
+    return tetris.mismatches || invaders.mismatches;
+}
@@ -0,0 +1,240 @@
+// Multithreaded Tetris self-play benchmark.
+// Plays seeded games through the raylib-free core on a pool of worker
+// threads. Every worker owns its TetrisGame, RNG and timing histogram, so
+// nothing is shared while games run. The same workload is repeated for
+// 1, 2, 4, ... threads up to the requested maximum to show scaling.
+//
+// Usage: bench_tetris [--games N] [--threads T] [--seed S]
+//                     [--max-pieces P] [--bag] [--json FILE|-]
+
+#include "tetris_core.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// LockPiece timings are kept in 1 ns buckets up to this bound
+#define LOCK_HIST_BUCKETS 16384
+#define MAX_RUNS 32
+
+typedef struct {
+    // Input
+    long firstGame;
+    long gameCount;
+    uint64_t seed;
+    int maxPieces;
+    TetrisRandomizer randomizer;
+    
+    // Output
+    long long pieces;
+    long long lines;
+    uint32_t lockHist[LOCK_HIST_BUCKETS];
+} BenchWorker;
+
+typedef struct {
+    int threads;
+    double seconds;
+    long long pieces;
+    long long lines;
+    double lockP50;
+    double lockP99;
+} BenchRun;
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// splitmix64, used to derive independent per-game streams from one seed
+static uint64_t NextRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Random placement policy: turn, slide to a random column, hard drop.
+// The game is seeded from the same per-game stream, so results do not
+// depend on how games are split between threads.
+static void PlayGame(BenchWorker *worker, TetrisGame *game, uint64_t *rng) {
+    InitTetrisGame(game, NextRandom(rng), worker->randomizer);
+    
+    for (int piece = 0; piece < worker->maxPieces && !game->gameOver; piece++) {
+        uint64_t choice = NextRandom(rng);
+        
+        int turns = (int)(choice & 3);
+        for (int i = 0; i < turns; i++) {
+            RotatePiece(game, TETRIS_ROTATE_CW);
+        }
+        
+        int targetX = (int)((choice >> 8) % (TETRIS_COLS + 2)) - 2;
+        while (game->pieceX < targetX && !CheckCollision(game, 1, 0)) game->pieceX++;
+        while (game->pieceX > targetX && !CheckCollision(game, -1, 0)) game->pieceX--;
+        while (!CheckCollision(game, 0, 1)) game->pieceY++;
+        
+        uint64_t start = NowNs();
+        LockPiece(game);
+        uint64_t elapsed = NowNs() - start;
+        
+        worker->lockHist[elapsed < LOCK_HIST_BUCKETS ? elapsed : LOCK_HIST_BUCKETS - 1]++;
+        worker->pieces++;
+    }
+    
+    worker->lines += game->linesCleared;
+}
+
+static void *WorkerMain(void *arg) {
+    BenchWorker *worker = arg;
+    TetrisGame game;
+    
+    for (long g = 0; g < worker->gameCount; g++) {
+        uint64_t rng = worker->seed + (uint64_t)(worker->firstGame + g);
+        PlayGame(worker, &game, &rng);
+    }
+    return NULL;
+}
+
+// Percentile from a merged histogram; the last bucket holds everything slower
+static double HistogramPercentile(const uint64_t *hist, uint64_t total, double p) {
+    if (total == 0) return 0.0;
+    uint64_t rank = (uint64_t)(p * (double)(total - 1));
+    uint64_t seen = 0;
+    for (int i = 0; i < LOCK_HIST_BUCKETS; i++) {
+        seen += hist[i];
+        if (seen > rank) return (double)i;
+    }
+    return (double)(LOCK_HIST_BUCKETS - 1);
+}
+
+static int RunBenchmark(int threads, long games, uint64_t seed, int maxPieces,
+                        TetrisRandomizer randomizer, BenchRun *run) {
+    BenchWorker **workers = calloc((size_t)threads, sizeof(*workers));
+    pthread_t *ids = calloc((size_t)threads, sizeof(*ids));
+    if (!workers || !ids) return -1;
+    
+    // Split the games as evenly as possible
+    long next = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t] = calloc(1, sizeof(BenchWorker));
+        if (!workers[t]) return -1;
+        workers[t]->firstGame = next;
+        workers[t]->gameCount = games / threads + (t < games % threads ? 1 : 0);
+        workers[t]->seed = seed;
+        workers[t]->maxPieces = maxPieces;
+        workers[t]->randomizer = randomizer;
+        next += workers[t]->gameCount;
+    }
+    
+    uint64_t start = NowNs();
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&ids[t], NULL, WorkerMain, workers[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    uint64_t elapsed = NowNs() - start;
+    
+    // Merge per-thread results once everything has finished
+    static uint64_t hist[LOCK_HIST_BUCKETS];
+    memset(hist, 0, sizeof(hist));
+    memset(run, 0, sizeof(*run));
+    for (int t = 0; t < threads; t++) {
+        for (int i = 0; i < LOCK_HIST_BUCKETS; i++) hist[i] += workers[t]->lockHist[i];
+        run->pieces += workers[t]->pieces;
+        run->lines += workers[t]->lines;
+        free(workers[t]);
+    }
+    free(workers);
+    free(ids);
+    
+    run->threads = threads;
+    run->seconds = elapsed / 1e9;
+    run->lockP50 = HistogramPercentile(hist, (uint64_t)run->pieces, 0.50);
+    run->lockP99 = HistogramPercentile(hist, (uint64_t)run->pieces, 0.99);
+    return 0;
+}
+
+static void WriteJson(FILE *out, long games, uint64_t seed, int maxPieces, const BenchRun *runs, int runCount) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"bench_tetris\",\n");
+    fprintf(out, "  \"games\": %ld,\n", games);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)seed);
+    fprintf(out, "  \"max_pieces\": %d,\n", maxPieces);
+    fprintf(out, "  \"runs\": [\n");
+    for (int i = 0; i < runCount; i++) {
+        const BenchRun *r = &runs[i];
+        fprintf(out, "    {\"threads\": %d, \"seconds\": %.6f, \"pieces\": %lld, \"lines\": %lld, "
+                     "\"games_per_sec\": %.1f, \"pieces_per_sec\": %.1f, "
+                     "\"lock_ns_p50\": %.0f, \"lock_ns_p99\": %.0f, \"speedup\": %.3f}%s\n",
+                r->threads, r->seconds, r->pieces, r->lines,
+                games / r->seconds, r->pieces / r->seconds,
+                r->lockP50, r->lockP99, runs[0].seconds / r->seconds,
+                i + 1 < runCount ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+    long games = 20000;
+    int maxThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = 1;
+    int maxPieces = 1000;
+    TetrisRandomizer randomizer = TETRIS_RANDOMIZER_UNIFORM;
+    const char *jsonPath = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) games = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) maxThreads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--max-pieces") && i + 1 < argc) maxPieces = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--bag")) randomizer = TETRIS_RANDOMIZER_BAG7;
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--games N] [--threads T] [--seed S] [--max-pieces P] [--bag] [--json FILE|-]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads < 1) maxThreads = 1;
+    if (games < 1) games = 1;
+    
+    // 1, 2, 4, ... and finally the maximum itself
+    BenchRun runs[MAX_RUNS];
+    int runCount = 0;
+    for (int threads = 1; runCount < MAX_RUNS; threads *= 2) {
+        if (threads > maxThreads) threads = maxThreads;
+        if (RunBenchmark(threads, games, seed, maxPieces, randomizer, &runs[runCount]) != 0) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        runCount++;
+        if (threads == maxThreads) break;
+    }
+    
+    bool jsonToStdout = jsonPath && !strcmp(jsonPath, "-");
+    if (!jsonToStdout) {
+        printf("%-8s %10s %12s %14s %10s %10s %8s\n",
+               "threads", "seconds", "games/sec", "pieces/sec", "lock p50", "lock p99", "speedup");
+        for (int i = 0; i < runCount; i++) {
+            const BenchRun *r = &runs[i];
+            printf("%-8d %10.3f %12.1f %14.1f %8.0fns %8.0fns %7.2fx\n",
+                   r->threads, r->seconds, games / r->seconds, r->pieces / r->seconds,
+                   r->lockP50, r->lockP99, runs[0].seconds / r->seconds);
+        }
+    }
+    
+    if (jsonPath) {
+        FILE *out = jsonToStdout ? stdout : fopen(jsonPath, "w");
+        if (!out) {
+            perror(jsonPath);
+            return 1;
+        }
+        WriteJson(out, games, seed, maxPieces, runs, runCount);
+        if (!jsonToStdout) fclose(out);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,367 @@
+// Headless multi-session game server.
+// Hosts Tetris and Space Invaders sessions at a fixed 60 ticks per second,
+// spread across every core, and speaks the protocol in protocol.h over a
+// local Unix socket. Bot sessions, played by the server with random input,
+// load it up without any clients. Once a second, and again on exit, it
+// reports how long ticks took and how much delta traffic they made.
+//
+// Usage: game_server [--socket PATH] [--tetris-bots N] [--invaders-bots N]
+//                    [--capacity N] [--threads T] [--seconds S]
+//
+// --seconds 0 (the default) serves until interrupted.
+
+#include "server.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_CLIENTS 256
+#define CLIENT_IN_SIZE (2 * (PROTOCOL_HEADER_SIZE + PROTOCOL_MAX_PAYLOAD))
+#define CLIENT_MAX_QUEUED (1 << 20)     // a client further behind is dropped
+
+// Tick durations in 10 microsecond buckets, the last one open-ended
+#define HISTOGRAM_BUCKETS 5000
+#define HISTOGRAM_US 10
+
+typedef struct {
+    int fd;                     // -1 for an unused entry
+    uint8_t in[CLIENT_IN_SIZE];
+    int inSize;
+    uint8_t *out;
+    size_t outSize, outSent, outCapacity;
+} Client;
+
+typedef struct {
+    uint32_t counts[HISTOGRAM_BUCKETS];
+    uint64_t total;
+    double maxMs;
+} TickHistogram;
+
+static volatile sig_atomic_t running = 1;
+
+static void Stop(int signal) {
+    (void)signal;
+    running = 0;
+}
+
+static double NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void HistogramAdd(TickHistogram *h, double ms) {
+    int bucket = (int)(ms * 1000.0 / HISTOGRAM_US);
+    if (bucket >= HISTOGRAM_BUCKETS) bucket = HISTOGRAM_BUCKETS - 1;
+    h->counts[bucket]++;
+    h->total++;
+    if (ms > h->maxMs) h->maxMs = ms;
+}
+
+// Upper edge of the bucket holding the given fraction of ticks, in ms;
+// never above the slowest tick, which may sit low in its bucket
+static double HistogramPercentile(const TickHistogram *h, double fraction) {
+    uint64_t target = (uint64_t)(fraction * h->total);
+    uint64_t seen = 0;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen > target) {
+            double edge = (b + 1) * HISTOGRAM_US / 1000.0;
+            return edge < h->maxMs ? edge : h->maxMs;
+        }
+    }
+    return h->maxMs;
+}
+
+static bool Queue(Client *client, const uint8_t *bytes, size_t size) {
+    if (client->outSize + size > client->outCapacity) {
+        size_t capacity = client->outCapacity ? client->outCapacity : 4096;
+        while (capacity < client->outSize + size) capacity *= 2;
+        uint8_t *out = realloc(client->out, capacity);
+        if (!out) return false;
+        client->out = out;
+        client->outCapacity = capacity;
+    }
+    memcpy(client->out + client->outSize, bytes, size);
+    client->outSize += size;
+    return true;
+}
+
+// Write what the socket takes; false once the client is gone
+static bool Flush(Client *client) {
+    while (client->outSent < client->outSize) {
+        ssize_t n = write(client->fd, client->out + client->outSent, client->outSize - client->outSent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) return false;
+        client->outSent += (size_t)n;
+    }
+    if (client->outSent == client->outSize) client->outSent = client->outSize = 0;
+    return client->outSize - client->outSent <= CLIENT_MAX_QUEUED;
+}
+
+static void Disconnect(Server *server, Client *clients, int index) {
+    Client *client = &clients[index];
+    ServerCloseClient(server, index);
+    close(client->fd);
+    free(client->out);
+    memset(client, 0, sizeof(*client));
+    client->fd = -1;
+}
+
+static void HandleMessage(Server *server, Client *client, int index, uint8_t type,
+                          const uint8_t *payload, int size) {
+    if (type == PROTOCOL_CREATE && size >= 9) {
+        uint32_t id = ServerCreateSession(server, (ServerGame)payload[0], ProtocolGetU64(payload + 1), index);
+        uint8_t reply[PROTOCOL_HEADER_SIZE + 5];
+        uint8_t *p = ProtocolPutHeader(reply, PROTOCOL_CREATED, 5);
+        ProtocolPutU32(p, id);
+        p[4] = payload[0];
+        Queue(client, reply, sizeof(reply));
+    }
+    else if (type == PROTOCOL_INPUT && size >= 5) {
+        ServerSetInput(server, ProtocolGetU32(payload), index, payload[4]);
+    }
+    else if (type == PROTOCOL_CLOSE && size >= 4) {
+        ServerCloseSession(server, ProtocolGetU32(payload), index);
+    }
+    else if (type == PROTOCOL_SAVE && size >= 4) {
+        uint32_t id = ProtocolGetU32(payload);
+        uint8_t reply[PROTOCOL_HEADER_SIZE + PROTOCOL_MAX_PAYLOAD];
+        int bytes = ServerSaveSession(server, id, index, reply + PROTOCOL_HEADER_SIZE + 4, PROTOCOL_MAX_PAYLOAD - 4);
+        uint8_t *p = ProtocolPutHeader(reply, PROTOCOL_SNAPSHOT, (uint16_t)(4 + bytes));
+        ProtocolPutU32(p, id);
+        Queue(client, reply, PROTOCOL_HEADER_SIZE + 4 + bytes);
+    }
+    else if (type == PROTOCOL_RESTORE && size >= 1) {
+        uint32_t id = ServerRestoreSession(server, (ServerGame)payload[0], payload + 1, size - 1, index);
+        uint8_t reply[PROTOCOL_HEADER_SIZE + 5];
+        uint8_t *p = ProtocolPutHeader(reply, PROTOCOL_CREATED, 5);
+        ProtocolPutU32(p, id);
+        p[4] = payload[0];
+        Queue(client, reply, sizeof(reply));
+    }
+}
+
+// Read and handle every complete message; false once the client is gone
+static bool Receive(Server *server, Client *client, int index) {
+    for (;;) {
+        ssize_t n = read(client->fd, client->in + client->inSize, CLIENT_IN_SIZE - client->inSize);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        if (n <= 0) return false;
+        client->inSize += (int)n;
+        
+        int used = 0;
+        while (client->inSize - used >= PROTOCOL_HEADER_SIZE) {
+            const uint8_t *message = client->in + used;
+            int size = ProtocolGetU16(message);
+            if (size > PROTOCOL_MAX_PAYLOAD) return false;
+            if (client->inSize - used < PROTOCOL_HEADER_SIZE + size) break;
+            HandleMessage(server, client, index, message[2], message + PROTOCOL_HEADER_SIZE, size);
+            used += PROTOCOL_HEADER_SIZE + size;
+        }
+        memmove(client->in, client->in + used, client->inSize - used);
+        client->inSize -= used;
+    }
+}
+
+static int Listen(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        close(fd);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(fd, 64) < 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// Accept, read and write until the deadline
+static void Service(Server *server, int listener, Client *clients, double deadline) {
+    struct pollfd fds[MAX_CLIENTS + 1];
+    int owners[MAX_CLIENTS + 1];
+    do {
+        int count = 0;
+        if (listener >= 0) {
+            fds[count] = (struct pollfd){ .fd = listener, .events = POLLIN };
+            owners[count++] = -1;
+        }
+        for (int c = 0; c < MAX_CLIENTS; c++) {
+            if (clients[c].fd < 0) continue;
+            short events = POLLIN;
+            if (clients[c].outSize > clients[c].outSent) events |= POLLOUT;
+            fds[count] = (struct pollfd){ .fd = clients[c].fd, .events = events };
+            owners[count++] = c;
+        }
+        
+        // poll() only has millisecond resolution; sleep off the remainder
+        double wait = deadline - NowMs();
+        if (wait >= 1.0) {
+            if (poll(fds, count, (int)wait) <= 0) continue;
+        }
+        else {
+            if (wait > 0) {
+                struct timespec ts = { 0, (long)(wait * 1e6) };
+                nanosleep(&ts, NULL);
+            }
+            if (poll(fds, count, 0) <= 0) break;
+        }
+        
+        for (int i = 0; i < count; i++) {
+            if (!fds[i].revents) continue;
+            if (owners[i] < 0) {
+                int fd;
+                while ((fd = accept(listener, NULL, NULL)) >= 0) {
+                    int c = 0;
+                    while (c < MAX_CLIENTS && clients[c].fd >= 0) c++;
+                    if (c == MAX_CLIENTS) {
+                        close(fd);
+                        continue;
+                    }
+                    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                    clients[c].fd = fd;
+                }
+                continue;
+            }
+            int c = owners[i];
+            bool alive = !(fds[i].revents & (POLLERR | POLLNVAL));
+            if (alive && (fds[i].revents & (POLLIN | POLLHUP))) alive = Receive(server, &clients[c], c);
+            if (alive) alive = Flush(&clients[c]);
+            if (!alive) Disconnect(server, clients, c);
+        }
+    } while (NowMs() < deadline && running);
+}
+
+int main(int argc, char **argv) {
+    const char *path = "/tmp/game_server.sock";
+    int tetrisBots = 0, invadersBots = 0;
+    int capacity = 16384;
+    int threads = 0;
+    double seconds = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--socket") && i + 1 < argc) path = argv[++i];
+        else if (!strcmp(argv[i], "--tetris-bots") && i + 1 < argc) tetrisBots = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--invaders-bots") && i + 1 < argc) invadersBots = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--capacity") && i + 1 < argc) capacity = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--socket PATH] [--tetris-bots N] [--invaders-bots N] "
+                    "[--capacity N] [--threads T] [--seconds S]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (capacity < tetrisBots) capacity = tetrisBots;
+    if (capacity < invadersBots) capacity = invadersBots;
+    
+    signal(SIGINT, Stop);
+    signal(SIGTERM, Stop);
+    signal(SIGPIPE, SIG_IGN);
+    
+    ThreadPool *pool = ThreadPoolCreate(threads);
+    Server server;
+    if (!ServerInit(&server, capacity, pool)) {
+        fprintf(stderr, "could not allocate %d sessions per game\n", capacity);
+        return 1;
+    }
+    for (int i = 0; i < tetrisBots; i++) ServerCreateSession(&server, SERVER_GAME_TETRIS, 1 + i, SERVER_BOT);
+    for (int i = 0; i < invadersBots; i++) ServerCreateSession(&server, SERVER_GAME_INVADERS, 1 + i, SERVER_BOT);
+    
+    int listener = Listen(path);
+    if (listener < 0) fprintf(stderr, "could not listen on %s, running bots only\n", path);
+    static Client clients[MAX_CLIENTS];
+    for (int c = 0; c < MAX_CLIENTS; c++) clients[c].fd = -1;
+    
+    printf("socket:  %s\n", listener >= 0 ? path : "(none)");
+    printf("threads: %d\n", ThreadPoolSize(pool));
+    printf("bots:    %d tetris, %d invaders\n\n", tetrisBots, invadersBots);
+    printf("second  sessions  tick p50 ms  tick p99 ms  tick max ms  late  delta B/session/tick\n");
+    
+    static TickHistogram total, second;
+    double period = 1000.0 / SERVER_TICK_RATE;
+    double start = NowMs();
+    double next = start + period;
+    uint64_t late = 0, secondLate = 0;
+    uint64_t deltaBytes = 0, secondDeltaBytes = 0, secondSessionTicks = 0;
+    int reported = 0;
+    
+    while (running && (seconds <= 0 || NowMs() - start < seconds * 1000.0)) {
+        Service(&server, listener, clients, next);
+        if (!running) break;
+        
+        // Simulate, then queue each owned session's delta to its client
+        double t0 = NowMs();
+        ServerTick(&server);
+        for (int g = 0; g < SERVER_GAME_COUNT; g++) {
+            ServerPool *sessions = &server.pools[g];
+            for (int i = 0; i < sessions->count; i++) {
+                ServerSession *session = &sessions->sessions[sessions->live[i]];
+                secondDeltaBytes += session->deltaSize;
+                if (session->client == SERVER_BOT || session->deltaSize == 0) continue;
+                Queue(&clients[session->client], session->delta, session->deltaSize);
+            }
+            secondSessionTicks += (uint64_t)sessions->count;
+        }
+        double ms = NowMs() - t0;
+        HistogramAdd(&total, ms);
+        HistogramAdd(&second, ms);
+        
+        // A tick that overran its slot is late; skip ahead rather than
+        // bursting to catch up
+        next += period;
+        if (NowMs() > next) {
+            late++;
+            secondLate++;
+            next = NowMs() + period;
+        }
+        
+        int elapsed = (int)((NowMs() - start) / 1000.0);
+        if (elapsed > reported) {
+            reported = elapsed;
+            int sessions = server.pools[0].count + server.pools[1].count;
+            printf("%6d  %8d  %11.2f  %11.2f  %11.2f  %4llu  %20.1f\n", reported, sessions,
+                   HistogramPercentile(&second, 0.5), HistogramPercentile(&second, 0.99), second.maxMs,
+                   (unsigned long long)secondLate,
+                   secondSessionTicks ? (double)secondDeltaBytes / secondSessionTicks : 0.0);
+            fflush(stdout);
+            deltaBytes += secondDeltaBytes;
+            memset(&second, 0, sizeof(second));
+            secondLate = secondDeltaBytes = secondSessionTicks = 0;
+        }
+    }
+    
+    printf("\nticks:       %llu (%llu late)\n", (unsigned long long)total.total, (unsigned long long)late);
+    printf("tick p50:    %.2f ms\n", HistogramPercentile(&total, 0.5));
+    printf("tick p99:    %.2f ms\n", HistogramPercentile(&total, 0.99));
+    printf("tick max:    %.2f ms\n", total.maxMs);
+    printf("delta bytes: %llu\n", (unsigned long long)(deltaBytes + secondDeltaBytes));
+    
+    for (int c = 0; c < MAX_CLIENTS; c++) {
+        if (clients[c].fd >= 0) Disconnect(&server, clients, c);
+    }
+    if (listener >= 0) {
+        close(listener);
+        unlink(path);
+    }
+    ServerFree(&server);
+    ThreadPoolDestroy(pool);
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Headless replay player.
+// Re-simulates recorded Tetris and Invaders sessions as fast as the core
+// allows and checks the score each recording claims against the score the
+// simulation actually reaches.
+//
+// Usage: replay_player FILE...
+// Exit status is 1 if any replay fails to load or does not match.
+
+#include "invaders_core.h"
+#include "replay.h"
+#include "tetris_core.h"
+#include <stdio.h>
+#include <time.h>
+
+typedef struct {
+    uint64_t ticks;
+    int32_t score;
+} ReplayResult;
+
+static ReplayResult RunTetris(ReplayReader *reader) {
+    TetrisGame game;
+    InitTetrisGame(&game, reader->header.seed, (TetrisRandomizer)reader->header.variant);
+    
+    float dt = 1.0f / reader->header.tickRate;
+    ReplayResult result = {0};
+    uint8_t input;
+    while (ReplayReaderNext(reader, &input)) {
+        StepTetrisGame(&game, input, dt);
+        result.ticks++;
+    }
+    result.score = game.score;
+    return result;
+}
+
+static ReplayResult RunInvaders(ReplayReader *reader) {
+    Game game;
+    InitGame(&game, reader->header.seed);
+    
+    float dt = 1.0f / reader->header.tickRate;
+    ReplayResult result = {0};
+    uint8_t input;
+    while (ReplayReaderNext(reader, &input)) {
+        StepInvadersGame(&game, input, dt);
+        result.ticks++;
+    }
+    result.score = game.score;
+    FreeGame(&game);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s FILE...\n", argv[0]);
+        return 1;
+    }
+    
+    int failures = 0;
+    uint64_t totalTicks = 0;
+    double simulatedSeconds = 0.0;
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    for (int i = 1; i < argc; i++) {
+        ReplayReader reader;
+        if (!ReplayReaderOpen(&reader, argv[i]) || reader.header.tickRate == 0) {
+            printf("%s: not a replay\n", argv[i]);
+            ReplayReaderClose(&reader);
+            failures++;
+            continue;
+        }
+        
+        ReplayResult result;
+        const char *name;
+        if (reader.header.game == REPLAY_GAME_TETRIS) {
+            name = "tetris";
+            result = RunTetris(&reader);
+        } else if (reader.header.game == REPLAY_GAME_INVADERS) {
+            name = "invaders";
+            result = RunInvaders(&reader);
+        } else {
+            printf("%s: unknown game %d\n", argv[i], reader.header.game);
+            ReplayReaderClose(&reader);
+            failures++;
+            continue;
+        }
+        
+        // A missing footer means the recording was cut short
+        bool ok = reader.finished && reader.ticks == result.ticks && reader.finalScore == result.score;
+        printf("%s: %s seed=%llu ticks=%llu score=%d claimed=%d %s\n",
+               argv[i], name, (unsigned long long)reader.header.seed,
+               (unsigned long long)result.ticks, result.score, reader.finalScore,
+               ok ? "OK" : "MISMATCH");
+        if (!ok) failures++;
+        
+        totalTicks += result.ticks;
+        simulatedSeconds += (double)result.ticks / reader.header.tickRate;
+        ReplayReaderClose(&reader);
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    
+    printf("replays: %d, failed: %d, ticks: %llu, %.3f s (%.0fx real time)\n",
+           argc - 1, failures, (unsigned long long)totalTicks, seconds,
+           seconds > 0 ? simulatedSeconds / seconds : 0.0);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+// Headless Tetris simulator.
+// Plays games with random inputs through the raylib-free core at a fixed
+// step, so it runs on machines without a display and is not capped by
+// the 60 FPS window loop.
+//
+// Usage: tetris_sim [games] [max_ticks_per_game] [seed]
+
+#include "tetris_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SIM_DT (1.0f / 60.0f)
+
+// Small xorshift generator for input choice, independent from the game
+static unsigned int NextInputBits(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+int main(int argc, char **argv) {
+    long games = (argc > 1) ? atol(argv[1]) : 1000;
+    long maxTicks = (argc > 2) ? atol(argv[2]) : 100000;
+    uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 1;
+    unsigned int inputState = 2463534242u;
+    
+    long long totalTicks = 0;
+    long long totalLines = 0;
+    long long totalScore = 0;
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    TetrisGame game;
+    for (long g = 0; g < games; g++) {
+        InitTetrisGame(&game, seed + (uint64_t)g, TETRIS_RANDOMIZER_UNIFORM);
+        
+        long tick = 0;
+        while (!game.gameOver && tick < maxTicks) {
+            // Keep only a few random bits so pieces still fall most ticks
+            unsigned int input = NextInputBits(&inputState);
+            input &= NextInputBits(&inputState);
+            input &= TETRIS_INPUT_LEFT | TETRIS_INPUT_RIGHT | TETRIS_INPUT_ROTATE | TETRIS_INPUT_ROTATE_CCW |
+                     TETRIS_INPUT_SOFT_DROP | TETRIS_INPUT_HARD_DROP;
+            
+            StepTetrisGame(&game, input, SIM_DT);
+            tick++;
+        }
+        
+        totalTicks += tick;
+        totalLines += game.linesCleared;
+        totalScore += game.score;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    
+    printf("games:      %ld\n", games);
+    printf("ticks:      %lld\n", totalTicks);
+    printf("lines:      %lld\n", totalLines);
+    printf("avg score:  %.1f\n", games > 0 ? (double)totalScore / games : 0.0);
+    printf("elapsed:    %.3f s\n", seconds);
+    printf("games/sec:  %.1f\n", seconds > 0 ? games / seconds : 0.0);
+    printf("ticks/sec:  %.0f\n", seconds > 0 ? totalTicks / seconds : 0.0);
+    
+    return 0;
+}
@@ -0,0 +1,223 @@
+// Rollback versus Tetris over loopback UDP.
+// Runs both peers of a versus match in one process, each with its own
+// socket, rollback session and bot, in real time at 60 ticks per second.
+// Both links add the configured latency, jitter and loss to the packets
+// they send. After the last frame the peers keep exchanging packets until
+// each has the other's input for every frame; then both must hold the
+// same state, which is checked by checksum. Reports how often each peer
+// rolled back, how far, and what re-simulation cost against the frame
+// budget.
+//
+// Usage: versus_loopback [--seconds S] [--latency MS] [--jitter MS]
+//                        [--loss PERCENT] [--seed S] [--port P]
+//                        [--delay TICKS] [--random]
+
+#include "rollback.h"
+#include "tetris_ai.h"
+#include "tetris_versus.h"
+#include "udp_link.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TICK_RATE 60
+#define DRAIN_SECONDS 10
+
+typedef struct {
+    TetrisVersus versus;
+    RollbackSession session;
+    UdpLink link;
+    TetrisBot bot;
+    TetrisBotDriver driver;
+    bool randomInput;
+    GameRng rng;
+    uint8_t input;              // offered until the session takes it
+    bool hasInput;
+} Peer;
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void SleepUntil(uint64_t when) {
+    uint64_t now = NowNs();
+    if (when <= now) return;
+    struct timespec ts = { (time_t)((when - now) / 1000000000ull), (long)((when - now) % 1000000000ull) };
+    nanosleep(&ts, NULL);
+}
+
+static void StepVersus(void *state, const uint8_t inputs[2], void *user) {
+    (void)user;
+    StepTetrisVersus(state, inputs, 1.0f / TICK_RATE);
+}
+
+// A key now and then, soft drop held in stretches
+static uint8_t RandomInput(const TetrisGame *game, GameRng *rng) {
+    if (game->gameOver) return TETRIS_INPUT_RESTART;
+    uint32_t r = RngNext(rng);
+    uint8_t input = (r >> 8 & 3) == 0 ? TETRIS_INPUT_SOFT_DROP : 0;
+    if ((r & 7) == 0) {
+        static const uint8_t keys[] = {
+            TETRIS_INPUT_LEFT, TETRIS_INPUT_RIGHT, TETRIS_INPUT_ROTATE, TETRIS_INPUT_ROTATE_CCW, TETRIS_INPUT_HARD_DROP
+        };
+        input |= keys[(r >> 3) % 5];
+    }
+    return input;
+}
+
+static bool PeerOpen(Peer *peer, int player, int port, int peerPort, uint64_t seed, int latencyMs,
+                     int jitterMs, float loss, int actionDelay, bool randomInput) {
+    memset(peer, 0, sizeof(*peer));
+    InitTetrisVersus(&peer->versus, seed);
+    if (!RollbackInit(&peer->session, &peer->versus, sizeof(peer->versus), player,
+                      TETRIS_INPUT_SOFT_DROP, StepVersus, NULL)) return false;
+    if (!UdpLinkOpen(&peer->link, port, seed + (uint64_t)player + 1)) return false;
+    if (!UdpLinkSetPeer(&peer->link, "127.0.0.1", peerPort)) return false;
+    peer->link.latencyMs = latencyMs;
+    peer->link.jitterMs = jitterMs;
+    peer->link.loss = loss;
+    TetrisBotDriverInit(&peer->driver, actionDelay);
+    peer->randomInput = randomInput;
+    RngSeed(&peer->rng, seed * 31 + (uint64_t)player);
+    return true;
+}
+
+// One tick: take the peer's packets, advance unless at the last frame,
+// then tell the peer about it
+static void PeerTick(Peer *peer, uint32_t lastFrame) {
+    uint8_t packet[UDP_LINK_MAX_PACKET];
+    int size;
+    while ((size = UdpLinkReceive(&peer->link, packet, sizeof(packet))) > 0) {
+        RollbackReadPacket(&peer->session, packet, size);
+    }
+    
+    if (peer->session.frame < lastFrame) {
+        if (!peer->hasInput) {
+            const TetrisGame *game = &peer->versus.games[peer->session.localPlayer];
+            peer->input = peer->randomInput ? RandomInput(game, &peer->rng)
+                                            : (uint8_t)TetrisBotDriverInput(&peer->driver, &peer->bot, game);
+            peer->hasInput = true;
+        }
+        if (RollbackAdvance(&peer->session, peer->input)) peer->hasInput = false;
+    } else {
+        RollbackCorrect(&peer->session);
+    }
+    
+    size = RollbackWritePacket(&peer->session, packet, sizeof(packet));
+    UdpLinkSend(&peer->link, packet, size);
+}
+
+static void PrintStats(int player, const Peer *peer) {
+    const RollbackStats *s = &peer->session.stats;
+    double budgetNs = 1e9 / TICK_RATE;
+    printf("%-6d %7llu %7llu %6llu %9llu %8.1f%% %7.2f %5d %10.1f %10.1f %7.2f%% %6llu %6llu %6llu\n",
+           player + 1,
+           (unsigned long long)s->frames, (unsigned long long)s->stalls, (unsigned long long)s->syncWaits,
+           (unsigned long long)s->rollbacks,
+           s->frames ? 100.0 * s->rollbacks / s->frames : 0.0,
+           s->rollbacks ? (double)s->resimulated / s->rollbacks : 0.0, s->maxDepth,
+           s->rollbacks ? s->resimulateNs / 1e3 / s->rollbacks : 0.0, s->maxResimulateNs / 1e3,
+           100.0 * s->maxResimulateNs / budgetNs,
+           (unsigned long long)peer->link.sent, (unsigned long long)peer->link.dropped,
+           (unsigned long long)peer->link.received);
+}
+
+// Cost of one save or restore, which is a plain copy of the match
+static double CopyNs(const TetrisVersus *versus) {
+    static TetrisVersus copies[2];
+    const int rounds = 100000;
+    uint64_t start = NowNs();
+    for (int i = 0; i < rounds; i++) {
+        memcpy(&copies[i & 1], versus, sizeof(*versus));
+        __asm__ volatile("" ::: "memory");
+    }
+    return (double)(NowNs() - start) / rounds;
+}
+
+int main(int argc, char **argv) {
+    double seconds = 20.0;
+    int latencyMs = 40;
+    int jitterMs = 10;
+    double lossPercent = 5.0;
+    uint64_t seed = 1;
+    int port = 7600;
+    int actionDelay = 3;
+    bool randomInput = false;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--latency") && i + 1 < argc) latencyMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--jitter") && i + 1 < argc) jitterMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--loss") && i + 1 < argc) lossPercent = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--port") && i + 1 < argc) port = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--delay") && i + 1 < argc) actionDelay = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--random")) randomInput = true;
+        else {
+            fprintf(stderr, "usage: %s [--seconds S] [--latency MS] [--jitter MS] [--loss PERCENT] "
+                            "[--seed S] [--port P] [--delay TICKS] [--random]\n", argv[0]);
+            return 1;
+        }
+    }
+    
+    static Peer peers[2];
+    for (int p = 0; p < 2; p++) {
+        if (!PeerOpen(&peers[p], p, port + p, port + 1 - p, seed, latencyMs, jitterMs,
+                      (float)(lossPercent / 100.0), actionDelay, randomInput)) {
+            fprintf(stderr, "could not open UDP port %d\n", port + p);
+            return 1;
+        }
+    }
+    
+    printf("loopback: ports %d and %d, %d ms latency, %d ms jitter, %.1f%% loss each way\n",
+           port, port + 1, latencyMs, jitterMs, lossPercent);
+    printf("state:    %zu bytes, %.0f ns per save or restore\n\n",
+           sizeof(TetrisVersus), CopyNs(&peers[0].versus));
+    
+    // Real time, so latency in milliseconds means what it says
+    uint32_t lastFrame = (uint32_t)(seconds * TICK_RATE);
+    uint64_t period = 1000000000ull / TICK_RATE;
+    uint64_t start = NowNs();
+    long maxTicks = (long)lastFrame + DRAIN_SECONDS * TICK_RATE;
+    bool confirmed = false;
+    for (long tick = 0; tick < maxTicks && !confirmed; tick++) {
+        SleepUntil(start + (uint64_t)tick * period);
+        for (int p = 0; p < 2; p++) PeerTick(&peers[p], lastFrame);
+        
+        confirmed = true;
+        for (int p = 0; p < 2; p++) {
+            const RollbackSession *session = &peers[p].session;
+            if (session->frame < lastFrame || session->remoteFrame < lastFrame) confirmed = false;
+        }
+    }
+    for (int p = 0; p < 2; p++) RollbackCorrect(&peers[p].session);
+    
+    printf("%-6s %7s %7s %6s %9s %9s %7s %5s %10s %10s %8s %6s %6s %6s\n",
+           "peer", "frames", "stalls", "waits", "rollbacks", "of frames", "depth", "max",
+           "resim us", "max us", "budget", "sent", "lost", "recv");
+    for (int p = 0; p < 2; p++) PrintStats(p, &peers[p]);
+    
+    const TetrisVersus *versus = &peers[0].versus;
+    printf("\nmatches: %d, garbage rows sent this match: %d / %d\n",
+           versus->matches, versus->linesSent[0], versus->linesSent[1]);
+    
+    int status = 0;
+    if (!confirmed) {
+        printf("result:  TIMEOUT, inputs still missing after %d s\n", DRAIN_SECONDS);
+        status = 1;
+    } else {
+        uint32_t a = TetrisVersusChecksum(&peers[0].versus);
+        uint32_t b = TetrisVersusChecksum(&peers[1].versus);
+        printf("result:  %s at frame %u (%08x / %08x)\n", a == b ? "in sync" : "DESYNC", lastFrame, a, b);
+        if (a != b) status = 1;
+    }
+    
+    for (int p = 0; p < 2; p++) {
+        UdpLinkClose(&peers[p].link);
+        RollbackFree(&peers[p].session);
+    }
+    return status;
+}